@@ -0,0 +1,166 @@
+// sched_setaffinity, CPU_SET et sched_getcpu ne sont pas exposés en C11 strict
+#define _GNU_SOURCE
+
+#include "affinity.h"
+#include <omp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define MAX_CPUS 1024
+#define MAX_NODES 64
+
+// Topologie lue une fois dans /sys
+static pthread_once_t topology_once = PTHREAD_ONCE_INIT;
+static int cpu_node[MAX_CPUS];
+static int node_count = 1;
+
+// Lit une liste de cœurs au format du noyau ("0-15,32-47")
+static void parse_cpulist(const char *list, int node) {
+    const char *p = list;
+    while (*p) {
+        char *end;
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+        long last = first;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+        }
+        for (long cpu = first; cpu <= last && cpu < MAX_CPUS; cpu++) {
+            if (cpu >= 0) cpu_node[cpu] = node;
+        }
+        p = (*end == ',') ? end + 1 : end;
+        if (*p == '\n') break;
+    }
+}
+
+static void detect_topology(void) {
+    char path[128], list[4096];
+    
+    memset(cpu_node, 0, sizeof(cpu_node));
+    node_count = 0;
+    
+    for (int node = 0; node < MAX_NODES; node++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *f = fopen(path, "r");
+        if (!f) continue;
+        if (fgets(list, sizeof(list), f)) {
+            parse_cpulist(list, node);
+            node_count = node + 1;
+        }
+        fclose(f);
+    }
+    
+    if (node_count == 0) node_count = 1;
+}
+
+int affinity_node_count(void) {
+    pthread_once(&topology_once, detect_topology);
+    return node_count;
+}
+
+int affinity_cpu_node(int cpu) {
+    pthread_once(&topology_once, detect_topology);
+    return (cpu >= 0 && cpu < MAX_CPUS) ? cpu_node[cpu] : 0;
+}
+
+int affinity_page_node(const void *addr) {
+#ifdef SYS_move_pages
+    // move_pages sans nœuds cibles: interroge le nœud de chaque page
+    long page_size = sysconf(_SC_PAGESIZE);
+    void *page = (void *)((unsigned long)addr & ~(unsigned long)(page_size - 1));
+    int status = -1;
+    if (syscall(SYS_move_pages, 0, 1UL, &page, NULL, &status, 0) != 0) return -1;
+    return status >= 0 ? status : -1;
+#else
+    (void)addr;
+    return -1;
+#endif
+}
+
+int affinity_parse(const char *name, AffinityMode *mode) {
+    if (strcmp(name, "none") == 0) *mode = AFFINITY_NONE;
+    else if (strcmp(name, "compact") == 0) *mode = AFFINITY_COMPACT;
+    else if (strcmp(name, "scatter") == 0) *mode = AFFINITY_SCATTER;
+    else return 0;
+    return 1;
+}
+
+int affinity_pin_threads(AffinityMode mode) {
+    if (mode == AFFINITY_NONE) return 0;
+    pthread_once(&topology_once, detect_topology);
+    
+    // Cœurs autorisés pour le processus
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return 0;
+    
+    // Ordre des cœurs: par nœud (compact) ou à tour de rôle sur les nœuds (scatter)
+    static int order[MAX_CPUS];
+    int count = 0;
+    if (mode == AFFINITY_COMPACT) {
+        for (int node = 0; node < node_count; node++) {
+            for (int cpu = 0; cpu < MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &allowed) && cpu_node[cpu] == node) order[count++] = cpu;
+            }
+        }
+    } else {
+        int next[MAX_NODES] = {0};
+        int added = 1;
+        while (added) {
+            added = 0;
+            for (int node = 0; node < node_count; node++) {
+                for (int cpu = next[node]; cpu < MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+                    if (CPU_ISSET(cpu, &allowed) && cpu_node[cpu] == node) {
+                        order[count++] = cpu;
+                        next[node] = cpu + 1;
+                        added = 1;
+                        break;
+                    }
+                    next[node] = cpu + 1;
+                }
+            }
+        }
+    }
+    if (count == 0) return 0;
+    
+    // Chaque thread de l'équipe OpenMP s'épingle lui-même
+    // (libgomp réutilise les mêmes threads pour les régions suivantes)
+    int pinned = 0;
+    #pragma omp parallel reduction(+:pinned)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(order[omp_get_thread_num() % count], &set);
+        if (sched_setaffinity(0, sizeof(set), &set) == 0) pinned++;
+    }
+    
+    return pinned;
+}
+
+void affinity_print_info(void) {
+    pthread_once(&topology_once, detect_topology);
+    
+    printf("=== Topologie NUMA ===\n");
+    printf("  Nœuds            : %d\n", node_count);
+    
+    // Cœur et nœud de chaque thread OpenMP
+    int threads = omp_get_max_threads();
+    int *cpus = (int *)malloc(threads * sizeof(int));
+    if (cpus) {
+        #pragma omp parallel
+        cpus[omp_get_thread_num()] = sched_getcpu();
+        
+        printf("  Threads          :");
+        for (int t = 0; t < threads; t++) {
+            printf(" %d@%d", cpus[t], affinity_cpu_node(cpus[t]));
+        }
+        printf(" (cœur@nœud)\n");
+        free(cpus);
+    }
+    printf("\n");
+}
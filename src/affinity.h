@@ -0,0 +1,59 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+/**
+ * Topologie NUMA et placement des threads OpenMP/MKL
+ * 
+ * Sur une machine multi-sockets, une page mémoire est placée sur le nœud
+ * NUMA du thread qui l'écrit en premier (first-touch). Les images sont donc
+ * initialisées en parallèle par bandes de lignes, avec le même découpage
+ * statique que les moteurs de convolution; épingler les threads garantit que
+ * le thread i traite toujours la même bande depuis le même cœur.
+ * La topologie est lue dans /sys/devices/system/node (sans libnuma).
+ */
+
+/**
+ * Placement des threads
+ */
+typedef enum {
+    AFFINITY_NONE,      // Placement laissé au système
+    AFFINITY_COMPACT,   // Threads consécutifs sur les cœurs d'un même nœud
+    AFFINITY_SCATTER    // Threads répartis à tour de rôle sur les nœuds
+} AffinityMode;
+
+/**
+ * Convertit un nom (none|compact|scatter) en mode de placement
+ * @return: 1 si le nom est reconnu, 0 sinon
+ */
+int affinity_parse(const char *name, AffinityMode *mode);
+
+/**
+ * Épingle chaque thread OpenMP (partagés avec MKL) sur un cœur
+ * À appeler après mkl_init, le nombre de threads étant alors fixé
+ * @return: nombre de threads épinglés (0 pour AFFINITY_NONE ou en cas d'échec)
+ */
+int affinity_pin_threads(AffinityMode mode);
+
+/**
+ * Nombre de nœuds NUMA de la machine (1 si la topologie est inconnue)
+ */
+int affinity_node_count(void);
+
+/**
+ * Nœud NUMA d'un cœur (0 si inconnu)
+ */
+int affinity_cpu_node(int cpu);
+
+/**
+ * Nœud NUMA sur lequel réside la page contenant addr
+ * @return: numéro de nœud, ou -1 si la page n'est pas encore allouée ou si
+ *          l'information est indisponible
+ */
+int affinity_page_node(const void *addr);
+
+/**
+ * Affiche la topologie NUMA détectée
+ */
+void affinity_print_info(void);
+
+#endif // AFFINITY_H
@@ -0,0 +1,673 @@
+// opendir, strdup, clock_gettime ne sont pas exposés en C11 strict
+#define _GNU_SOURCE
+
+#include "batch.h"
+#include "image.h"
+#include "filters.h"
+#include "mkl_ops.h"
+#include "float_io.h"
+#include <dirent.h>
+#include <omp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <time.h>
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+// Extensions lues par stb_image ou float_io
+static int is_batch_input(const char *filename) {
+    static const char *extensions[] = {"png", "jpg", "jpeg", "bmp", "tga", "gif",
+                                       "ppm", "pgm", "pnm"};
+    const char *dot = strrchr(filename, '.');
+    if (!dot) return 0;
+    for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++) {
+        if (strcasecmp(dot + 1, extensions[i]) == 0) return 1;
+    }
+    return is_float_image_file(filename);
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Nom du fichier sans répertoire ni extension: seule partie du chemin
+// reprise dans le nom du résultat
+static const char *path_stem(const char *path, int *length) {
+    const char *slash = strrchr(path, '/');
+    const char *name = slash ? slash + 1 : path;
+    const char *dot = strrchr(name, '.');
+    *length = dot ? (int)(dot - name) : (int)strlen(name);
+    return name;
+}
+
+static int compare_stems(const void *a, const void *b) {
+    int len_a, len_b;
+    const char *stem_a = path_stem(*(char *const *)a, &len_a);
+    const char *stem_b = path_stem(*(char *const *)b, &len_b);
+    int cmp = strncmp(stem_a, stem_b, (size_t)(len_a < len_b ? len_a : len_b));
+    return cmp ? cmp : len_a - len_b;
+}
+
+// Deux entrées de même nom (x.png et x.jpg, a/x.png et b/x.png) écriraient
+// le même résultat: signalées avant tout calcul
+static int has_duplicate_stems(char **paths, int count) {
+    char **sorted = (char **)malloc((size_t)count * sizeof(char *));
+    if (!sorted) return 1;
+    memcpy(sorted, paths, (size_t)count * sizeof(char *));
+    qsort(sorted, (size_t)count, sizeof(char *), compare_stems);
+    int duplicate = 0;
+    for (int i = 1; i < count && !duplicate; i++) {
+        if (compare_stems(&sorted[i - 1], &sorted[i]) == 0) {
+            fprintf(stderr, "Erreur: '%s' et '%s' donneraient le même résultat "
+                            "(même nom sans extension)\n", sorted[i - 1], sorted[i]);
+            duplicate = 1;
+        }
+    }
+    free(sorted);
+    return duplicate;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Ajoute un chemin au tableau, agrandi par doublement
+static int push_path(char ***paths, int *count, int *capacity, const char *path) {
+    if (*count == *capacity) {
+        int grown = *capacity ? *capacity * 2 : 64;
+        char **resized = (char **)realloc(*paths, (size_t)grown * sizeof(char *));
+        if (!resized) return 0;
+        *paths = resized;
+        *capacity = grown;
+    }
+    char *copy = strdup(path);
+    if (!copy) return 0;
+    (*paths)[(*count)++] = copy;
+    return 1;
+}
+
+char **batch_collect_inputs(const char *source, int *count) {
+    char **paths = NULL;
+    int capacity = 0, ok = 1;
+    *count = 0;
+    
+    struct stat st;
+    if (stat(source, &st) != 0) {
+        fprintf(stderr, "Erreur: lot introuvable '%s'\n", source);
+        return NULL;
+    }
+    
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(source);
+        if (!dir) {
+            fprintf(stderr, "Erreur: impossible de lire le répertoire '%s'\n", source);
+            return NULL;
+        }
+        struct dirent *entry;
+        char path[4096];
+        while (ok && (entry = readdir(dir)) != NULL) {
+            if (entry->d_name[0] == '.' || !is_batch_input(entry->d_name)) continue;
+            snprintf(path, sizeof(path), "%s/%s", source, entry->d_name);
+            ok = push_path(&paths, count, &capacity, path);
+        }
+        closedir(dir);
+        // Ordre de readdir non spécifié: tri pour un lot reproductible
+        if (ok && *count > 1) qsort(paths, (size_t)*count, sizeof(char *), compare_paths);
+    } else {
+        FILE *list = fopen(source, "r");
+        if (!list) {
+            fprintf(stderr, "Erreur: impossible de lire la liste '%s'\n", source);
+            return NULL;
+        }
+        char line[4096];
+        while (ok && fgets(line, sizeof(line), list)) {
+            line[strcspn(line, "\r\n")] = '\0';
+            if (line[0] == '\0' || line[0] == '#') continue;
+            ok = push_path(&paths, count, &capacity, line);
+        }
+        fclose(list);
+    }
+    
+    if (!ok) {
+        fprintf(stderr, "Erreur: mémoire insuffisante pour la liste du lot\n");
+        free_batch_inputs(paths, *count);
+        *count = 0;
+        return NULL;
+    }
+    if (*count == 0) {
+        fprintf(stderr, "Erreur: aucune image dans '%s'\n", source);
+        free(paths);
+        return NULL;
+    }
+    if (has_duplicate_stems(paths, *count)) {
+        free_batch_inputs(paths, *count);
+        *count = 0;
+        return NULL;
+    }
+    return paths;
+}
+
+void free_batch_inputs(char **paths, int count) {
+    if (!paths) return;
+    for (int i = 0; i < count; i++) free(paths[i]);
+    free(paths);
+}
+
+// État propre à chaque worker, gardé d'une image à l'autre
+typedef struct {
+    ConvWorkspace *ws;
+    ImageFloat *output;
+} BatchWorker;
+
+// Identifiant de méthode (stream_frame de main.c), -1 si inconnue
+static int batch_method_id(const char *method) {
+    static const char *names[] = {"spatial", "spatial_blas", "separable", "fft"};
+    for (int m = 0; m < 4; m++) {
+        if (strcmp(method, names[m]) == 0) return m;
+    }
+    return -1;
+}
+
+// Nom du résultat: <préfixe>_<nom du fichier sans répertoire ni extension>_<méthode>.<ext>
+static void batch_output_name(char *out, size_t size, const BatchOptions *options,
+                              const char *path, int channels) {
+    int stem;
+    const char *name = path_stem(path, &stem);
+    snprintf(out, size, "%s_%.*s_%s.%s", options->output_prefix, stem, name, options->method,
+             image_format_extension(options->format, channels));
+}
+
+// Étape 1: lecture (stb_image ou float_io), alpha mis de côté
+static ImageFloat *batch_load(const char *path, AlphaChannel *alpha) {
+    return is_float_image_file(path) ? load_image_float(path, NULL)
+                                     : load_image_color(path, NULL, 0, NULL, alpha);
+}
+
+// Étape 2: même préparation qu'image_denoise (bruit ajouté en place puis
+// normalisation), convolution dans output et plage [lo, hi] du résultat
+static int batch_filter(ImageFloat *noisy, const BatchOptions *options, int method_id,
+                        const Kernel *kernel_2d, const float *kernel_1d, ConvWorkspace *ws,
+                        ImageFloat *output, float *lo, float *hi) {
+    add_gaussian_noise(noisy, options->noise_sigma, options->noise_seed);
+    normalize_image(noisy);
+    
+    int ok;
+    switch (method_id) {
+        case 0:
+            ok = convolve_spatial_into(noisy, kernel_2d, output);
+            break;
+        case 1:
+            ok = convolve_spatial_blas_into(noisy, kernel_2d, output, ws);
+            break;
+        case 2:
+            return convolve_separable_into_range(noisy, kernel_1d, options->kernel_size,
+                                                 output, ws, lo, hi);
+        default:
+            ok = convolve_fft_into(noisy, kernel_2d, output, ws);
+            break;
+    }
+    if (ok) image_minmax(output, lo, hi);
+    return ok;
+}
+
+// Étape 3: écriture dans le format demandé
+static int batch_save(const char *path, const BatchOptions *options, const ImageFloat *output,
+                      float lo, float hi, const AlphaChannel *alpha) {
+    char filename[4096];
+    batch_output_name(filename, sizeof(filename), options, path, output->channels);
+    return save_image_as(filename, output, lo, hi, alpha);
+}
+
+// Étape 3 du service: fichier nommé par la requête, complété par l'extension
+// du format selon les canaux du résultat (.pgm/.ppm) si options->format est connu
+static int save_output_file(const char *output_file, const BatchOptions *options,
+                            const ImageFloat *output, float lo, float hi,
+                            const AlphaChannel *alpha) {
+    if (options->format == IMAGE_FORMAT_UNKNOWN) {
+        return save_image_as(output_file, output, lo, hi, alpha);
+    }
+    char filename[4096];
+    snprintf(filename, sizeof(filename), "%s.%s", output_file,
+             image_format_extension(options->format, output->channels));
+    return save_image_as(filename, output, lo, hi, alpha);
+}
+
+// Les trois étapes d'une image; output_file NULL: nom du lot
+// (batch_output_name). *output est réutilisée si ses dimensions conviennent,
+// réallouée sinon; stage_ms reçoit la durée de chaque étape
+static int denoise_one(const char *path, const char *output_file, const BatchOptions *options,
+                       int method_id, const Kernel *kernel_2d, const float *kernel_1d,
+                       ConvWorkspace *ws, ImageFloat **output, double stage_ms[3],
+                       int *width, int *height, int *channels) {
+    double t0 = now_ms();
+    AlphaChannel alpha = {0, NULL};
+    ImageFloat *noisy = batch_load(path, &alpha);
+    if (!noisy) return 0;
+    
+    int w = noisy->width, h = noisy->height, c = noisy->channels;
+    ImageFloat *out = *output;
+    if (!out || out->width != w || out->height != h || out->channels != c) {
+        free_image_float(out);
+        out = *output = create_image_float_uninit(w, h, c);
+    }
+    double t1 = now_ms();
+    
+    float lo = 0.0f, hi = 0.0f;
+    int ok = out && batch_filter(noisy, options, method_id, kernel_2d, kernel_1d, ws, out,
+                                 &lo, &hi);
+    double t2 = now_ms();
+    
+    if (ok) {
+        ok = output_file ? save_output_file(output_file, options, out, lo, hi, &alpha)
+                         : batch_save(path, options, out, lo, hi, &alpha);
+    }
+    double t3 = now_ms();
+    
+    free_image_float(noisy);
+    free_alpha_channel(&alpha);
+    stage_ms[0] = t1 - t0;
+    stage_ms[1] = t2 - t1;
+    stage_ms[2] = t3 - t2;
+    if (width) *width = w;
+    if (height) *height = h;
+    if (channels) *channels = c;
+    return ok;
+}
+
+int batch_method_supported(const char *method) {
+    return batch_method_id(method) >= 0;
+}
+
+int denoise_file(const char *input_file, const char *output_file, const BatchOptions *options,
+                 const Kernel *kernel_2d, const float *kernel_1d, ConvWorkspace *ws,
+                 double stage_ms[3], int *width, int *height, int *channels) {
+    int method_id = batch_method_id(options->method);
+    stage_ms[0] = stage_ms[1] = stage_ms[2] = 0.0;
+    if (method_id < 0) return 0;
+    
+    ImageFloat *output = NULL;
+    int ok = denoise_one(input_file, output_file, options, method_id, kernel_2d, kernel_1d,
+                         ws, &output, stage_ms, width, height, channels);
+    free_image_float(output);
+    return ok;
+}
+
+int denoise_image(ImageFloat *noisy, ImageFloat *output, const BatchOptions *options,
+                  const Kernel *kernel_2d, const float *kernel_1d, ConvWorkspace *ws,
+                  float *min_val, float *max_val) {
+    int method_id = batch_method_id(options->method);
+    if (method_id < 0 || !noisy || !output || output->width != noisy->width ||
+        output->height != noisy->height || output->channels != noisy->channels) {
+        return 0;
+    }
+    return batch_filter(noisy, options, method_id, kernel_2d, kernel_1d, ws, output,
+                        min_val, max_val);
+}
+
+// Une image du lot pour un worker
+static int batch_process(const char *path, const BatchOptions *options, int method_id,
+                         const Kernel *kernel_2d, const float *kernel_1d,
+                         BatchWorker *worker, double stage_ms[3], double *pixels) {
+    int w = 0, h = 0;
+    int ok = denoise_one(path, NULL, options, method_id, kernel_2d, kernel_1d, worker->ws,
+                         &worker->output, stage_ms, &w, &h, NULL);
+    if (!ok) fprintf(stderr, "Erreur: échec du traitement de '%s'\n", path);
+    *pixels = (double)w * h;
+    return ok;
+}
+
+// ============================================================================
+// Pipeline: lecture, calcul et écriture concurrents
+// ============================================================================
+
+// Une image en transit d'une étape à l'autre
+typedef struct {
+    const char *path;
+    ImageFloat *image;      // Entrée lue (bruitée en place par le calcul)
+    ImageFloat *output;     // Résultat, libéré après écriture
+    AlphaChannel alpha;
+    float lo, hi;
+    int ok;
+    double start;           // Début de la lecture (latence de bout en bout)
+} BatchJob;
+
+// File bornée entre deux étapes: push bloque tant qu'elle est pleine, pop
+// tant qu'elle est vide et ouverte; les attentes sont cumulées en ms
+typedef struct {
+    BatchJob **items;
+    int capacity, head, size, closed;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty, not_full;
+} BatchQueue;
+
+// Les verrous sont initialisés même si l'allocation échoue (queue_destroy
+// reste valide)
+static int queue_init(BatchQueue *queue, int capacity) {
+    queue->items = (BatchJob **)malloc((size_t)capacity * sizeof(BatchJob *));
+    queue->capacity = capacity;
+    queue->head = queue->size = queue->closed = 0;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+    return queue->items != NULL;
+}
+
+static void queue_destroy(BatchQueue *queue) {
+    free(queue->items);
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_cond_destroy(&queue->not_full);
+}
+
+static void queue_push(BatchQueue *queue, BatchJob *job, double *wait_ms) {
+    pthread_mutex_lock(&queue->lock);
+    if (queue->size == queue->capacity) {
+        double t0 = now_ms();
+        while (queue->size == queue->capacity) {
+            pthread_cond_wait(&queue->not_full, &queue->lock);
+        }
+        *wait_ms += now_ms() - t0;
+    }
+    queue->items[(queue->head + queue->size) % queue->capacity] = job;
+    queue->size++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// @return: image suivante, ou NULL si la file est fermée et vide
+static BatchJob *queue_pop(BatchQueue *queue, double *wait_ms) {
+    pthread_mutex_lock(&queue->lock);
+    if (queue->size == 0 && !queue->closed) {
+        double t0 = now_ms();
+        while (queue->size == 0 && !queue->closed) {
+            pthread_cond_wait(&queue->not_empty, &queue->lock);
+        }
+        *wait_ms += now_ms() - t0;
+    }
+    BatchJob *job = NULL;
+    if (queue->size > 0) {
+        job = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->size--;
+        pthread_cond_signal(&queue->not_full);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return job;
+}
+
+// Plus d'image à venir: réveille l'étape suivante
+static void queue_close(BatchQueue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = 1;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+typedef struct {
+    BatchJob *jobs;
+    int count;
+    const BatchOptions *options;
+    BatchQueue decoded;     // Lecture -> calcul
+    BatchQueue computed;    // Calcul -> écriture
+    BatchStage stages[3];   // Lecture, calcul, écriture
+    double *latency;        // Par image, -1 si échec
+    double pixels;
+    int processed, failed;
+} BatchPipeline;
+
+// Les threads de lecture et d'écriture sont hors de l'équipe OpenMP du
+// calcul: leurs régions parallèles éventuelles (désentrelacement, encodeur
+// PNG) n'ont qu'un thread, pour ne pas concurrencer le calcul
+static void *pipeline_decoder(void *arg) {
+    BatchPipeline *pipe = (BatchPipeline *)arg;
+    BatchStage *stage = &pipe->stages[0];
+    omp_set_num_threads(1);
+    
+    for (int i = 0; i < pipe->count; i++) {
+        BatchJob *job = &pipe->jobs[i];
+        job->start = now_ms();
+        job->image = batch_load(job->path, &job->alpha);
+        job->ok = job->image != NULL;
+        stage->busy_ms += now_ms() - job->start;
+        queue_push(&pipe->decoded, job, &stage->wait_out_ms);
+    }
+    queue_close(&pipe->decoded);
+    return NULL;
+}
+
+static void *pipeline_encoder(void *arg) {
+    BatchPipeline *pipe = (BatchPipeline *)arg;
+    BatchStage *stage = &pipe->stages[2];
+    omp_set_num_threads(1);
+    
+    BatchJob *job;
+    while ((job = queue_pop(&pipe->computed, &stage->wait_in_ms)) != NULL) {
+        double t0 = now_ms();
+        if (job->ok) {
+            job->ok = batch_save(job->path, pipe->options, job->output, job->lo, job->hi,
+                                 &job->alpha);
+        }
+        double t1 = now_ms();
+        stage->busy_ms += t1 - t0;
+        
+        int index = (int)(job - pipe->jobs);
+        if (job->ok) {
+            pipe->processed++;
+            pipe->pixels += (double)job->output->width * job->output->height;
+            pipe->latency[index] = t1 - job->start;
+        } else {
+            fprintf(stderr, "Erreur: échec du traitement de '%s'\n", job->path);
+            pipe->failed++;
+            pipe->latency[index] = -1.0;
+        }
+        free_image_float(job->output);
+        free_alpha_channel(&job->alpha);
+        job->output = NULL;
+    }
+    return NULL;
+}
+
+// Étape de calcul, dans le thread appelant avec toute l'équipe OpenMP/MKL:
+// l'image N est débruitée pendant que N+1 est lue et N-1 écrite
+static void pipeline_compute(BatchPipeline *pipe, int method_id, const Kernel *kernel_2d,
+                             const float *kernel_1d, ConvWorkspace *ws) {
+    BatchStage *stage = &pipe->stages[1];
+    BatchJob *job;
+    while ((job = queue_pop(&pipe->decoded, &stage->wait_in_ms)) != NULL) {
+        double t0 = now_ms();
+        if (job->ok) {
+            ImageFloat *img = job->image;
+            job->output = create_image_float_uninit(img->width, img->height, img->channels);
+            job->ok = job->output && batch_filter(img, pipe->options, method_id, kernel_2d,
+                                                  kernel_1d, ws, job->output,
+                                                  &job->lo, &job->hi);
+        }
+        free_image_float(job->image);
+        job->image = NULL;
+        stage->busy_ms += now_ms() - t0;
+        queue_push(&pipe->computed, job, &stage->wait_out_ms);
+    }
+    queue_close(&pipe->computed);
+}
+
+// Percentiles (rang le plus proche) sur les images traitées; les échecs
+// (-1) sont en tête après le tri
+static void fill_latency_stats(BatchStats *stats, double *latency, int count, int failed) {
+    qsort(latency, (size_t)count, sizeof(double), compare_doubles);
+    const double *done = latency + failed;
+    int n = count - failed;
+    stats->latency_p50 = n ? done[(n * 50 + 99) / 100 - 1] : 0.0;
+    stats->latency_p90 = n ? done[(n * 90 + 99) / 100 - 1] : 0.0;
+    stats->latency_p99 = n ? done[(n * 99 + 99) / 100 - 1] : 0.0;
+    stats->latency_max = n ? done[n - 1] : 0.0;
+}
+
+static int run_pipeline(char **paths, int count, const BatchOptions *options, int method_id,
+                        const Kernel *kernel_2d, const float *kernel_1d, double *latency,
+                        BatchStats *stats) {
+    BatchPipeline pipe;
+    memset(&pipe, 0, sizeof(pipe));
+    pipe.jobs = (BatchJob *)calloc((size_t)count, sizeof(BatchJob));
+    pipe.count = count;
+    pipe.options = options;
+    pipe.latency = latency;
+    ConvWorkspace *ws = create_conv_workspace();
+    int queues_ok = queue_init(&pipe.decoded, options->queue_depth);
+    queues_ok = queue_init(&pipe.computed, options->queue_depth) && queues_ok;
+    if (!queues_ok || !pipe.jobs || !ws) {
+        fprintf(stderr, "Erreur: allocation du pipeline impossible\n");
+        queue_destroy(&pipe.decoded);
+        queue_destroy(&pipe.computed);
+        free(pipe.jobs);
+        free_conv_workspace(ws);
+        return 0;
+    }
+    for (int i = 0; i < count; i++) pipe.jobs[i].path = paths[i];
+    
+    double start = now_ms();
+    pthread_t decoder, encoder;
+    int decoder_ok = pthread_create(&decoder, NULL, pipeline_decoder, &pipe) == 0;
+    int encoder_ok = decoder_ok && pthread_create(&encoder, NULL, pipeline_encoder, &pipe) == 0;
+    if (decoder_ok && encoder_ok) {
+        pipeline_compute(&pipe, method_id, kernel_2d, kernel_1d, ws);
+    } else {
+        fprintf(stderr, "Erreur: impossible de créer les threads du pipeline\n");
+        // Le lecteur éventuel se termine une fois la file vidée
+        BatchJob *job;
+        double ignored = 0.0;
+        while (decoder_ok && (job = queue_pop(&pipe.decoded, &ignored)) != NULL) {
+            free_image_float(job->image);
+            free_alpha_channel(&job->alpha);
+        }
+        pipe.failed = count;
+    }
+    if (decoder_ok) pthread_join(decoder, NULL);
+    if (encoder_ok) pthread_join(encoder, NULL);
+    double wall = now_ms() - start;
+    
+    if (stats) {
+        int n = pipe.processed;
+        stats->images = pipe.processed;
+        stats->failed = pipe.failed;
+        stats->wall_ms = wall;
+        stats->pixels = pipe.pixels;
+        stats->load_ms = n ? pipe.stages[0].busy_ms / n : 0.0;
+        stats->filter_ms = n ? pipe.stages[1].busy_ms / n : 0.0;
+        stats->save_ms = n ? pipe.stages[2].busy_ms / n : 0.0;
+        memcpy(stats->stages, pipe.stages, sizeof(pipe.stages));
+        if (encoder_ok) fill_latency_stats(stats, latency, count, pipe.failed);
+    }
+    
+    queue_destroy(&pipe.decoded);
+    queue_destroy(&pipe.computed);
+    free(pipe.jobs);
+    free_conv_workspace(ws);
+    return pipe.failed == 0;
+}
+
+// ============================================================================
+// Point d'entrée
+// ============================================================================
+
+int run_batch(char **paths, int count, const BatchOptions *options, BatchStats *stats) {
+    int method_id = batch_method_id(options->method);
+    if (method_id < 0) {
+        fprintf(stderr, "Erreur: méthode '%s' non disponible par lots "
+                        "(spatial|spatial_blas|separable|fft)\n", options->method);
+        return 0;
+    }
+    int workers = options->workers < 1 ? 1 : options->workers;
+    int threads_per_image = options->threads_per_image < 1 ? 1 : options->threads_per_image;
+    if (workers > count) workers = count;
+    
+    // Noyaux créés une fois, partagés en lecture par tous les workers
+    Kernel *kernel_2d = create_gaussian_kernel(options->kernel_size, options->sigma);
+    float *kernel_1d = create_gaussian_kernel_1d(options->kernel_size, options->sigma);
+    double *latency = (double *)malloc((size_t)count * sizeof(double));
+    if (!kernel_2d || !kernel_1d || !latency) {
+        fprintf(stderr, "Erreur: impossible de créer les noyaux\n");
+        if (kernel_2d) free_kernel(kernel_2d);
+        if (kernel_1d) mkl_free(kernel_1d);
+        free(latency);
+        return 0;
+    }
+    
+    set_io_quiet(1);
+    if (stats) memset(stats, 0, sizeof(*stats));
+    
+    if (options->queue_depth > 0) {
+        int ok = run_pipeline(paths, count, options, method_id, kernel_2d, kernel_1d,
+                              latency, stats);
+        free(latency);
+        free_kernel(kernel_2d);
+        mkl_free(kernel_1d);
+        return ok;
+    }
+    
+    // Threads des moteurs imbriqués dans ceux des workers; MKL fixé par
+    // thread (mkl_set_num_threads_local), sans ajustement dynamique
+    if (threads_per_image > 1) omp_set_max_active_levels(2);
+    mkl_set_dynamic(0);
+    
+    int processed = 0, failed = 0;
+    double load_ms = 0.0, filter_ms = 0.0, save_ms = 0.0, pixels = 0.0;
+    double start = now_ms();
+    
+    #pragma omp parallel num_threads(workers) \
+        reduction(+:processed, failed, load_ms, filter_ms, save_ms, pixels)
+    {
+        omp_set_num_threads(threads_per_image);
+        mkl_set_num_threads_local(threads_per_image);
+        BatchWorker worker = {create_conv_workspace(), NULL};
+        
+        #pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < count; i++) {
+            double stage_ms[3] = {0.0, 0.0, 0.0}, image_pixels = 0.0;
+            double t0 = now_ms();
+            int ok = worker.ws && batch_process(paths[i], options, method_id, kernel_2d,
+                                                kernel_1d, &worker, stage_ms, &image_pixels);
+            latency[i] = now_ms() - t0;
+            if (ok) {
+                processed++;
+                load_ms += stage_ms[0];
+                filter_ms += stage_ms[1];
+                save_ms += stage_ms[2];
+                pixels += image_pixels;
+            } else {
+                failed++;
+                latency[i] = -1.0;
+            }
+        }
+        
+        free_image_float(worker.output);
+        free_conv_workspace(worker.ws);
+        mkl_set_num_threads_local(0);
+    }
+    double wall = now_ms() - start;
+    
+    if (stats) {
+        int n = processed;
+        stats->images = processed;
+        stats->failed = failed;
+        stats->wall_ms = wall;
+        stats->pixels = pixels;
+        stats->load_ms = n ? load_ms / n : 0.0;
+        stats->filter_ms = n ? filter_ms / n : 0.0;
+        stats->save_ms = n ? save_ms / n : 0.0;
+        fill_latency_stats(stats, latency, count, failed);
+    }
+    
+    free(latency);
+    free_kernel(kernel_2d);
+    mkl_free(kernel_1d);
+    return failed == 0;
+}
@@ -0,0 +1,132 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "io.h"
+#include "mkl_ops.h"
+
+/**
+ * Traitement par lots: un répertoire ou une liste de fichiers, un seul processus
+ * 
+ * Les noyaux sont créés une fois pour tout le lot; chaque worker garde son
+ * espace de travail (ConvWorkspace: plans FFT et spectre du noyau en cache,
+ * plan intermédiaire du séparable) et son image de sortie d'une image à
+ * l'autre, réalloués seulement quand les dimensions changent.
+ * 
+ * Deux niveaux de parallélisme:
+ * - inter-images: workers threads OpenMP se répartissent les images
+ *   (schedule dynamique, une image à la fois); chacun lit, débruite et
+ *   écrit ses images de bout en bout;
+ * - intra-image: chaque worker dispose de threads_per_image threads
+ *   OpenMP/MKL (parallélisme imbriqué) pour les boucles des moteurs.
+ * Beaucoup de petites images: beaucoup de workers à 1 thread; peu de
+ * grandes images: peu de workers à plusieurs threads.
+ * 
+ * Mode pipeline (queue_depth > 0), pour un lot traité image par image:
+ * un thread de lecture décode l'image N+1 et un thread d'écriture encode
+ * l'image N-1 pendant que toute l'équipe OpenMP/MKL débruite l'image N.
+ * Les étapes communiquent par deux files bornées de queue_depth images
+ * (2: double tampon); chaque étape cumule son temps d'activité et ses
+ * attentes sur les files, ce qui désigne l'étape limitante:
+ * - lecture qui attend une place: le calcul ou l'écriture limite;
+ * - calcul qui attend une image: la lecture limite;
+ * - calcul qui attend une place: l'écriture limite.
+ * 
+ * Chaque résultat est identique à celui d'un appel d'image_denoise sur la
+ * même image avec les mêmes options (bruit, normalisation, format).
+ */
+
+typedef struct {
+    const char *method;         // spatial|spatial_blas|separable|fft
+    int kernel_size;
+    float sigma;
+    float noise_sigma;          // Bruit ajouté avant filtrage (0 = aucun)
+    unsigned int noise_seed;    // Graine du bruit, la même pour chaque image
+    ImageFormat format;         // Format des résultats
+    const char *output_prefix;  // Résultat: <préfixe>_<nom sans extension>_<méthode>.<ext>
+    int workers;                // Images traitées simultanément
+    int threads_per_image;      // Threads OpenMP/MKL de chaque image
+    int queue_depth;            // > 0: mode pipeline, images par file entre étapes
+} BatchOptions;
+
+// Activité d'une étape du pipeline (ms cumulées sur le lot)
+typedef struct {
+    double busy_ms;             // Lecture, calcul ou écriture
+    double wait_in_ms;          // Attente d'une image dans la file d'entrée
+    double wait_out_ms;         // Attente d'une place dans la file de sortie
+} BatchStage;
+
+typedef struct {
+    int images;                 // Images traitées avec succès
+    int failed;                 // Images illisibles ou en échec
+    double wall_ms;             // Durée totale du lot
+    double pixels;              // Pixels traités (toutes images)
+    double load_ms, filter_ms, save_ms;     // Temps moyen par image de chaque étape
+    double latency_p50, latency_p90, latency_p99, latency_max;  // Latence par image (ms)
+    BatchStage stages[3];       // Mode pipeline: lecture, calcul, écriture
+} BatchStats;
+
+/**
+ * Liste les images d'un lot
+ * @param source: répertoire (fichiers image, triés par nom, sans récursion)
+ *                ou fichier texte (un chemin par ligne, lignes vides et
+ *                commentaires '#' ignorés)
+ * @param count: [sortie] nombre de chemins
+ * @return: tableau de chemins (free_batch_inputs), ou NULL en cas d'erreur,
+ *          dont deux images de même nom sans extension (x.png et x.jpg,
+ *          a/x.png et b/x.png), dont les résultats porteraient le même nom
+ */
+char **batch_collect_inputs(const char *source, int *count);
+
+/**
+ * Libère la liste renvoyée par batch_collect_inputs
+ */
+void free_batch_inputs(char **paths, int count);
+
+/**
+ * Indique si la méthode est disponible par lots (spatial|spatial_blas|separable|fft)
+ */
+int batch_method_supported(const char *method);
+
+/**
+ * Débruite un fichier vers un autre comme une image du lot: lecture, bruit
+ * et normalisation, convolution, écriture. Pour le service (server.c), qui
+ * garde noyaux et espace de travail d'une requête à l'autre
+ * @param output_file: fichier écrit, au format de son extension; si
+ *                     options->format est connu, nom sans extension complété
+ *                     par celle du format pour les canaux de l'image (.pgm
+ *                     ou .ppm), comme les résultats d'image_denoise
+ * @param options: méthode, noyau, bruit et format (autres champs ignorés)
+ * @param kernel_2d, kernel_1d: noyaux de options->kernel_size et options->sigma
+ * @param ws: espace de travail réutilisé (plans FFT, spectre du noyau)
+ * @param stage_ms: [sortie] durées de lecture, filtrage et écriture
+ * @param width, height, channels: [sortie] dimensions de l'image (peuvent
+ *                                 être NULL)
+ * @return: 1 si succès, 0 sinon
+ */
+int denoise_file(const char *input_file, const char *output_file, const BatchOptions *options,
+                 const Kernel *kernel_2d, const float *kernel_1d, ConvWorkspace *ws,
+                 double stage_ms[3], int *width, int *height, int *channels);
+
+/**
+ * Étape de calcul de denoise_file sur une image déjà en mémoire (segments
+ * partagés du service): bruit ajouté et normalisation en place dans noisy,
+ * convolution dans output
+ * @param output: image de mêmes dimensions que noisy (par exemple les plans
+ *                du segment de sortie), entièrement réécrite
+ * @param min_val, max_val: [sortie] plage du résultat
+ * @return: 1 si succès, 0 sinon
+ */
+int denoise_image(ImageFloat *noisy, ImageFloat *output, const BatchOptions *options,
+                  const Kernel *kernel_2d, const float *kernel_1d, ConvWorkspace *ws,
+                  float *min_val, float *max_val);
+
+/**
+ * Débruite toutes les images d'un lot
+ * Les messages par fichier sont désactivés (set_io_quiet); seules les
+ * erreurs sont affichées
+ * @param stats: [sortie] débit et latences (peut être NULL)
+ * @return: 1 si toutes les images ont été traitées, 0 sinon
+ */
+int run_batch(char **paths, int count, const BatchOptions *options, BatchStats *stats);
+
+#endif // BATCH_H
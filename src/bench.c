@@ -0,0 +1,1814 @@
+// perf_event_open / syscall ne sont pas exposés en C11 strict
+#define _GNU_SOURCE
+
+#include <omp.h>
+#include <math.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <zlib.h>
+#include "image.h"
+#include "filters.h"
+#include "mkl_ops.h"
+#include "io.h"
+#include "color.h"
+#include "png_stream.h"
+#include "strip.h"
+#include "float_io.h"
+#include "stb_image_write.h"
+#include "pool.h"
+#include "affinity.h"
+#include "server.h"
+
+/**
+ * Micro-benchmarks du projet
+ * Usage: image_bench <benchmark> [options]
+ * Chaque benchmark compare une version de référence et une version optimisée
+ * d'un même traitement et affiche un tableau comparatif.
+ */
+
+// Fonction pour mesurer le temps d'exécution en millisecondes
+static double get_time_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0;
+}
+
+// ============================================================================
+// Compteurs matériels (perf_event_open)
+// ============================================================================
+
+// Ouvre un compteur des défauts de dTLB en lecture pour le processus courant
+// (threads créés ensuite compris); -1 si indisponible (conteneur, paranoid)
+static int open_dtlb_counter(void) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void counter_start(int fd) {
+    if (fd < 0) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+static long long counter_stop(int fd) {
+    long long value = -1;
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &value, sizeof(value)) != (ssize_t)sizeof(value)) return -1;
+    return value;
+}
+
+// Mémoire anonyme couverte par des pages THP (Ko), lue dans /proc/self/smaps_rollup
+static long anon_huge_kb(void) {
+    char line[256];
+    long kb = -1;
+    FILE *f = fopen("/proc/self/smaps_rollup", "r");
+    if (!f) return -1;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "AnonHugePages: %ld kB", &kb) == 1) break;
+    }
+    fclose(f);
+    return kb;
+}
+
+// ============================================================================
+// Benchmark TLB: passe verticale / FFT avec pages de 4 Ko et de 2 Mo
+// ============================================================================
+
+static int bench_tlb(int argc, char *argv[]) {
+    int width = 8192, height = 8192, channels = 1, kernel_size = 7;
+    const char *method = "vertical";
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) channels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) kernel_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) method = argv[++i];
+    }
+    
+    int use_fft = strcmp(method, "fft") == 0;
+    float *kernel_1d = create_gaussian_kernel_1d(kernel_size, 2.0f);
+    Kernel *kernel_2d = create_gaussian_kernel(kernel_size, 2.0f);
+    ConvWorkspace *ws = create_conv_workspace();
+    int fd = open_dtlb_counter();
+    
+    printf("Benchmark TLB: %s, image %dx%d, %d canaux (%.1f Mo par image)\n",
+           use_fft ? "FFT" : "passe verticale", width, height, channels,
+           (double)width * height * channels * sizeof(float) / 1048576.0);
+    if (fd < 0) {
+        printf("Compteur dTLB indisponible (perf_event_open refusé): temps seuls\n");
+    }
+    printf("\n");
+    
+    static const char *labels[] = {"Pages 4 Ko", "Pages 2 Mo (THP)"};
+    double times[2] = {0.0, 0.0};
+    long long misses[2] = {-1, -1};
+    long huge_kb[2] = {-1, -1};
+    
+    for (int mode = 0; mode < 2; mode++) {
+        // Repartir d'un pool vide pour que les plans soient réalloués dans le bon mode
+        pool_trim();
+        pool_set_huge_threshold(mode ? (size_t)8 << 20 : SIZE_MAX);
+        
+        ImageFloat *src = create_image_float(width, height, channels);
+        ImageFloat *dst = create_image_float(width, height, channels);
+        if (!src || !dst || !kernel_1d || !kernel_2d || !ws) {
+            fprintf(stderr, "Erreur: allocation impossible\n");
+            return 1;
+        }
+        
+        size_t total = (size_t)width * height * channels;
+        for (size_t i = 0; i < total; i++) src->data[i] = (float)(i % 251);
+        
+        // Passe de chauffe (plans FFT, pages déjà touchées)
+        if (use_fft) convolve_fft_into(src, kernel_2d, dst, ws);
+        else convolve_separable_1d_into(src, kernel_1d, kernel_size, 0, dst);
+        
+        counter_start(fd);
+        double t0 = get_time_ms();
+        if (use_fft) convolve_fft_into(src, kernel_2d, dst, ws);
+        else convolve_separable_1d_into(src, kernel_1d, kernel_size, 0, dst);
+        double t1 = get_time_ms();
+        misses[mode] = counter_stop(fd);
+        times[mode] = t1 - t0;
+        huge_kb[mode] = anon_huge_kb();
+        
+        free_image_float(src);
+        free_image_float(dst);
+    }
+    
+    printf("╔═══════════════════════╦═════════════╦═════════════════╦══════════════╗\n");
+    printf("║ Allocation            ║ Temps (ms)  ║ Défauts dTLB    ║ THP (Mo)     ║\n");
+    printf("╠═══════════════════════╬═════════════╬═════════════════╬══════════════╣\n");
+    for (int mode = 0; mode < 2; mode++) {
+        char miss_str[32], huge_str[32];
+        if (misses[mode] >= 0) snprintf(miss_str, sizeof(miss_str), "%lld", misses[mode]);
+        else snprintf(miss_str, sizeof(miss_str), "n/d");
+        if (huge_kb[mode] >= 0) snprintf(huge_str, sizeof(huge_str), "%.0f", huge_kb[mode] / 1024.0);
+        else snprintf(huge_str, sizeof(huge_str), "n/d");
+        printf("║ %-21s ║ %10.2f  ║ %15s ║ %12s ║\n", labels[mode], times[mode], miss_str, huge_str);
+    }
+    printf("╚═══════════════════════╩═════════════╩═════════════════╩══════════════╝\n\n");
+    
+    if (fd >= 0) close(fd);
+    free_conv_workspace(ws);
+    free_kernel(kernel_2d);
+    mkl_free(kernel_1d);
+    pool_trim();
+    
+    return 0;
+}
+
+// ============================================================================
+// Benchmark NUMA: bande passante selon le placement des pages
+// ============================================================================
+// Une image est lue en parallèle par bandes de lignes (découpage statique des
+// moteurs). Ses pages ont été placées soit par un seul thread (memset série,
+// ancien comportement de create_image_float), soit par les threads qui la
+// lisent ensuite (first-touch parallèle). Les pages lues depuis un autre nœud
+// que celui du thread lecteur traversent l'interconnexion entre sockets.
+
+// Lecture parallèle de l'image; compte les lignes échantillonnées dont la
+// page réside sur un autre nœud que celui du thread qui la lit
+static double band_read(const ImageFloat *img, long *remote, long *sampled) {
+    double total = 0.0;
+    long remote_rows = 0, sampled_rows = 0;
+    
+    #pragma omp parallel for schedule(static) reduction(+:total,remote_rows,sampled_rows)
+    for (int y = 0; y < img->height; y++) {
+        const float *row = img->data + (size_t)y * img->width;
+        float sum = 0.0f;
+        for (int x = 0; x < img->width; x++) sum += row[x];
+        total += sum;
+        
+        if (remote && y % 64 == 0) {
+            int page_node = affinity_page_node(row);
+            if (page_node >= 0) {
+                sampled_rows++;
+                if (page_node != affinity_cpu_node(sched_getcpu())) remote_rows++;
+            }
+        }
+    }
+    
+    if (remote) {
+        *remote = remote_rows;
+        *sampled = sampled_rows;
+    }
+    return total;
+}
+
+static int bench_numa(int argc, char *argv[]) {
+    int size_mb = 1024, repeat = 5;
+    AffinityMode affinity = AFFINITY_COMPACT;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) size_mb = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            if (!affinity_parse(argv[++i], &affinity)) {
+                fprintf(stderr, "Erreur: placement inconnu '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+    }
+    if (repeat < 1) repeat = 1;
+    
+    int width = 4096;
+    int height = (int)(((size_t)size_mb << 20) / (width * sizeof(float)));
+    double bytes = (double)width * height * sizeof(float);
+    
+    int pinned = affinity_pin_threads(affinity);
+    printf("Benchmark NUMA: lecture parallèle de %d Mo, %d threads (%d épinglés), %d nœuds\n\n",
+           size_mb, omp_get_max_threads(), pinned, affinity_node_count());
+    
+    static const char *labels[] = {"Init. série (1 thread)", "First-touch parallèle"};
+    double bandwidth[2];
+    long remote[2], sampled[2];
+    
+    for (int mode = 0; mode < 2; mode++) {
+        // Pages neuves à chaque mode: le premier accès décide du placement
+        pool_trim();
+        
+        ImageFloat *img;
+        if (mode == 0) {
+            img = create_image_float_uninit(width, height, 1);
+            if (img) memset(img->data, 0, (size_t)bytes);
+        } else {
+            img = create_image_float(width, height, 1);
+        }
+        if (!img) {
+            fprintf(stderr, "Erreur: allocation de %d Mo impossible\n", size_mb);
+            return 1;
+        }
+        
+        double best = 1e30;
+        band_read(img, &remote[mode], &sampled[mode]);
+        for (int r = 0; r < repeat; r++) {
+            double t0 = get_time_ms();
+            volatile double sink = band_read(img, NULL, NULL);
+            (void)sink;
+            double t1 = get_time_ms();
+            if (t1 - t0 < best) best = t1 - t0;
+        }
+        bandwidth[mode] = bytes / (best * 1e-3) / 1e9;
+        
+        free_image_float(img);
+    }
+    pool_trim();
+    
+    printf("╔═══════════════════════════╦═════════════╦═════════════════╗\n");
+    printf("║ Placement des pages       ║ Débit GB/s  ║ Pages distantes ║\n");
+    printf("╠═══════════════════════════╬═════════════╬═════════════════╣\n");
+    for (int mode = 0; mode < 2; mode++) {
+        char remote_str[32];
+        if (sampled[mode] > 0) {
+            snprintf(remote_str, sizeof(remote_str), "%.1f%%", 100.0 * remote[mode] / sampled[mode]);
+        } else {
+            snprintf(remote_str, sizeof(remote_str), "n/d");
+        }
+        printf("║ %-25s ║ %10.2f  ║ %15s ║\n", labels[mode], bandwidth[mode], remote_str);
+    }
+    printf("╚═══════════════════════════╩═════════════╩═════════════════╝\n\n");
+    
+    return 0;
+}
+
+// ============================================================================
+// Benchmark de conversion entrelacé u8 -> planaire float
+// ============================================================================
+
+// Boucle de référence: un octet à la fois, écriture dispersée ch * pixels + i
+static void deinterleave_reference(const unsigned char *data, int w, int h, int c,
+                                   ImageFloat *img) {
+    size_t pixels = (size_t)w * h;
+    for (size_t i = 0; i < pixels; i++) {
+        for (int ch = 0; ch < c; ch++) {
+            img->data[ch * pixels + i] = (float)data[i * c + ch];
+        }
+    }
+}
+
+static int bench_deinterleave(int argc, char *argv[]) {
+    int width = 3840, height = 2160, channels = 3, repeat = 10;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) channels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+    if (width < 1 || height < 1 || channels < 1 || channels > 4) {
+        fprintf(stderr, "Erreur: dimensions ou nombre de canaux invalides\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    size_t in_bytes = (size_t)width * height * channels;
+    unsigned char *data = (unsigned char *)malloc(in_bytes);
+    if (!data) return 1;
+    for (size_t i = 0; i < in_bytes; i++) data[i] = (unsigned char)(i * 2654435761u >> 24);
+    
+    printf("Benchmark désentrelacement: %dx%d, %d canaux, %d threads, %d répétitions\n\n",
+           width, height, channels, omp_get_max_threads(), repeat);
+    
+    static const char *labels[] = {"Boucle scalaire", "SIMD + threads par ligne"};
+    double best[2] = {1e30, 1e30};
+    ImageFloat *out[2] = {NULL, NULL};
+    
+    out[0] = create_image_float(width, height, channels);
+    if (!out[0]) {
+        free(data);
+        return 1;
+    }
+    for (int r = 0; r < repeat; r++) {
+        double t0 = get_time_ms();
+        deinterleave_reference(data, width, height, channels, out[0]);
+        double t1 = get_time_ms();
+        if (t1 - t0 < best[0]) best[0] = t1 - t0;
+    }
+    for (int r = 0; r < repeat; r++) {
+        free_image_float(out[1]);
+        double t0 = get_time_ms();
+        out[1] = interleaved_to_planar(data, width, height, channels);
+        double t1 = get_time_ms();
+        if (!out[1]) break;
+        if (t1 - t0 < best[1]) best[1] = t1 - t0;
+    }
+    
+    int identical = out[1] && memcmp(out[0]->data, out[1]->data, in_bytes * sizeof(float)) == 0;
+    
+    // Octets déplacés: lecture u8 + écriture float
+    double bytes = (double)in_bytes * (1 + sizeof(float));
+    
+    printf("╔═══════════════════════════╦═════════════╦═════════════════╗\n");
+    printf("║ Version                   ║ Temps (ms)  ║ Débit GB/s      ║\n");
+    printf("╠═══════════════════════════╬═════════════╬═════════════════╣\n");
+    for (int mode = 0; mode < 2; mode++) {
+        printf("║ %-25s ║ %10.2f  ║ %15.2f ║\n", labels[mode], best[mode],
+               bytes / (best[mode] * 1e-3) / 1e9);
+    }
+    printf("╚═══════════════════════════╩═════════════╩═════════════════╝\n\n");
+    printf("Accélération: %.2fx, résultats %s\n\n", best[0] / best[1],
+           identical ? "identiques" : "DIFFÉRENTS");
+    
+    free_image_float(out[0]);
+    free_image_float(out[1]);
+    free(data);
+    return identical ? 0 : 1;
+}
+
+// ============================================================================
+// Benchmark de détection d'alpha opaque et aller-retour du canal alpha
+// ============================================================================
+
+// Pixels de test: couleurs pseudo-aléatoires, alpha en dégradé (x + y) & 255
+// ou opaque (255)
+static void fill_alpha_image(unsigned char *data, int w, int h, int c, int opaque) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            size_t i = (size_t)y * w + x;
+            for (int ch = 0; ch < c - 1; ch++) {
+                data[i * c + ch] = (unsigned char)((uint32_t)(i * c + ch) * 2654435761u >> 24);
+            }
+            data[i * c + c - 1] = opaque ? 255 : (unsigned char)((x + y) & 255);
+        }
+    }
+}
+
+static int bench_alpha(int argc, char *argv[]) {
+    int width = 3840, height = 2160, channels = 4, repeat = 10;
+    const char *output_file = NULL, *check_file = NULL;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) channels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) output_file = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) check_file = argv[++i];
+    }
+    if (width < 1 || height < 1 || (channels != 2 && channels != 4)) {
+        fprintf(stderr, "Erreur: dimensions invalides ou image sans alpha (2 ou 4 canaux)\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    size_t pixels = (size_t)width * height;
+    size_t bytes = pixels * channels;
+    unsigned char *data = (unsigned char *)malloc(bytes);
+    if (!data) return 1;
+    
+    // -o: écrire l'image de test (alpha en dégradé) pour image_denoise
+    if (output_file) {
+        fill_alpha_image(data, width, height, channels, 0);
+        int ok = save_image_u8(output_file, data, width, height, channels);
+        free(data);
+        return ok ? 0 : 1;
+    }
+    
+    // -i: vérifier que l'alpha d'une sortie d'image_denoise est celui de l'image de test
+    if (check_file) {
+        fill_alpha_image(data, width, height, channels, 0);
+        int w, h, c;
+        unsigned char *loaded = load_image_u8(check_file, &w, &h, &c);
+        int same = loaded && w == width && h == height && c == channels;
+        for (size_t i = 0; same && i < pixels; i++) {
+            same = loaded[i * c + c - 1] == data[i * channels + channels - 1];
+        }
+        printf("Canal alpha %s\n", same ? "identique" : "DIFFÉRENT");
+        if (loaded) free_image_u8(loaded);
+        free(data);
+        return same ? 0 : 1;
+    }
+    
+    printf("Benchmark alpha: %dx%d, %d canaux, %d threads, %d répétitions\n\n",
+           width, height, channels, omp_get_max_threads(), repeat);
+    
+    // Détection: un seul pixel transparent doit être trouvé, où qu'il soit
+    fill_alpha_image(data, width, height, channels, 1);
+    int correct = alpha_is_opaque(data, pixels, channels);
+    size_t probes[] = {0, pixels / 2, pixels - 1};
+    for (int p = 0; p < 3; p++) {
+        unsigned char *a = data + probes[p] * channels + channels - 1;
+        *a = 254;
+        if (alpha_is_opaque(data, pixels, channels)) correct = 0;
+        *a = 255;
+    }
+    
+    // Image opaque: pire cas, tout l'alpha est parcouru
+    static const char *labels[] = {"Boucle scalaire", "SIMD + threads par bloc"};
+    double best[2] = {1e30, 1e30};
+    volatile int sink = 0;
+    for (int r = 0; r < repeat; r++) {
+        double t0 = get_time_ms();
+        unsigned char all = 255;
+        for (size_t i = 0; i < pixels; i++) all &= data[i * channels + channels - 1];
+        sink += all == 255;
+        double t1 = get_time_ms();
+        if (t1 - t0 < best[0]) best[0] = t1 - t0;
+    }
+    for (int r = 0; r < repeat; r++) {
+        double t0 = get_time_ms();
+        sink += alpha_is_opaque(data, pixels, channels);
+        double t1 = get_time_ms();
+        if (t1 - t0 < best[1]) best[1] = t1 - t0;
+    }
+    
+    // Aller-retour: couleurs et alpha séparés puis réentrelacés sans perte
+    fill_alpha_image(data, width, height, channels, 0);
+    ImageROI full = {0, 0, width, height};
+    ImageFloat *alpha_plane = NULL;
+    ImageFloat *color = interleaved_to_planar_color(data, width, channels, &full, &alpha_plane);
+    unsigned char *back = color ? planar_to_interleaved_alpha(color, 0.0f, 255.0f, alpha_plane)
+                                : NULL;
+    int round_trip = back && memcmp(back, data, bytes) == 0;
+    
+    printf("╔═══════════════════════════╦═════════════╦═════════════════╗\n");
+    printf("║ Version                   ║ Temps (ms)  ║ Débit GB/s      ║\n");
+    printf("╠═══════════════════════════╬═════════════╬═════════════════╣\n");
+    for (int mode = 0; mode < 2; mode++) {
+        printf("║ %-25s ║ %10.2f  ║ %15.2f ║\n", labels[mode], best[mode],
+               (double)bytes / (best[mode] * 1e-3) / 1e9);
+    }
+    printf("╚═══════════════════════════╩═════════════╩═════════════════╝\n\n");
+    printf("Accélération: %.2fx, détection %s, aller-retour %s\n\n", best[0] / best[1],
+           correct ? "correcte" : "ERRONÉE", round_trip ? "exact" : "DIFFÉRENT");
+    
+    free(back);
+    free_image_float(color);
+    free_image_float(alpha_plane);
+    free(data);
+    return correct && round_trip ? 0 : 1;
+}
+
+// ============================================================================
+// Benchmark séparable float32 vs stockage demi-précision
+// ============================================================================
+
+static int bench_f16(int argc, char *argv[]) {
+    int width = 4096, height = 4096, channels = 3, kernel_size = 7, repeat = 5;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) channels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) kernel_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+    if (width < 1 || height < 1 || channels < 1 || kernel_size < 1) {
+        fprintf(stderr, "Erreur: paramètres invalides\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    float *kernel_1d = create_gaussian_kernel_1d(kernel_size, kernel_size / 3.0f);
+    ImageFloat *input = create_image_float_uninit(width, height, channels);
+    ImageFloat *output = create_image_float_uninit(width, height, channels);
+    ConvWorkspace *ws = create_conv_workspace();
+    if (!kernel_1d || !input || !output || !ws) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    
+    // Valeurs 8 bits bruitées, comme après chargement
+    size_t total = (size_t)width * height * channels;
+    for (size_t i = 0; i < total; i++) input->data[i] = (float)(((uint32_t)i * 2654435761u) >> 24);
+    
+    ImageHalf *input_half = image_to_half(input);
+    ImageHalf *output_half = create_image_half(width, height, channels);
+    if (!input_half || !output_half) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    
+    printf("Benchmark FP16: séparable %dx%d, %d canaux, noyau %d, %d threads\n\n",
+           width, height, channels, kernel_size, omp_get_max_threads());
+    
+    static const char *labels[] = {"Plans float32", "Plans binary16 (F16C)"};
+    double best[2] = {1e30, 1e30};
+    
+    for (int r = 0; r <= repeat; r++) {
+        double t0 = get_time_ms();
+        convolve_separable_into(input, kernel_1d, kernel_size, output, ws);
+        double t1 = get_time_ms();
+        if (r > 0 && t1 - t0 < best[0]) best[0] = t1 - t0;
+    }
+    for (int r = 0; r <= repeat; r++) {
+        double t0 = get_time_ms();
+        convolve_separable_half_into(input_half, kernel_1d, kernel_size, output_half, ws);
+        double t1 = get_time_ms();
+        if (r > 0 && t1 - t0 < best[1]) best[1] = t1 - t0;
+    }
+    
+    ImageFloat *result_half = half_to_image(output_half);
+    double psnr = result_half ? image_psnr(result_half, output, 255.0f) : -1.0;
+    
+    printf("╔═══════════════════════════╦═════════════╦═════════════════╗\n");
+    printf("║ Stockage                  ║ Temps (ms)  ║ Mpixels/s       ║\n");
+    printf("╠═══════════════════════════╬═════════════╬═════════════════╣\n");
+    for (int mode = 0; mode < 2; mode++) {
+        printf("║ %-25s ║ %10.2f  ║ %15.1f ║\n", labels[mode], best[mode],
+               (double)total / (best[mode] * 1e-3) / 1e6);
+    }
+    printf("╚═══════════════════════════╩═════════════╩═════════════════╝\n\n");
+    printf("Accélération: %.2fx, PSNR vs float32: %.1f dB\n\n", best[0] / best[1], psnr);
+    
+    free_image_float(result_half);
+    free_image_half(input_half);
+    free_image_half(output_half);
+    free_conv_workspace(ws);
+    free_image_float(input);
+    free_image_float(output);
+    mkl_free(kernel_1d);
+    return 0;
+}
+
+// ============================================================================
+// Benchmark séparable RGB vs luminance + chrominance à mi-résolution
+// ============================================================================
+
+static int bench_chroma(int argc, char *argv[]) {
+    int width = 4096, height = 4096, kernel_size = 7, repeat = 5;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) kernel_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+    if (width < 1 || height < 1 || kernel_size < 1) {
+        fprintf(stderr, "Erreur: paramètres invalides\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    float sigma = kernel_size / 3.0f;
+    float *kernel_1d = create_gaussian_kernel_1d(kernel_size, sigma);
+    ImageFloat *input = create_test_image(width, height);
+    ImageFloat *output = create_image_float_uninit(width, height, 3);
+    ConvWorkspace *ws = create_conv_workspace();
+    if (!kernel_1d || !input || !output || !ws) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    add_gaussian_noise(input, 20.0f, 42);
+    
+    printf("Benchmark luma/chroma: %dx%d RGB, noyau %d (chroma %d), %d threads\n\n",
+           width, height, kernel_size, chroma_kernel_size(kernel_size), omp_get_max_threads());
+    
+    static const char *labels[] = {"Separable RGB", "Y + CbCr 4:2:0"};
+    double best[2] = {1e30, 1e30};
+    ImageFloat *result = NULL;
+    
+    for (int r = 0; r <= repeat; r++) {
+        double t0 = get_time_ms();
+        convolve_separable_into(input, kernel_1d, kernel_size, output, ws);
+        double t1 = get_time_ms();
+        if (r > 0 && t1 - t0 < best[0]) best[0] = t1 - t0;
+    }
+    for (int r = 0; r <= repeat; r++) {
+        free_image_float(result);
+        double t0 = get_time_ms();
+        result = denoise_luma_chroma(input, kernel_size, sigma);
+        double t1 = get_time_ms();
+        if (!result) break;
+        if (r > 0 && t1 - t0 < best[1]) best[1] = t1 - t0;
+    }
+    
+    double psnr = result ? image_psnr(result, output, 255.0f) : -1.0;
+    double pixels = (double)width * height;
+    
+    printf("╔═══════════════════════════╦═════════════╦═════════════════╗\n");
+    printf("║ Version                   ║ Temps (ms)  ║ Mpixels/s       ║\n");
+    printf("╠═══════════════════════════╬═════════════╬═════════════════╣\n");
+    for (int mode = 0; mode < 2; mode++) {
+        printf("║ %-25s ║ %10.2f  ║ %15.1f ║\n", labels[mode], best[mode],
+               pixels / (best[mode] * 1e-3) / 1e6);
+    }
+    printf("╚═══════════════════════════╩═════════════╩═════════════════╝\n\n");
+    printf("Accélération: %.2fx, PSNR vs séparable RGB: %.1f dB\n\n", best[0] / best[1], psnr);
+    
+    free_image_float(result);
+    free_conv_workspace(ws);
+    free_image_float(input);
+    free_image_float(output);
+    mkl_free(kernel_1d);
+    return result ? 0 : 1;
+}
+
+// ============================================================================
+// Benchmark du débruitage par bandes (PNG -> PNG)
+// ============================================================================
+
+// Image de test écrite ligne à ligne: dégradés + bruit pseudo-aléatoire
+static int write_strip_test_png(const char *filename, int width, int height, int channels) {
+    PngWriter *writer = png_writer_open(filename, width, height, channels, 1);
+    unsigned char *row = (unsigned char *)malloc((size_t)width * channels);
+    int ok = writer && row;
+    for (int y = 0; ok && y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            for (int ch = 0; ch < channels; ch++) {
+                uint32_t noise = ((uint32_t)(y * width + x) * 2654435761u + ch) >> 27;
+                int v = ch == 3 ? (x + y) & 255 : ((x + y * (ch + 1)) & 255) / 2 + (int)noise * 4;
+                row[(size_t)x * channels + ch] = (unsigned char)(v > 255 ? 255 : v);
+            }
+        }
+        ok = png_writer_write_row(writer, row);
+    }
+    free(row);
+    if (writer && !png_writer_close(writer)) ok = 0;
+    return ok;
+}
+
+// Chemin de référence: image entière décodée par stb_image, convolution
+// séparable, arrondi; renvoie l'écart max avec la sortie par bandes
+static int strip_reference_error(const char *input_file, const char *strip_file,
+                                 const float *kernel_1d, int kernel_size, double *time_ms) {
+    int w, h, c, sw, sh, sc;
+    double t0 = get_time_ms();
+    unsigned char *data = load_image_u8(input_file, &w, &h, &c);
+    if (!data) return -1;
+    ImageROI full = {0, 0, w, h};
+    ImageFloat *alpha = NULL;
+    ImageFloat *img = c == 2 || c == 4 ? interleaved_to_planar_color(data, w, c, &full, &alpha)
+                                       : interleaved_to_planar(data, w, h, c);
+    free_image_u8(data);
+    ImageFloat *result = img ? convolve_separable(img, kernel_1d, kernel_size) : NULL;
+    unsigned char *ref = NULL;
+    if (result) {
+        ref = alpha ? planar_to_interleaved_alpha(result, 0.0f, 255.0f, alpha)
+                    : planar_to_interleaved(result);
+    }
+    *time_ms = get_time_ms() - t0;
+    free_image_float(img);
+    free_image_float(alpha);
+    free_image_float(result);
+    
+    unsigned char *out = ref ? load_image_u8(strip_file, &sw, &sh, &sc) : NULL;
+    int max_error = -1;
+    if (out && sw == w && sh == h && sc == c) {
+        max_error = 0;
+        for (size_t i = 0; i < (size_t)w * h * c; i++) {
+            int error = abs((int)out[i] - (int)ref[i]);
+            if (error > max_error) max_error = error;
+        }
+    }
+    if (out) free_image_u8(out);
+    free(ref);
+    return max_error;
+}
+
+static int bench_strip(int argc, char *argv[]) {
+    int width = 4096, height = 30000, channels = 3, kernel_size = 7, strip_rows = 64;
+    const char *input_file = NULL;
+    int verify = -1;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) channels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) kernel_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) strip_rows = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) input_file = argv[++i];
+        else if (strcmp(argv[i], "-v") == 0) verify = 1;
+    }
+    if (width < 1 || height < 1 || channels < 1 || channels > 4 || kernel_size < 1 ||
+        strip_rows < 1) {
+        fprintf(stderr, "Erreur: paramètres invalides\n");
+        return 1;
+    }
+    
+    const char *output_file = "bench_strip_output.png";
+    int own_input = input_file == NULL;
+    if (own_input) {
+        input_file = "bench_strip_input.png";
+        printf("Écriture de l'image de test %dx%d (%d canaux)...\n", width, height, channels);
+        if (!write_strip_test_png(input_file, width, height, channels)) {
+            fprintf(stderr, "Erreur: impossible d'écrire l'image de test\n");
+            return 1;
+        }
+    }
+    
+    float *kernel_1d = create_gaussian_kernel_1d(kernel_size, kernel_size / 3.0f);
+    if (!kernel_1d) return 1;
+    
+    StripStats stats;
+    double t0 = get_time_ms();
+    int ok = denoise_png_strips(input_file, output_file, kernel_1d, kernel_size, strip_rows, -1,
+                                &stats);
+    double t1 = get_time_ms();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    
+    if (!ok) {
+        mkl_free(kernel_1d);
+        return 1;
+    }
+    
+    double pixels = (double)stats.width * stats.height;
+    printf("Benchmark bandes: %dx%d, %d canaux, noyau %d, bandes de %d lignes, %d threads\n\n",
+           stats.width, stats.height, stats.channels, kernel_size, strip_rows,
+           omp_get_max_threads());
+    
+    // Vérification par défaut jusqu'à 32 Mpixels (l'image entière est chargée)
+    if (verify < 0) verify = pixels <= 32e6;
+    double ref_ms = 0.0;
+    int max_error = verify ? strip_reference_error(input_file, output_file, kernel_1d,
+                                                   kernel_size, &ref_ms) : 0;
+    
+    printf("╔═══════════════════════════╦═════════════╦═════════════════╗\n");
+    printf("║ Version                   ║ Temps (ms)  ║ Mpixels/s       ║\n");
+    printf("╠═══════════════════════════╬═════════════╬═════════════════╣\n");
+    printf("║ %-25s ║ %10.2f  ║ %15.1f ║\n", "Par bandes (PNG->PNG)", t1 - t0,
+           pixels / ((t1 - t0) * 1e3));
+    if (verify) {
+        printf("║ %-25s ║ %10.2f  ║ %15.1f ║\n", "Image entiere (sans PNG)", ref_ms,
+               pixels / (ref_ms * 1e3));
+    }
+    printf("╚═══════════════════════════╩═════════════╩═════════════════╝\n\n");
+    printf("Mémoire de travail: %.1f Mo (image u8: %.1f Mo, float planaire: %.1f Mo)\n",
+           stats.work_bytes / 1048576.0, pixels * stats.channels / 1048576.0,
+           pixels * stats.channels * sizeof(float) / 1048576.0);
+    printf("Pic RSS du bench (bandes seules): %.1f Mo\n", usage.ru_maxrss / 1024.0);
+    if (verify) printf("Écart max vs image entière: %d LSB\n", max_error);
+    printf("\n");
+    
+    remove(output_file);
+    if (own_input) remove(input_file);
+    mkl_free(kernel_1d);
+    return verify && max_error != 0 ? 1 : 0;
+}
+
+// ============================================================================
+// Benchmark des entrées/sorties flottantes (PNG vs PFM vs planaire projeté)
+// ============================================================================
+
+// Parcourt tous les pixels (les pages d'une image projetée sont lues ici)
+static double touch_pixels(const ImageFloat *img) {
+    size_t total = (size_t)img->width * img->height * img->channels;
+    double sum = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (size_t i = 0; i < total; i++) sum += img->data[i];
+    return sum;
+}
+
+static int same_pixels(const ImageFloat *a, const ImageFloat *b) {
+    return a && b && a->width == b->width && a->height == b->height &&
+           a->channels == b->channels &&
+           memcmp(a->data, b->data,
+                  (size_t)a->width * a->height * a->channels * sizeof(float)) == 0;
+}
+
+static int bench_floatio(int argc, char *argv[]) {
+    int width = 4096, height = 4096, channels = 3, repeat = 5;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) channels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+    if (width < 1 || height < 1 || (channels != 1 && channels != 3)) {
+        fprintf(stderr, "Erreur: paramètres invalides (PFM: -c 1 ou 3)\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    // Valeurs non entières: seul un format flottant les conserve exactement
+    ImageFloat *img = create_image_float_uninit(width, height, channels);
+    if (!img) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    size_t total = (size_t)width * height * channels;
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < total; i++) {
+        img->data[i] = (float)((uint32_t)(i * 2654435761u) >> 8) * (255.0f / 16777216.0f);
+    }
+    
+    static const char *files[] = {"bench_floatio.png", "bench_floatio.pfm",
+                                  "bench_floatio.planar"};
+    static const char *labels[] = {"PNG (stb, u8)", "PFM (mmap + conversion)",
+                                   "Planaire (mmap, sans copie)"};
+    double save_ms[3], load_ms[3] = {1e30, 1e30, 1e30};
+    int exact[3] = {0, 0, 0}, mapped = 0;
+    
+    double t0 = get_time_ms();
+    int ok = save_image_normalized(files[0], img, 0.0f, 255.0f);
+    save_ms[0] = get_time_ms() - t0;
+    for (int f = 1; ok && f < 3; f++) {
+        t0 = get_time_ms();
+        ok = save_image_float(files[f], img);
+        save_ms[f] = get_time_ms() - t0;
+    }
+    if (!ok) {
+        fprintf(stderr, "Erreur: écriture des fichiers de test impossible\n");
+        free_image_float(img);
+        return 1;
+    }
+    
+    printf("\nBenchmark E/S flottantes: %dx%d, %d canaux, %d threads (cache de pages chaud)\n\n",
+           width, height, channels, omp_get_max_threads());
+    
+    // Chargement + un parcours complet des pixels (premier accès aux pages)
+    for (int f = 0; f < 3; f++) {
+        for (int r = 0; r <= repeat; r++) {
+            t0 = get_time_ms();
+            ImageFloat *loaded = f == 0 ? load_image(files[f])
+                                        : load_image_float(files[f], f == 2 ? &mapped : NULL);
+            if (loaded) touch_pixels(loaded);
+            double t1 = get_time_ms();
+            if (r > 0 && t1 - t0 < load_ms[f]) load_ms[f] = t1 - t0;
+            if (r == 0) exact[f] = same_pixels(img, loaded);
+            free_image_float(loaded);
+        }
+    }
+    
+    double megabytes = total * sizeof(float) / 1048576.0;
+    printf("\n╔═════════════════════════════╦═════════════╦═════════════╦═════════╗\n");
+    printf("║ Format                      ║ Écriture ms ║ Lecture ms  ║ Exact   ║\n");
+    printf("╠═════════════════════════════╬═════════════╬═════════════╬═════════╣\n");
+    for (int f = 0; f < 3; f++) {
+        printf("║ %-27s ║ %10.2f  ║ %10.2f  ║ %-7s ║\n", labels[f], save_ms[f], load_ms[f],
+               exact[f] ? "oui" : "non");
+    }
+    printf("╚═════════════════════════════╩═════════════╩═════════════╩═════════╝\n\n");
+    printf("Plans float: %.1f Mo; lecture planaire %.2fx plus rapide que PNG, %.2fx que PFM\n",
+           megabytes, load_ms[0] / load_ms[2], load_ms[1] / load_ms[2]);
+    printf("Planaire projeté sans copie: %s\n\n", mapped ? "oui" : "non");
+    
+    for (int f = 0; f < 3; f++) remove(files[f]);
+    free_image_float(img);
+    return exact[1] && exact[2] && mapped ? 0 : 1;
+}
+
+// ============================================================================
+// Benchmark de l'encodeur PNG (stb_image_write vs encodeur parallèle)
+// ============================================================================
+
+// Vérifie le flux zlib complet (stb_image ignore l'adler32 final): chunks
+// IDAT concaténés puis décompressés par uncompress
+static int png_zlib_valid(const char *filename, size_t raw_bytes) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) return 0;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char *png = (unsigned char *)malloc((size_t)size);
+    unsigned char *idat = (unsigned char *)malloc((size_t)size);
+    unsigned char *raw = (unsigned char *)malloc(raw_bytes);
+    int valid = png && idat && raw && fread(png, 1, (size_t)size, file) == (size_t)size;
+    fclose(file);
+    
+    size_t idat_bytes = 0;
+    for (long pos = 8; valid && pos + 12 <= size;) {
+        uint32_t length = ((uint32_t)png[pos] << 24) | ((uint32_t)png[pos + 1] << 16) |
+                          ((uint32_t)png[pos + 2] << 8) | png[pos + 3];
+        if (pos + 12 + (long)length > size) valid = 0;
+        else if (memcmp(png + pos + 4, "IDAT", 4) == 0) {
+            memcpy(idat + idat_bytes, png + pos + 8, length);
+            idat_bytes += length;
+        }
+        pos += 12 + (long)length;
+    }
+    uLongf out_bytes = (uLongf)raw_bytes;
+    valid = valid && uncompress(raw, &out_bytes, idat, (uLong)idat_bytes) == Z_OK &&
+            out_bytes == raw_bytes;
+    free(png);
+    free(idat);
+    free(raw);
+    return valid;
+}
+
+// Relit un PNG et le compare aux pixels encodés
+static int png_matches(const char *filename, const unsigned char *data, int w, int h, int c) {
+    if (!png_zlib_valid(filename, (size_t)h * ((size_t)w * c + 1))) return 0;
+    int rw, rh, rc;
+    unsigned char *decoded = load_image_u8(filename, &rw, &rh, &rc);
+    int same = decoded && rw == w && rh == h && rc == c &&
+               memcmp(decoded, data, (size_t)w * h * c) == 0;
+    if (decoded) free_image_u8(decoded);
+    return same;
+}
+
+static long file_size(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+static int bench_png(int argc, char *argv[]) {
+    int width = 6000, height = 4000, channels = 3, repeat = 3;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) channels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+    if (width < 1 || height < 1 || channels < 1 || channels > 4) {
+        fprintf(stderr, "Erreur: paramètres invalides\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    // Image débruitée typique: image de test bruitée puis filtrée
+    ImageFloat *test = create_test_image(width, height);
+    float *kernel_1d = create_gaussian_kernel_1d(5, 1.5f);
+    ImageFloat *smooth = NULL;
+    if (test && kernel_1d) {
+        add_gaussian_noise(test, 20.0f, 42);
+        normalize_image(test);
+        smooth = convolve_separable(test, kernel_1d, 5);
+    }
+    unsigned char *rgb = smooth ? planar_to_interleaved(smooth) : NULL;
+    unsigned char *data = (unsigned char *)malloc((size_t)width * height * channels);
+    if (!rgb || !data) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    for (size_t p = 0; p < (size_t)width * height; p++) {
+        for (int ch = 0; ch < channels; ch++) {
+            data[p * channels + ch] = ch < 3 ? rgb[p * 3 + ch] : (unsigned char)(p & 255);
+        }
+    }
+    
+    printf("Benchmark encodeur PNG: %dx%d, %d canaux, %d threads\n\n", width, height, channels,
+           omp_get_max_threads());
+    
+    static const char *labels[] = {"stbi_write_png (niveau 8)", "Parallèle, niveau 0",
+                                   "Parallèle, niveau 1", "Parallèle, niveau 6"};
+    static const int levels[] = {8, 0, 1, 6};
+    const char *filename = "bench_png.png";
+    double best[4] = {1e30, 1e30, 1e30, 1e30};
+    long sizes[4];
+    int valid = 1;
+    
+    for (int mode = 0; mode < 4; mode++) {
+        for (int r = 0; r <= repeat; r++) {
+            double t0 = get_time_ms();
+            int ok = mode == 0 ? stbi_write_png(filename, width, height, channels, data,
+                                                width * channels)
+                               : png_write_image(filename, data, width, height, channels,
+                                                 levels[mode]);
+            double t1 = get_time_ms();
+            if (!ok) valid = 0;
+            if (r > 0 && t1 - t0 < best[mode]) best[mode] = t1 - t0;
+        }
+        sizes[mode] = file_size(filename);
+        if (!png_matches(filename, data, width, height, channels)) {
+            fprintf(stderr, "Erreur: %s: pixels relus différents\n", labels[mode]);
+            valid = 0;
+        }
+    }
+    remove(filename);
+    
+    double megabytes = (double)width * height * channels / 1048576.0;
+    printf("\n╔═══════════════════════════╦═════════════╦═════════════╦═════════════╗\n");
+    printf("║ Encodeur                  ║ Temps (ms)  ║ Mo/s        ║ Taille (Mo) ║\n");
+    printf("╠═══════════════════════════╬═════════════╬═════════════╬═════════════╣\n");
+    for (int mode = 0; mode < 4; mode++) {
+        printf("║ %-25s ║ %10.2f  ║ %10.1f  ║ %10.2f  ║\n", labels[mode], best[mode],
+               megabytes / (best[mode] * 1e-3), sizes[mode] / 1048576.0);
+    }
+    printf("╚═══════════════════════════╩═════════════╩═════════════╩═════════════╝\n\n");
+    printf("Accélération (niveau 6 vs stb): %.2fx; fichiers relus identiques: %s\n\n",
+           best[0] / best[3], valid ? "oui" : "non");
+    
+    free(data);
+    free(rgb);
+    free_image_float(smooth);
+    free_image_float(test);
+    mkl_free(kernel_1d);
+    return valid ? 0 : 1;
+}
+
+// ============================================================================
+// Benchmark des formats de sortie (PNG, PPM/PGM, QOI, JPEG, PFM, planaire)
+// ============================================================================
+
+// Décodeur QOI de référence (spécification qoiformat.org), indépendant de
+// l'encodeur de io.c; sortie en 3 ou 4 canaux selon l'en-tête
+static unsigned char *qoi_decode(const char *filename, int *w, int *h, int *c) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char *qoi = size >= 22 ? (unsigned char *)malloc((size_t)size) : NULL;
+    int valid = qoi && fread(qoi, 1, (size_t)size, file) == (size_t)size &&
+                memcmp(qoi, "qoif", 4) == 0;
+    fclose(file);
+    if (!valid) {
+        free(qoi);
+        return NULL;
+    }
+    
+    *w = (int)(((uint32_t)qoi[4] << 24) | ((uint32_t)qoi[5] << 16) | (qoi[6] << 8) | qoi[7]);
+    *h = (int)(((uint32_t)qoi[8] << 24) | ((uint32_t)qoi[9] << 16) | (qoi[10] << 8) | qoi[11]);
+    *c = qoi[12];
+    size_t pixels = (size_t)*w * *h;
+    unsigned char *out = (unsigned char *)malloc(pixels * *c);
+    if (!out) {
+        free(qoi);
+        return NULL;
+    }
+    
+    unsigned char index[64][4] = {{0}};
+    unsigned char px[4] = {0, 0, 0, 255};
+    long pos = 14, end = size - 8;
+    int run = 0;
+    for (size_t p = 0; p < pixels; p++) {
+        if (run > 0) {
+            run--;
+        } else if (pos < end) {
+            int b1 = qoi[pos++];
+            if (b1 == 0xfe) {
+                memcpy(px, qoi + pos, 3);
+                pos += 3;
+            } else if (b1 == 0xff) {
+                memcpy(px, qoi + pos, 4);
+                pos += 4;
+            } else if ((b1 & 0xc0) == 0x00) {
+                memcpy(px, index[b1], 4);
+            } else if ((b1 & 0xc0) == 0x40) {
+                px[0] += ((b1 >> 4) & 3) - 2;
+                px[1] += ((b1 >> 2) & 3) - 2;
+                px[2] += (b1 & 3) - 2;
+            } else if ((b1 & 0xc0) == 0x80) {
+                int b2 = qoi[pos++];
+                int vg = (b1 & 0x3f) - 32;
+                px[0] += vg - 8 + ((b2 >> 4) & 0x0f);
+                px[1] += vg;
+                px[2] += vg - 8 + (b2 & 0x0f);
+            } else {
+                run = b1 & 0x3f;
+            }
+            memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+        }
+        memcpy(out + p * *c, px, (size_t)*c);
+    }
+    free(qoi);
+    return out;
+}
+
+// Relit un fichier u8 et le compare aux pixels attendus; en QOI, le gris
+// est relu en RGB (trois composantes égales)
+static int encoded_matches(const char *filename, ImageFormat format,
+                           const unsigned char *data, int w, int h, int c) {
+    int rw, rh, rc;
+    unsigned char *decoded = format == IMAGE_FORMAT_QOI ? qoi_decode(filename, &rw, &rh, &rc)
+                                                        : load_image_u8(filename, &rw, &rh, &rc);
+    int same = decoded && rw == w && rh == h;
+    for (size_t p = 0; same && p < (size_t)w * h; p++) {
+        for (int ch = 0; ch < rc; ch++) {
+            if (decoded[p * rc + ch] != data[p * c + (c == 1 ? 0 : ch)]) same = 0;
+        }
+    }
+    if (decoded) {
+        if (format == IMAGE_FORMAT_QOI) free(decoded);
+        else free_image_u8(decoded);
+    }
+    return same;
+}
+
+// PSNR (dB) d'un fichier relu par rapport aux pixels attendus (JPEG, avec pertes)
+static double encoded_psnr(const char *filename, const unsigned char *data, int w, int h,
+                           int c) {
+    int rw, rh, rc;
+    unsigned char *decoded = load_image_u8(filename, &rw, &rh, &rc);
+    if (!decoded || rw != w || rh != h) {
+        if (decoded) free_image_u8(decoded);
+        return 0.0;
+    }
+    // Un JPEG gris peut être relu en RGB: comparaison au premier canal
+    double sum = 0.0;
+    for (size_t p = 0; p < (size_t)w * h; p++) {
+        for (int ch = 0; ch < rc; ch++) {
+            double d = (double)decoded[p * rc + ch] - data[p * c + (c == 1 ? 0 : ch)];
+            sum += d * d;
+        }
+    }
+    free_image_u8(decoded);
+    double mse = sum / ((double)w * h * rc);
+    return mse > 0.0 ? 10.0 * log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+static int bench_encode(int argc, char *argv[]) {
+    int width = 6000, height = 4000, channels = 3, repeat = 3;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) channels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+    if (width < 1 || height < 1 || (channels != 1 && channels != 3)) {
+        fprintf(stderr, "Erreur: paramètres invalides (-c 1|3)\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    // Image débruitée typique, réduite au premier plan en niveaux de gris
+    ImageFloat *test = create_test_image(width, height);
+    float *kernel_1d = create_gaussian_kernel_1d(5, 1.5f);
+    ImageFloat *smooth = NULL;
+    if (test && kernel_1d) {
+        add_gaussian_noise(test, 20.0f, 42);
+        normalize_image(test);
+        smooth = convolve_separable(test, kernel_1d, 5);
+    }
+    ImageFloat *img = smooth;
+    if (smooth && channels == 1) {
+        img = create_image_float_uninit(width, height, 1);
+        if (img) memcpy(img->data, smooth->data, (size_t)width * height * sizeof(float));
+    }
+    size_t row_bytes = (size_t)width * channels;
+    unsigned char *data = (unsigned char *)malloc(row_bytes * height);
+    if (!img || !data) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    // Pixels attendus: même quantification que save_image_as sur [0, 255]
+    quantize_interleave_rows(img, 1.0f, 0.0f, 0, height, data, row_bytes);
+    set_io_quiet(1);
+    
+    printf("Benchmark formats de sortie: %dx%d, %d canaux, %d threads\n\n", width, height,
+           channels, omp_get_max_threads());
+    
+    enum { NUM_MODES = 7 };
+    static const char *labels[NUM_MODES] = {"PNG, niveau 1", "PNG, niveau 0", "PPM/PGM",
+                                            "QOI", "JPEG, q = 90", "PFM (float32)",
+                                            "Planaire (float32)"};
+    static const ImageFormat formats[NUM_MODES] = {
+        IMAGE_FORMAT_PNG, IMAGE_FORMAT_PNG, IMAGE_FORMAT_PNM, IMAGE_FORMAT_QOI,
+        IMAGE_FORMAT_JPEG, IMAGE_FORMAT_PFM, IMAGE_FORMAT_PLANAR};
+    double best[NUM_MODES];
+    long sizes[NUM_MODES];
+    char checks[NUM_MODES][24];
+    int valid = 1;
+    
+    for (int mode = 0; mode < NUM_MODES; mode++) {
+        char filename[64];
+        snprintf(filename, sizeof(filename), "bench_encode.%s",
+                 image_format_extension(formats[mode], channels));
+        set_png_compression_level(mode == 1 ? 0 : 1);
+        best[mode] = 1e30;
+        for (int r = 0; r <= repeat; r++) {
+            double t0 = get_time_ms();
+            int ok = save_image_as(filename, img, 0.0f, 255.0f, NULL);
+            double t1 = get_time_ms();
+            if (!ok) valid = 0;
+            if (r > 0 && t1 - t0 < best[mode]) best[mode] = t1 - t0;
+        }
+        sizes[mode] = file_size(filename);
+        
+        // Vérification: relecture exacte, sauf JPEG (PSNR affiché)
+        int same = 1;
+        if (formats[mode] == IMAGE_FORMAT_JPEG) {
+            snprintf(checks[mode], sizeof(checks[mode]), "%.1f dB",
+                     encoded_psnr(filename, data, width, height, channels));
+        } else if (formats[mode] == IMAGE_FORMAT_PFM || formats[mode] == IMAGE_FORMAT_PLANAR) {
+            ImageFloat *back = load_image_float(filename, NULL);
+            same = back && same_pixels(back, img);
+            free_image_float(back);
+        } else {
+            same = encoded_matches(filename, formats[mode], data, width, height, channels);
+        }
+        if (formats[mode] != IMAGE_FORMAT_JPEG) {
+            snprintf(checks[mode], sizeof(checks[mode]), "%s", same ? "exact" : "ERREUR");
+        }
+        if (!same) {
+            fprintf(stderr, "Erreur: %s: pixels relus différents\n", labels[mode]);
+            valid = 0;
+        }
+        remove(filename);
+    }
+    set_png_compression_level(1);
+    
+    double megabytes = (double)row_bytes * height / 1048576.0;
+    printf("╔════════════════════╦═════════════╦═════════════╦═════════════╦═════════════╗\n");
+    printf("║ Format             ║ Temps (ms)  ║ Mo/s        ║ Taille (Mo) ║ Relecture   ║\n");
+    printf("╠════════════════════╬═════════════╬═════════════╬═════════════╬═════════════╣\n");
+    for (int mode = 0; mode < NUM_MODES; mode++) {
+        printf("║ %-18s ║ %10.2f  ║ %10.1f  ║ %10.2f  ║ %-11s ║\n", labels[mode], best[mode],
+               megabytes / (best[mode] * 1e-3), sizes[mode] / 1048576.0, checks[mode]);
+    }
+    printf("╚════════════════════╩═════════════╩═════════════╩═════════════╩═════════════╝\n\n");
+    printf("Débit en Mo/s de pixels u8 encodés; QOI vs PNG niveau 1: %.2fx; relectures "
+           "sans perte exactes: %s\n\n", best[0] / best[3], valid ? "oui" : "non");
+    
+    free(data);
+    if (img != smooth) free_image_float(img);
+    free_image_float(smooth);
+    free_image_float(test);
+    mkl_free(kernel_1d);
+    return valid ? 0 : 1;
+}
+
+// ============================================================================
+// Région d'intérêt: moteurs *_roi vs image entière recadrée
+// ============================================================================
+
+// Moteur m (spatial, spatial_blas, séparable, FFT) sur l'image entière ou,
+// si roi n'est pas NULL, sur la seule fenêtre
+static ImageFloat *roi_engine(int m, const ImageFloat *img, const Kernel *kernel_2d,
+                              const float *kernel_1d, const ImageROI *roi) {
+    switch (m) {
+        case 0:
+            return roi ? convolve_spatial_roi(img, kernel_2d, roi) : convolve_spatial(img, kernel_2d);
+        case 1:
+            return roi ? convolve_spatial_blas_roi(img, kernel_2d, roi)
+                       : convolve_spatial_blas(img, kernel_2d);
+        case 2:
+            return roi ? convolve_separable_roi(img, kernel_1d, kernel_2d->size, roi)
+                       : convolve_separable(img, kernel_1d, kernel_2d->size);
+        default:
+            return roi ? convolve_fft_roi(img, kernel_2d, roi) : convolve_fft(img, kernel_2d);
+    }
+}
+
+static int bench_roi(int argc, char *argv[]) {
+    int width = 2048, height = 2048, kernel_size = 7, repeat = 3;
+    ImageROI roi = {-1, -1, 0, 0};
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) kernel_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-R") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d,%d,%d,%d", &roi.x, &roi.y, &roi.width, &roi.height) != 4) {
+                roi.width = 0;
+            }
+        }
+    }
+    // Fenêtre par défaut: le quart central
+    if (roi.x < 0 && roi.y < 0 && roi.width == 0) {
+        roi = (ImageROI){width / 4, height / 4, width / 2, height / 2};
+    }
+    if (width < 1 || height < 1 || kernel_size < 1 || !roi_clip(&roi, width, height)) {
+        fprintf(stderr, "Erreur: paramètres invalides (-R x,y,w,h dans l'image)\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    Kernel *kernel_2d = create_gaussian_kernel(kernel_size, kernel_size / 3.0f);
+    float *kernel_1d = create_gaussian_kernel_1d(kernel_size, kernel_size / 3.0f);
+    ImageFloat *img = create_test_image(width, height);
+    if (!kernel_2d || !kernel_1d || !img) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    add_gaussian_noise(img, 20.0f, 42);
+    
+    printf("Benchmark ROI: image %dx%d, fenêtre %dx%d à (%d,%d), noyau %d, %d threads\n\n",
+           width, height, roi.width, roi.height, roi.x, roi.y, kernel_size,
+           omp_get_max_threads());
+    
+    // Même somme pixel par pixel: écart nul, sauf arrondis de la FFT sur
+    // une région de taille différente. La FFT pleine image est circulaire:
+    // comparée seulement si la fenêtre et son halo ne touchent pas les bords
+    static const char *labels[] = {"Spatial", "Spatial BLAS", "Separable", "FFT"};
+    static const float tolerance[] = {0.0f, 0.0f, 1e-3f, 1e-2f};
+    int half = kernel_size / 2;
+    int interior = roi.x >= half && roi.y >= half && roi.x + roi.width + half <= width &&
+                   roi.y + roi.height + half <= height;
+    double best_full[4], best_roi[4];
+    float max_error[4];
+    int valid = 1;
+    
+    for (int m = 0; m < 4; m++) {
+        ImageFloat *full = NULL, *window = NULL;
+        best_full[m] = best_roi[m] = 1e30;
+        for (int r = 0; r < repeat; r++) {
+            free_image_float(full);
+            free_image_float(window);
+            double t0 = get_time_ms();
+            full = roi_engine(m, img, kernel_2d, kernel_1d, NULL);
+            double t1 = get_time_ms();
+            window = roi_engine(m, img, kernel_2d, kernel_1d, &roi);
+            double t2 = get_time_ms();
+            if (t1 - t0 < best_full[m]) best_full[m] = t1 - t0;
+            if (t2 - t1 < best_roi[m]) best_roi[m] = t2 - t1;
+        }
+        
+        ImageFloat *crop = full ? crop_image(full, &roi) : NULL;
+        max_error[m] = INFINITY;
+        if (crop && window) {
+            size_t total = (size_t)roi.width * roi.height * img->channels;
+            max_error[m] = 0.0f;
+            for (size_t i = 0; i < total; i++) {
+                float error = fabsf(window->data[i] - crop->data[i]);
+                if (!(error <= max_error[m])) max_error[m] = error;
+            }
+        }
+        if (!(max_error[m] <= tolerance[m]) && (m != 3 || interior || !window)) {
+            fprintf(stderr, "Erreur: %s: fenêtre différente de l'image entière recadrée "
+                            "(écart %g)\n", labels[m], max_error[m]);
+            valid = 0;
+        }
+        free_image_float(crop);
+        free_image_float(full);
+        free_image_float(window);
+    }
+    
+    printf("╔════════════════╦══════════════════╦══════════════╦═════════════╦═════════════╗\n");
+    printf("║ Méthode        ║ Image entière ms ║ Fenêtre ms   ║ Gain        ║ Écart max   ║\n");
+    printf("╠════════════════╬══════════════════╬══════════════╬═════════════╬═════════════╣\n");
+    for (int m = 0; m < 4; m++) {
+        printf("║ %-14s ║ %15.2f  ║ %11.2f  ║ %10.2fx ║ %11.2e ║\n", labels[m], best_full[m],
+               best_roi[m], best_full[m] / best_roi[m], max_error[m]);
+    }
+    printf("╚════════════════╩══════════════════╩══════════════╩═════════════╩═════════════╝\n\n");
+    printf("Fenêtres identiques à l'image entière recadrée: %s%s\n\n", valid ? "oui" : "non",
+           interior ? "" : " (FFT non comparée: halo hors de l'image)");
+    
+    free_image_float(img);
+    free_kernel(kernel_2d);
+    mkl_free(kernel_1d);
+    return valid ? 0 : 1;
+}
+
+// ============================================================================
+// Copie sur écriture: clone vs copie profonde, recyclage du pool
+// ============================================================================
+
+static int bench_cow(int argc, char *argv[]) {
+    int width = 2048, height = 2048, repeat = 5;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+    if (width < 1 || height < 1) {
+        fprintf(stderr, "Erreur: paramètres invalides\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    ImageFloat *img = create_test_image(width, height);
+    ImageFloat *snapshot = img ? create_image_float_uninit(width, height, img->channels) : NULL;
+    if (!img || !snapshot) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    size_t total = (size_t)width * height * img->channels;
+    add_gaussian_noise(img, 20.0f, 42);
+    memcpy(snapshot->data, img->data, total * sizeof(float));
+    
+    printf("Benchmark copie sur écriture: image %dx%dx%d, %d threads\n\n", width, height,
+           img->channels, omp_get_max_threads());
+    
+    int valid = 1;
+    
+    // Le clone partage les pixels; une écriture par l'un des deux (bruit,
+    // normalisation) ne doit jamais se voir dans l'autre
+    ImageFloat *clone = clone_image(img);
+    if (!clone || clone->data != img->data || !image_is_shared(img)) {
+        fprintf(stderr, "Erreur: clone_image ne partage pas les pixels\n");
+        valid = 0;
+    }
+    if (clone) {
+        add_gaussian_noise(clone, 5.0f, 7);
+        if (clone->data == img->data || !same_pixels(img, snapshot) || image_is_shared(img)) {
+            fprintf(stderr, "Erreur: bruit ajouté au clone visible dans l'original\n");
+            valid = 0;
+        }
+        free_image_float(clone);
+    }
+    clone = clone_image(img);
+    if (clone) {
+        normalize_image(img);
+        if (!same_pixels(clone, snapshot) || same_pixels(img, snapshot)) {
+            fprintf(stderr, "Erreur: normalisation de l'original visible dans le clone\n");
+            valid = 0;
+        }
+        // Seul propriétaire restant: modifiable sans copie
+        float *data = clone->data;
+        free_image_float(img);
+        img = clone;
+        if (image_is_shared(img) || !image_make_writable(img) || img->data != data) {
+            fprintf(stderr, "Erreur: image_make_writable copie un tampon non partagé\n");
+            valid = 0;
+        }
+        add_gaussian_noise(img, 0.0f, 1);
+        if (img->data != data) {
+            fprintf(stderr, "Erreur: bruit copié alors que l'image est seule propriétaire\n");
+            valid = 0;
+        }
+    }
+    
+    // Image remplie à la main (sans tampon, plans de l'appelant): ni partagée
+    // ni possédée, clonée par copie et modifiée en place
+    float *pixels = (float *)malloc(total * sizeof(float));
+    if (pixels) {
+        memcpy(pixels, snapshot->data, total * sizeof(float));
+        ImageFloat view = {pixels, width, height, snapshot->channels, NULL};
+        clone = clone_image(&view);
+        if (image_is_shared(&view) || !clone || clone->data == pixels ||
+            !same_pixels(clone, snapshot)) {
+            fprintf(stderr, "Erreur: image sans tampon mal clonée\n");
+            valid = 0;
+        }
+        normalize_image(&view);
+        if (view.data != pixels || same_pixels(&view, snapshot) ||
+            (clone && !same_pixels(clone, snapshot))) {
+            fprintf(stderr, "Erreur: image sans tampon non modifiée en place\n");
+            valid = 0;
+        }
+        free_image_float(clone);
+        free(pixels);
+    }
+    
+    // Pool: un plan de même taille que le plan libéré est un tampon recyclé
+    PoolStats before, after;
+    ImageFloat *scratch = create_image_float_uninit(width, height, img->channels);
+    free_image_float(scratch);
+    pool_get_stats(&before);
+    scratch = create_image_float_uninit(width, height, img->channels);
+    pool_get_stats(&after);
+    if (!scratch || after.hits != before.hits + 1 || after.misses != before.misses) {
+        fprintf(stderr, "Erreur: plan libéré non recyclé par le pool\n");
+        valid = 0;
+    }
+    free_image_float(scratch);
+    
+    // Copie profonde (allocation + memcpy) vs clone (compteur de références)
+    double best_copy = 1e30, best_clone = 1e30;
+    for (int r = 0; r < repeat; r++) {
+        double t0 = get_time_ms();
+        ImageFloat *copy = create_image_float_uninit(width, height, img->channels);
+        if (copy) memcpy(copy->data, img->data, total * sizeof(float));
+        double t1 = get_time_ms();
+        clone = clone_image(img);
+        double t2 = get_time_ms();
+        free_image_float(copy);
+        free_image_float(clone);
+        if (t1 - t0 < best_copy) best_copy = t1 - t0;
+        if (t2 - t1 < best_clone) best_clone = t2 - t1;
+    }
+    
+    printf("Copie profonde: %.3f ms, clone: %.4f ms\n", best_copy, best_clone);
+    printf("Clones indépendants, tampon seul propriétaire modifié sans copie, plan recyclé: "
+           "%s\n\n", valid ? "oui" : "non");
+    
+    free_image_float(snapshot);
+    free_image_float(img);
+    return valid ? 0 : 1;
+}
+
+// ============================================================================
+// Min/max: boucle scalaire vs réduction vectorisée, passe fusionnée
+// ============================================================================
+
+// Min/max de référence, boucle scalaire séquentielle
+static void minmax_scalar(const ImageFloat *img, float *min_val, float *max_val) {
+    size_t total = (size_t)img->width * img->height * img->channels;
+    float lo = img->data[0], hi = img->data[0];
+    for (size_t i = 1; i < total; i++) {
+        if (img->data[i] < lo) lo = img->data[i];
+        if (img->data[i] > hi) hi = img->data[i];
+    }
+    *min_val = lo;
+    *max_val = hi;
+}
+
+static int bench_minmax(int argc, char *argv[]) {
+    int width = 2048, height = 2048, kernel_size = 7, repeat = 5;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) kernel_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+    if (width < 1 || height < 1 || kernel_size < 1) {
+        fprintf(stderr, "Erreur: paramètres invalides\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    float *kernel_1d = create_gaussian_kernel_1d(kernel_size, kernel_size / 3.0f);
+    ImageFloat *img = create_test_image(width, height);
+    ImageFloat *output = img ? create_image_float_uninit(width, height, img->channels) : NULL;
+    ConvWorkspace *ws = create_conv_workspace();
+    if (!kernel_1d || !img || !output || !ws) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    add_gaussian_noise(img, 20.0f, 42);
+    
+    printf("Benchmark min/max: image %dx%dx%d, noyau %d, %d threads\n\n", width, height,
+           img->channels, kernel_size, omp_get_max_threads());
+    
+    static const char *labels[] = {"Min/max", "Separable + min/max"};
+    double best_ref[2] = {1e30, 1e30}, best_opt[2] = {1e30, 1e30};
+    float ref_min = 0.0f, ref_max = 0.0f, simd_min = 0.0f, simd_max = 0.0f;
+    float range_min = 0.0f, range_max = 0.0f, out_min = 0.0f, out_max = 0.0f;
+    
+    for (int r = 0; r < repeat; r++) {
+        // Boucle scalaire vs réduction parallèle vectorisée
+        double t0 = get_time_ms();
+        minmax_scalar(img, &ref_min, &ref_max);
+        double t1 = get_time_ms();
+        image_minmax(img, &simd_min, &simd_max);
+        double t2 = get_time_ms();
+        if (t1 - t0 < best_ref[0]) best_ref[0] = t1 - t0;
+        if (t2 - t1 < best_opt[0]) best_opt[0] = t2 - t1;
+        
+        // Convolution puis passe de min/max vs min/max pendant la passe verticale
+        t0 = get_time_ms();
+        convolve_separable_into(img, kernel_1d, kernel_size, output, ws);
+        image_minmax(output, &out_min, &out_max);
+        t1 = get_time_ms();
+        convolve_separable_into_range(img, kernel_1d, kernel_size, output, ws, &range_min,
+                                      &range_max);
+        t2 = get_time_ms();
+        if (t1 - t0 < best_ref[1]) best_ref[1] = t1 - t0;
+        if (t2 - t1 < best_opt[1]) best_opt[1] = t2 - t1;
+    }
+    
+    // Plages exactes: min et max ne dépendent pas de l'ordre de réduction
+    int valid = 1;
+    if (simd_min != ref_min || simd_max != ref_max) {
+        fprintf(stderr, "Erreur: image_minmax [%g, %g], référence [%g, %g]\n", simd_min,
+                simd_max, ref_min, ref_max);
+        valid = 0;
+    }
+    minmax_scalar(output, &out_min, &out_max);
+    if (range_min != out_min || range_max != out_max) {
+        fprintf(stderr, "Erreur: convolve_separable_into_range [%g, %g], min/max du "
+                        "résultat [%g, %g]\n", range_min, range_max, out_min, out_max);
+        valid = 0;
+    }
+    
+    printf("╔══════════════════════╦══════════════╦══════════════╦═════════════╗\n");
+    printf("║ Opération            ║ Référence ms ║ Optimisé ms  ║ Gain        ║\n");
+    printf("╠══════════════════════╬══════════════╬══════════════╬═════════════╣\n");
+    for (int m = 0; m < 2; m++) {
+        printf("║ %-20s ║ %11.3f  ║ %11.3f  ║ %10.1fx ║\n", labels[m], best_ref[m], best_opt[m],
+               best_ref[m] / best_opt[m]);
+    }
+    printf("╚══════════════════════╩══════════════╩══════════════╩═════════════╝\n\n");
+    printf("Min/max identiques à la boucle scalaire: %s\n\n", valid ? "oui" : "non");
+    
+    free_conv_workspace(ws);
+    free_image_float(output);
+    free_image_float(img);
+    mkl_free(kernel_1d);
+    return valid ? 0 : 1;
+}
+
+// ============================================================================
+// Quantification: normalisation en place + entrelacement vs passe fusionnée
+// ============================================================================
+
+static int bench_quantize(int argc, char *argv[]) {
+    int width = 2048, height = 2048, channels = 3, repeat = 5;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) channels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+    if (width < 1 || height < 1 || channels < 1 || channels > 4) {
+        fprintf(stderr, "Erreur: paramètres invalides (1 à 4 canaux)\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    // Valeurs à quelques ulp des seuils d'arrondi (k + 0.5 après mise à
+    // l'échelle), plage dont l'échelle 255 / (max - min) n'est pas exacte:
+    // un arrondi de plus ou de moins change l'octet produit
+    ImageFloat *img = create_image_float_uninit(width, height, channels);
+    if (!img) {
+        fprintf(stderr, "Erreur: allocation impossible\n");
+        return 1;
+    }
+    const float min_val = -200.0f, max_val = 700.0f;
+    float scale, offset;
+    normalize_coefficients(min_val, max_val, &scale, &offset);
+    size_t total = (size_t)width * height * channels;
+    for (size_t i = 0; i < total; i++) {
+        float v = ((float)(i % 256) + 0.5f - offset) / scale;
+        for (int step = (int)(i / 256 % 9) - 4; step != 0; step += step > 0 ? -1 : 1) {
+            v = nextafterf(v, step > 0 ? INFINITY : -INFINITY);
+        }
+        img->data[i] = v;
+    }
+    
+    printf("Benchmark quantification: image %dx%dx%d, %d threads\n\n", width, height, channels,
+           omp_get_max_threads());
+    
+    double best_ref = 1e30, best_fused = 1e30;
+    unsigned char *ref_u8 = NULL, *fused_u8 = NULL;
+    for (int r = 0; r < repeat; r++) {
+        free(ref_u8);
+        free(fused_u8);
+        double t0 = get_time_ms();
+        ImageFloat *copy = clone_image(img);
+        if (copy) normalize_image_range(copy, min_val, max_val);
+        ref_u8 = copy ? planar_to_interleaved(copy) : NULL;
+        double t1 = get_time_ms();
+        fused_u8 = planar_to_interleaved_normalized(img, min_val, max_val);
+        double t2 = get_time_ms();
+        free_image_float(copy);
+        if (t1 - t0 < best_ref) best_ref = t1 - t0;
+        if (t2 - t1 < best_fused) best_fused = t2 - t1;
+    }
+    
+    // Même arrondi: octets identiques, y compris aux bornes de 0.5
+    size_t diff = 0;
+    for (size_t i = 0; ref_u8 && fused_u8 && i < total; i++) diff += ref_u8[i] != fused_u8[i];
+    int valid = ref_u8 && fused_u8 && diff == 0;
+    if (!valid) {
+        fprintf(stderr, "Erreur: quantification fusionnée différente de normalize_image_range "
+                        "+ planar_to_interleaved (%zu octets)\n", diff);
+    }
+    
+    printf("╔══════════════════════════════╦══════════════╦═════════════╗\n");
+    printf("║ Version                      ║ Temps ms     ║ Gain        ║\n");
+    printf("╠══════════════════════════════╬══════════════╬═════════════╣\n");
+    printf("║ Normalise + entrelace        ║ %11.3f  ║ %10.2fx ║\n", best_ref, 1.0);
+    printf("║ Fusionnee                    ║ %11.3f  ║ %10.2fx ║\n", best_fused,
+           best_ref / best_fused);
+    printf("╚══════════════════════════════╩══════════════╩═════════════╝\n\n");
+    printf("Octets identiques: %s\n\n", valid ? "oui" : "non");
+    
+    free(ref_u8);
+    free(fused_u8);
+    free_image_float(img);
+    return valid ? 0 : 1;
+}
+
+// ============================================================================
+// Service persistant: latence d'une requête sur la socket
+// ============================================================================
+
+static int bench_service(int argc, char *argv[]) {
+    const char *socket_path = NULL;
+    int repeat = 100, long_bytes = 0;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) socket_path = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-L") == 0 && i + 1 < argc) long_bytes = atoi(argv[++i]);
+    }
+    if (!socket_path || long_bytes < 0) {
+        fprintf(stderr, "Erreur: -S <socket> obligatoire (service lancé par --serve)\n");
+        return 1;
+    }
+    if (repeat < 1) repeat = 1;
+    
+    // PING: connexion, requête et réponse, sans calcul
+    char reply[1024];
+    double best = 1e30, total = 0.0;
+    for (int r = 0; r < repeat; r++) {
+        double t0 = get_time_ms();
+        if (!server_request(socket_path, "PING", reply, sizeof(reply)) ||
+            strcmp(reply, "OK") != 0) {
+            fprintf(stderr, "Erreur: service injoignable sur '%s'\n", socket_path);
+            return 1;
+        }
+        double elapsed = get_time_ms() - t0;
+        total += elapsed;
+        if (elapsed < best) best = elapsed;
+    }
+    printf("PING: %.3f ms en moyenne, %.3f ms au mieux (%d requêtes)\n", total / repeat, best,
+           repeat);
+    
+    // Requête PING complétée par des espaces jusqu'à long_bytes octets: au-delà
+    // de la limite de ligne du service, elle doit être refusée, pas tronquée
+    if (long_bytes > 0) {
+        char *request = (char *)malloc((size_t)long_bytes + 1);
+        if (!request) return 1;
+        memset(request, ' ', (size_t)long_bytes);
+        memcpy(request, "PING", long_bytes < 4 ? (size_t)long_bytes : 4);
+        request[long_bytes] = '\0';
+        int ok = server_request(socket_path, request, reply, sizeof(reply));
+        free(request);
+        printf("Requête de %d octets: %s\n", long_bytes, ok ? reply : "sans réponse");
+        if (!ok) return 1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Programme principal
+// ============================================================================
+
+typedef struct {
+    const char *name;
+    const char *description;
+    int (*run)(int argc, char *argv[]);
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+    {"tlb", "Défauts de TLB avec pages de 4 Ko / 2 Mo [-W w] [-H h] [-c canaux] [-k taille] [-m vertical|fft]", bench_tlb},
+    {"numa", "Bande passante inter-sockets, init. série vs first-touch [-s Mo] [-r répétitions] [-a compact|scatter]", bench_numa},
+    {"f16", "Séparable sur plans float32 vs binary16 [-W w] [-H h] [-c canaux] [-k taille] [-r répétitions]", bench_f16},
+    {"deinterleave", "Conversion u8 entrelacé -> float planaire, scalaire vs SIMD [-W w] [-H h] [-c canaux] [-r répétitions]", bench_deinterleave},
+    {"alpha", "Détection d'alpha opaque, scalaire vs SIMD; -o/-i: écrire/vérifier une image de test [-W w] [-H h] [-c 2|4] [-r répétitions]", bench_alpha},
+    {"chroma", "Séparable RGB vs luminance + chrominance à mi-résolution [-W w] [-H h] [-k taille] [-r répétitions]", bench_chroma},
+    {"strip", "Débruitage PNG par bandes, mémoire O(largeur) [-W w] [-H h] [-c canaux] [-k taille] [-S lignes] [-i png] [-v]", bench_strip},
+    {"floatio", "Lecture/écriture PNG vs PFM vs planaire projeté (mmap), aller-retour exact [-W w] [-H h] [-c 1|3] [-r répétitions]", bench_floatio},
+    {"png", "Encodage PNG, stbi_write_png vs encodeur parallèle (niveaux 0, 1, 6) [-W w] [-H h] [-c canaux] [-r répétitions]", bench_png},
+    {"encode", "Formats de sortie: PNG (niveaux 1, 0), PPM/PGM, QOI, JPEG, PFM, planaire [-W w] [-H h] [-c 1|3] [-r répétitions]", bench_encode},
+    {"roi", "Moteurs *_roi vs image entière recadrée: temps et écart [-W w] [-H h] [-k taille] [-r répétitions] [-R x,y,w,h]", bench_roi},
+    {"cow", "Clone (copie sur écriture) vs copie profonde, clones indépendants, recyclage du pool [-W w] [-H h] [-r répétitions]", bench_cow},
+    {"minmax", "Min/max scalaire vs image_minmax, séparable + min/max vs passe fusionnée, vérifiés [-W w] [-H h] [-k taille] [-r répétitions]", bench_minmax},
+    {"quantize", "Normalisation + entrelacement vs quantification fusionnée, octets identiques [-W w] [-H h] [-c canaux] [-r répétitions]", bench_quantize},
+    {"service", "Latence d'une requête PING au service (--serve); -L: requête de n octets [-S socket] [-r répétitions] [-L octets]", bench_service},
+};
+
+static void print_usage(const char *prog_name) {
+    printf("Usage: %s <benchmark> [options]\n\n", prog_name);
+    printf("Benchmarks:\n");
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+        printf("  %-12s %s\n", benchmarks[i].name, benchmarks[i].description);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+        if (strcmp(argv[1], benchmarks[i].name) == 0) {
+            return benchmarks[i].run(argc - 2, argv + 2);
+        }
+    }
+    
+    print_usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,267 @@
+#include "color.h"
+#include "filters.h"
+#include "mkl_ops.h"
+#include "pool.h"
+#include <mkl/mkl.h>
+#include <omp.h>
+#include <immintrin.h>
+
+// BT.601 pleine échelle (JFIF), sans le décalage de 128 de la chrominance
+#define Y_R 0.299f
+#define Y_G 0.587f
+#define Y_B 0.114f
+#define CB_R -0.168736f
+#define CB_G -0.331264f
+#define CB_B 0.5f
+#define CR_R 0.5f
+#define CR_G -0.418688f
+#define CR_B -0.081312f
+#define R_CR 1.402f
+#define G_CB -0.344136f
+#define G_CR -0.714136f
+#define B_CB 1.772f
+
+static int cpu_has_avx2_fma(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    return cached;
+}
+
+int chroma_kernel_size(int kernel_size) {
+    int size = (kernel_size / 2) | 1;
+    return size < 3 ? 3 : size;
+}
+
+// ============================================================================
+// RGB -> Y (pleine résolution) et Cb/Cr (moyenne 2x2)
+// ============================================================================
+
+static void luma_row_scalar(const float *r, const float *g, const float *b, int from, int n,
+                            float *y) {
+    for (int i = from; i < n; i++) {
+        y[i] = Y_R * r[i] + Y_G * g[i] + Y_B * b[i];
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void luma_row_avx2(const float *r, const float *g, const float *b, int n, float *y) {
+    const __m256 kr = _mm256_set1_ps(Y_R), kg = _mm256_set1_ps(Y_G), kb = _mm256_set1_ps(Y_B);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 acc = _mm256_mul_ps(kr, _mm256_loadu_ps(r + i));
+        acc = _mm256_fmadd_ps(kg, _mm256_loadu_ps(g + i), acc);
+        acc = _mm256_fmadd_ps(kb, _mm256_loadu_ps(b + i), acc);
+        _mm256_storeu_ps(y + i, acc);
+    }
+    luma_row_scalar(r, g, b, i, n, y);
+}
+
+// Une ligne de chrominance à partir de deux lignes RGB (row1 = row0 en bas
+// d'une image de hauteur impaire); la dernière colonne est répétée si la
+// largeur est impaire. La conversion étant linéaire, moyenner RGB puis
+// convertir revient à moyenner Cb et Cr.
+static void chroma_row(const float *const *row0, const float *const *row1, int width,
+                       float *cb, float *cr) {
+    const float *r0 = row0[0], *g0 = row0[1], *b0 = row0[2];
+    const float *r1 = row1[0], *g1 = row1[1], *b1 = row1[2];
+    int pairs = width / 2;
+    
+    #pragma omp simd
+    for (int cx = 0; cx < pairs; cx++) {
+        int x = 2 * cx;
+        float r = 0.25f * (r0[x] + r0[x + 1] + r1[x] + r1[x + 1]);
+        float g = 0.25f * (g0[x] + g0[x + 1] + g1[x] + g1[x + 1]);
+        float b = 0.25f * (b0[x] + b0[x + 1] + b1[x] + b1[x + 1]);
+        cb[cx] = CB_R * r + CB_G * g + CB_B * b;
+        cr[cx] = CR_R * r + CR_G * g + CR_B * b;
+    }
+    if (width & 1) {
+        int x = width - 1;
+        float r = 0.5f * (r0[x] + r1[x]);
+        float g = 0.5f * (g0[x] + g1[x]);
+        float b = 0.5f * (b0[x] + b1[x]);
+        cb[pairs] = CB_R * r + CB_G * g + CB_B * b;
+        cr[pairs] = CR_R * r + CR_G * g + CR_B * b;
+    }
+}
+
+int rgb_to_luma_chroma(const ImageFloat *rgb, ImageFloat *luma, ImageFloat *chroma) {
+    int w = rgb->width, h = rgb->height;
+    int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    if (rgb->channels != 3 || luma->width != w || luma->height != h || luma->channels != 1 ||
+        chroma->width != cw || chroma->height != ch || chroma->channels != 2) {
+        return 0;
+    }
+    
+    size_t pixels = (size_t)w * h;
+    size_t chroma_pixels = (size_t)cw * ch;
+    const float *r = rgb->data, *g = rgb->data + pixels, *b = rgb->data + 2 * pixels;
+    int use_avx2 = cpu_has_avx2_fma();
+    
+    // Chaque ligne de chrominance couvre deux lignes de luminance
+    #pragma omp parallel for schedule(static)
+    for (int cy = 0; cy < ch; cy++) {
+        int y0 = 2 * cy;
+        int y1 = y0 + 1 < h ? y0 + 1 : y0;
+        const float *row0[3] = {r + (size_t)y0 * w, g + (size_t)y0 * w, b + (size_t)y0 * w};
+        const float *row1[3] = {r + (size_t)y1 * w, g + (size_t)y1 * w, b + (size_t)y1 * w};
+        
+        for (int y = y0; y <= y1; y++) {
+            const float *const *row = y == y0 ? row0 : row1;
+            float *out = luma->data + (size_t)y * w;
+            if (use_avx2) luma_row_avx2(row[0], row[1], row[2], w, out);
+            else luma_row_scalar(row[0], row[1], row[2], 0, w, out);
+        }
+        
+        chroma_row(row0, row1, w, chroma->data + (size_t)cy * cw,
+                   chroma->data + chroma_pixels + (size_t)cy * cw);
+    }
+    
+    return 1;
+}
+
+// ============================================================================
+// Y + Cb/Cr suréchantillonnées -> RGB
+// ============================================================================
+
+static void rgb_row_scalar(const float *y, const float *cb, const float *cr, int from, int n,
+                           float *r, float *g, float *b) {
+    for (int i = from; i < n; i++) {
+        r[i] = y[i] + R_CR * cr[i];
+        g[i] = y[i] + G_CB * cb[i] + G_CR * cr[i];
+        b[i] = y[i] + B_CB * cb[i];
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void rgb_row_avx2(const float *y, const float *cb, const float *cr, int n,
+                         float *r, float *g, float *b) {
+    const __m256 k_rcr = _mm256_set1_ps(R_CR), k_gcb = _mm256_set1_ps(G_CB);
+    const __m256 k_gcr = _mm256_set1_ps(G_CR), k_bcb = _mm256_set1_ps(B_CB);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 vy = _mm256_loadu_ps(y + i);
+        __m256 vcb = _mm256_loadu_ps(cb + i);
+        __m256 vcr = _mm256_loadu_ps(cr + i);
+        _mm256_storeu_ps(r + i, _mm256_fmadd_ps(k_rcr, vcr, vy));
+        _mm256_storeu_ps(g + i, _mm256_fmadd_ps(k_gcr, vcr, _mm256_fmadd_ps(k_gcb, vcb, vy)));
+        _mm256_storeu_ps(b + i, _mm256_fmadd_ps(k_bcb, vcb, vy));
+    }
+    rgb_row_scalar(y, cb, cr, i, n, r, g, b);
+}
+
+// Suréchantillonnage bilinéaire d'une ligne de chrominance à la ligne y de
+// l'image: l'échantillon (x, y) est au point (x / 2 - 1/4, y / 2 - 1/4) de
+// la grille à mi-résolution. v reçoit la ligne interpolée verticalement avec
+// une colonne répétée de chaque côté; out reçoit 2 * cw valeurs.
+static void upsample_row(const float *plane, int cw, int ch, int y, float *v, float *out) {
+    int j = y / 2;
+    int ja, jb;
+    float wa, wb;
+    if (y & 1) {
+        ja = j;
+        jb = j + 1 < ch ? j + 1 : ch - 1;
+        wa = 0.75f;
+        wb = 0.25f;
+    } else {
+        ja = j > 0 ? j - 1 : 0;
+        jb = j;
+        wa = 0.25f;
+        wb = 0.75f;
+    }
+    const float *a = plane + (size_t)ja * cw;
+    const float *b = plane + (size_t)jb * cw;
+    
+    #pragma omp simd
+    for (int cx = 0; cx < cw; cx++) {
+        v[cx + 1] = wa * a[cx] + wb * b[cx];
+    }
+    v[0] = v[1];
+    v[cw + 1] = v[cw];
+    
+    #pragma omp simd
+    for (int cx = 0; cx < cw; cx++) {
+        out[2 * cx] = 0.25f * v[cx] + 0.75f * v[cx + 1];
+        out[2 * cx + 1] = 0.75f * v[cx + 1] + 0.25f * v[cx + 2];
+    }
+}
+
+int luma_chroma_to_rgb(const ImageFloat *luma, const ImageFloat *chroma, ImageFloat *rgb) {
+    int w = luma->width, h = luma->height;
+    int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    if (luma->channels != 1 || chroma->width != cw || chroma->height != ch ||
+        chroma->channels != 2 || rgb->width != w || rgb->height != h || rgb->channels != 3) {
+        return 0;
+    }
+    
+    // Par thread: ligne verticale paddée + ligne suréchantillonnée, pour Cb et Cr
+    size_t v_len = (size_t)cw + 2;
+    size_t up_len = 2 * (size_t)cw;
+    size_t scratch_stride = 2 * (v_len + up_len);
+    float *scratch = (float *)pool_alloc(scratch_stride * omp_get_max_threads() * sizeof(float));
+    if (!scratch) return 0;
+    
+    size_t pixels = (size_t)w * h;
+    size_t chroma_pixels = (size_t)cw * ch;
+    float *r = rgb->data, *g = rgb->data + pixels, *b = rgb->data + 2 * pixels;
+    int use_avx2 = cpu_has_avx2_fma();
+    
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < h; y++) {
+        float *v = scratch + scratch_stride * omp_get_thread_num();
+        float *up_cb = v + v_len;
+        float *up_cr = up_cb + up_len;
+        upsample_row(chroma->data, cw, ch, y, v, up_cb);
+        upsample_row(chroma->data + chroma_pixels, cw, ch, y, v, up_cr);
+        
+        size_t offset = (size_t)y * w;
+        const float *yrow = luma->data + offset;
+        if (use_avx2) rgb_row_avx2(yrow, up_cb, up_cr, w, r + offset, g + offset, b + offset);
+        else rgb_row_scalar(yrow, up_cb, up_cr, 0, w, r + offset, g + offset, b + offset);
+    }
+    
+    pool_free(scratch);
+    return 1;
+}
+
+// ============================================================================
+// Débruitage
+// ============================================================================
+
+ImageFloat *denoise_luma_chroma(const ImageFloat *rgb, int kernel_size, float sigma) {
+    if (!rgb || rgb->channels != 3) return NULL;
+    
+    int w = rgb->width, h = rgb->height;
+    int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    int chroma_size = chroma_kernel_size(kernel_size);
+    
+    float *luma_kernel = create_gaussian_kernel_1d(kernel_size, sigma);
+    float *chroma_kernel = create_gaussian_kernel_1d(chroma_size, sigma * 0.5f);
+    ImageFloat *luma = create_image_float_uninit(w, h, 1);
+    ImageFloat *chroma = create_image_float_uninit(cw, ch, 2);
+    ImageFloat *luma_out = create_image_float_uninit(w, h, 1);
+    ImageFloat *chroma_out = create_image_float_uninit(cw, ch, 2);
+    ImageFloat *result = create_image_float_uninit(w, h, 3);
+    
+    int ok = luma_kernel && chroma_kernel && luma && chroma && luma_out && chroma_out &&
+             result &&
+             rgb_to_luma_chroma(rgb, luma, chroma) &&
+             convolve_separable_into(luma, luma_kernel, kernel_size, luma_out, NULL) &&
+             convolve_separable_into(chroma, chroma_kernel, chroma_size, chroma_out, NULL) &&
+             luma_chroma_to_rgb(luma_out, chroma_out, result);
+    
+    if (luma_kernel) mkl_free(luma_kernel);
+    if (chroma_kernel) mkl_free(chroma_kernel);
+    free_image_float(luma);
+    free_image_float(chroma);
+    free_image_float(luma_out);
+    free_image_float(chroma_out);
+    if (!ok) {
+        free_image_float(result);
+        return NULL;
+    }
+    return result;
+}
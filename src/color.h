@@ -0,0 +1,49 @@
+#ifndef COLOR_H
+#define COLOR_H
+
+#include "image.h"
+
+/**
+ * Débruitage luma/chrominance
+ * 
+ * L'image RGB est convertie en YCbCr (BT.601 pleine échelle, chrominance
+ * centrée sur 0). La luminance Y est filtrée à pleine résolution; Cb et Cr
+ * sont sous-échantillonnées 2x (moyenne 2x2, fusionnée avec la conversion),
+ * filtrées avec un noyau et un sigma divisés par deux, puis suréchantillonnées
+ * (bilinéaire, échantillons centrés) lors de la reconversion en RGB.
+ * Travail de convolution: 1 + 2/4 plans au lieu de 3.
+ * Les conversions de lignes utilisent AVX2/FMA si disponible.
+ */
+
+/**
+ * Taille du noyau appliqué aux plans de chrominance à mi-résolution
+ * (moitié de la taille luma, impaire, au moins 3)
+ */
+int chroma_kernel_size(int kernel_size);
+
+/**
+ * Convertit une image RGB planaire en luminance pleine résolution et
+ * chrominance à mi-résolution
+ * @param rgb: image à 3 canaux, width x height
+ * @param luma: [sortie] 1 canal, width x height
+ * @param chroma: [sortie] 2 canaux (Cb, Cr), (width + 1) / 2 x (height + 1) / 2
+ * @return: 1 si succès, 0 sinon (dimensions incompatibles)
+ */
+int rgb_to_luma_chroma(const ImageFloat *rgb, ImageFloat *luma, ImageFloat *chroma);
+
+/**
+ * Reconstruit l'image RGB, la chrominance étant suréchantillonnée à la volée
+ * @param rgb: [sortie] 3 canaux, dimensions de luma
+ * @return: 1 si succès, 0 sinon
+ */
+int luma_chroma_to_rgb(const ImageFloat *luma, const ImageFloat *chroma, ImageFloat *rgb);
+
+/**
+ * Filtre gaussien séparable sur Y (pleine résolution) et sur Cb/Cr
+ * (mi-résolution, noyau chroma_kernel_size, sigma / 2)
+ * @param rgb: image à 3 canaux
+ * @return: image RGB filtrée, ou NULL en cas d'erreur
+ */
+ImageFloat *denoise_luma_chroma(const ImageFloat *rgb, int kernel_size, float sigma);
+
+#endif // COLOR_H
@@ -0,0 +1,39 @@
+#include "denoise.h"
+#include "io.h"
+#include "pool.h"
+#include <omp.h>
+#include <stdatomic.h>
+
+// Nombre de denoise_init sans denoise_shutdown correspondant
+static atomic_int init_count = 0;
+
+int denoise_init(int num_threads) {
+    if (atomic_fetch_add(&init_count, 1) == 0) {
+        // Comme mkl_init, sans message: l'appelant a sa propre sortie
+        if (num_threads > 0) {
+            mkl_set_num_threads(num_threads);
+            omp_set_num_threads(num_threads);
+        }
+        set_io_quiet(1);
+    }
+    return mkl_get_max_threads() > 0;
+}
+
+void denoise_shutdown(void) {
+    // Sans effet au-delà du nombre d'initialisations
+    int count = atomic_load(&init_count);
+    while (count > 0 && !atomic_compare_exchange_weak(&init_count, &count, count - 1)) {
+    }
+    if (count == 1) {
+        pool_trim();
+        mkl_free_buffers();
+    }
+}
+
+const char *denoise_version(void) {
+    return DENOISE_VERSION;
+}
+
+int denoise_version_major(void) {
+    return DENOISE_VERSION_MAJOR;
+}
@@ -0,0 +1,80 @@
+#ifndef DENOISE_H
+#define DENOISE_H
+
+/**
+ * API C de la bibliothèque libdenoise (libdenoise.so / libdenoise.a)
+ * 
+ * En-tête unique pour appeler les moteurs dans le processus de l'appelant,
+ * sans lancer image_denoise ni passer par des fichiers: images planaires
+ * (image.h), noyaux gaussiens (filters.h), convolutions et espaces de
+ * travail (mkl_ops.h).
+ * 
+ * Utilisation:
+ *   denoise_init(0);
+ *   Kernel *k = create_gaussian_kernel(7, 2.0f);
+ *   ConvWorkspace *ws = create_conv_workspace();
+ *   convolve_fft_into(img, k, out, ws);      // à chaque image
+ *   ...
+ *   free_conv_workspace(ws);
+ *   free_kernel(k);
+ *   denoise_shutdown();
+ * 
+ * Compatibilité: la version majeure change quand une fonction ou une
+ * structure publique de ces trois en-têtes change de façon incompatible
+ * (soname libdenoise.so.<majeure>); la version mineure, quand une fonction
+ * est ajoutée. Un appelant lié dynamiquement vérifie au démarrage que
+ * denoise_version_major() vaut DENOISE_VERSION_MAJOR. Seules les fonctions
+ * de ces en-têtes (DENOISE_API) sont exportées par libdenoise.so.
+ * 
+ * Fils d'exécution: les moteurs peuvent être appelés depuis plusieurs
+ * threads à la fois, chacun avec son propre ConvWorkspace (un espace de
+ * travail n'est pas partagé entre appels simultanés).
+ */
+
+#define DENOISE_VERSION_MAJOR 1
+#define DENOISE_VERSION_MINOR 0
+#define DENOISE_VERSION_PATCH 0
+#define DENOISE_VERSION "1.0.0"
+
+// Les en-têtes des moteurs sont en C: liaison C pour un appelant C++
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "image.h"
+#include "filters.h"
+#include "mkl_ops.h"
+
+/**
+ * Initialise la bibliothèque: threads OpenMP/MKL des moteurs, messages
+ * d'entrées/sorties désactivés (set_io_quiet). Sans affichage.
+ * Appels imbriqués comptés: seul le premier configure les threads
+ * @param num_threads: threads des moteurs (0 = réglage MKL par défaut)
+ * @return: 1 si succès, 0 si MKL n'est pas utilisable
+ */
+DENOISE_API int denoise_init(int num_threads);
+
+/**
+ * Termine un denoise_init; au dernier appel, rend au système les tampons
+ * gardés en cache (pool d'images, tampons internes de MKL)
+ * Les images, noyaux et espaces de travail doivent être libérés avant
+ */
+DENOISE_API void denoise_shutdown(void);
+
+/**
+ * Version de la bibliothèque chargée (peut différer de celle de l'en-tête
+ * compilé par l'appelant)
+ * @return: chaîne "majeure.mineure.correctif"
+ */
+DENOISE_API const char *denoise_version(void);
+
+/**
+ * Version majeure de la bibliothèque chargée
+ */
+DENOISE_API int denoise_version_major(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DENOISE_H
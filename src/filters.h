@@ -1,6 +1,8 @@
 #ifndef FILTERS_H
 #define FILTERS_H
 
+#include "image.h"
+
 /**
  * Structure pour représenter un noyau de convolution 2D
  */
@@ -13,12 +15,12 @@ typedef struct {
 /**
  * Crée un noyau de convolution vide
  */
-Kernel *create_kernel(int size);
+DENOISE_API Kernel *create_kernel(int size);
 
 /**
  * Libère la mémoire d'un noyau
  */
-void free_kernel(Kernel *kernel);
+DENOISE_API void free_kernel(Kernel *kernel);
 
 /**
  * Crée un noyau gaussien 2D
@@ -28,7 +30,7 @@ void free_kernel(Kernel *kernel);
  * 
  * Formule: G(x,y,σ) = (1/(2πσ²)) * exp(-(x²+y²)/(2σ²))
  */
-Kernel *create_gaussian_kernel(int size, float sigma);
+DENOISE_API Kernel *create_gaussian_kernel(int size, float sigma);
 
 /**
  * Crée un noyau gaussien 1D (pour convolution séparable)
@@ -38,16 +40,16 @@ Kernel *create_gaussian_kernel(int size, float sigma);
  * 
  * Formule: G(x,σ) = (1/√(2πσ²)) * exp(-x²/(2σ²))
  */
-float *create_gaussian_kernel_1d(int size, float sigma);
+DENOISE_API float *create_gaussian_kernel_1d(int size, float sigma);
 
 /**
  * Affiche les valeurs d'un noyau (pour debug)
  */
-void print_kernel(const Kernel *kernel);
+DENOISE_API void print_kernel(const Kernel *kernel);
 
 /**
  * Affiche les valeurs d'un noyau 1D (pour debug)
  */
-void print_kernel_1d(const float *kernel, int size);
+DENOISE_API void print_kernel_1d(const float *kernel, int size);
 
 #endif // FILTERS_H
@@ -0,0 +1,195 @@
+#include "fixed_ops.h"
+#include "pool.h"
+#include <math.h>
+#include <omp.h>
+#include <stdlib.h>
+#include <immintrin.h>
+
+// Arrondis des deux décalages: Q14 -> Q7 puis Q7 * Q14 -> entier
+#define H_SHIFT (FIXED_KERNEL_BITS - FIXED_INTER_BITS)
+#define V_SHIFT (FIXED_KERNEL_BITS + FIXED_INTER_BITS)
+
+void quantize_kernel_q14(const float *kernel_1d, int kernel_size, int16_t *taps) {
+    int sum = 0;
+    for (int k = 0; k < kernel_size; k++) {
+        taps[k] = (int16_t)lrintf(kernel_1d[k] * (float)(1 << FIXED_KERNEL_BITS));
+        sum += taps[k];
+    }
+    taps[kernel_size / 2] += (int16_t)((1 << FIXED_KERNEL_BITS) - sum);
+}
+
+static int cpu_has_avx2(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2");
+    }
+    return cached;
+}
+
+// ============================================================================
+// Passe horizontale: ligne u8 paddée (int16) -> ligne intermédiaire Q7
+// ============================================================================
+
+static void row_h_scalar(const int16_t *pad, int from, int length, int step,
+                         const int16_t *taps, int kernel_size, int16_t *out) {
+    for (int i = from; i < length; i++) {
+        int32_t acc = 1 << (H_SHIFT - 1);
+        for (int k = 0; k < kernel_size; k++) {
+            acc += (int32_t)pad[i + k * step] * taps[k];
+        }
+        out[i] = (int16_t)(acc >> H_SHIFT);
+    }
+}
+
+// 16 échantillons par itération; les coefficients sont traités par paires
+// (k, k+1): unpack des deux vecteurs de pixels puis madd sur 32 bits
+__attribute__((target("avx2")))
+static void row_h_avx2(const int16_t *pad, int length, int step,
+                       const int16_t *taps, const int32_t *pairs, int kernel_size,
+                       int16_t *out) {
+    const __m256i round = _mm256_set1_epi32(1 << (H_SHIFT - 1));
+    int i = 0;
+    
+    for (; i + 16 <= length; i += 16) {
+        __m256i acc_lo = round, acc_hi = round;
+        for (int k = 0; k < kernel_size; k += 2) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)(pad + i + k * step));
+            // Nombre impair de coefficients: le dernier est apparié à un poids nul
+            __m256i b = k + 1 < kernel_size
+                      ? _mm256_loadu_si256((const __m256i *)(pad + i + (k + 1) * step)) : a;
+            __m256i w = _mm256_set1_epi32(pairs[k / 2]);
+            acc_lo = _mm256_add_epi32(acc_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), w));
+            acc_hi = _mm256_add_epi32(acc_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), w));
+        }
+        // unpacklo/hi et packs opèrent par voie de 128 bits: l'ordre est rétabli
+        __m256i r = _mm256_packs_epi32(_mm256_srai_epi32(acc_lo, H_SHIFT),
+                                       _mm256_srai_epi32(acc_hi, H_SHIFT));
+        _mm256_storeu_si256((__m256i *)(out + i), r);
+    }
+    row_h_scalar(pad, i, length, step, taps, kernel_size, out);
+}
+
+// ============================================================================
+// Passe verticale: lignes intermédiaires Q7 -> ligne u8
+// ============================================================================
+
+static inline const int16_t *inter_row(const int16_t *inter, int y, int height, int length) {
+    y = y < 0 ? 0 : (y >= height ? height - 1 : y);
+    return inter + (size_t)y * length;
+}
+
+static void row_v_scalar(const int16_t *inter, int y, int height, int from, int length,
+                         const int16_t *taps, int kernel_size, unsigned char *out) {
+    int half_size = kernel_size / 2;
+    for (int i = from; i < length; i++) {
+        int32_t acc = 1 << (V_SHIFT - 1);
+        for (int k = 0; k < kernel_size; k++) {
+            acc += (int32_t)inter_row(inter, y + k - half_size, height, length)[i] * taps[k];
+        }
+        acc >>= V_SHIFT;
+        out[i] = (unsigned char)(acc < 0 ? 0 : (acc > 255 ? 255 : acc));
+    }
+}
+
+__attribute__((target("avx2")))
+static void row_v_avx2(const int16_t *inter, int y, int height, int length,
+                       const int16_t *taps, const int32_t *pairs, int kernel_size,
+                       unsigned char *out) {
+    const __m256i round = _mm256_set1_epi32(1 << (V_SHIFT - 1));
+    int half_size = kernel_size / 2;
+    int i = 0;
+    
+    for (; i + 16 <= length; i += 16) {
+        __m256i acc_lo = round, acc_hi = round;
+        for (int k = 0; k < kernel_size; k += 2) {
+            const int16_t *ra = inter_row(inter, y + k - half_size, height, length);
+            __m256i a = _mm256_loadu_si256((const __m256i *)(ra + i));
+            __m256i b = a;
+            if (k + 1 < kernel_size) {
+                const int16_t *rb = inter_row(inter, y + k + 1 - half_size, height, length);
+                b = _mm256_loadu_si256((const __m256i *)(rb + i));
+            }
+            __m256i w = _mm256_set1_epi32(pairs[k / 2]);
+            acc_lo = _mm256_add_epi32(acc_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), w));
+            acc_hi = _mm256_add_epi32(acc_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), w));
+        }
+        __m256i r = _mm256_packs_epi32(_mm256_srai_epi32(acc_lo, V_SHIFT),
+                                       _mm256_srai_epi32(acc_hi, V_SHIFT));
+        // int16 -> u8 saturé, puis regroupement des 16 octets utiles
+        r = _mm256_permute4x64_epi64(_mm256_packus_epi16(r, r), 0x08);
+        _mm_storeu_si128((__m128i *)(out + i), _mm256_castsi256_si128(r));
+    }
+    row_v_scalar(inter, y, height, i, length, taps, kernel_size, out);
+}
+
+// ============================================================================
+// Moteur
+// ============================================================================
+
+int convolve_separable_fixed(const unsigned char *src, int width, int height, int channels,
+                             const float *kernel_1d, int kernel_size, unsigned char *dst) {
+    if (!src || !dst || width < 1 || height < 1 || channels < 1 || kernel_size < 1) return 0;
+    
+    int half_size = kernel_size / 2;
+    int length = width * channels;
+    size_t pad_stride = ((size_t)(width + 2 * half_size) * channels + 15) & ~(size_t)15;
+    int num_pairs = (kernel_size + 1) / 2;
+    
+    int16_t *taps = (int16_t *)malloc(kernel_size * sizeof(int16_t));
+    int32_t *pairs = (int32_t *)malloc(num_pairs * sizeof(int32_t));
+    int16_t *inter = (int16_t *)pool_alloc((size_t)height * length * sizeof(int16_t));
+    int16_t *pads = (int16_t *)pool_alloc(pad_stride * omp_get_max_threads() * sizeof(int16_t));
+    if (!taps || !pairs || !inter || !pads) {
+        free(taps);
+        free(pairs);
+        pool_free(inter);
+        pool_free(pads);
+        return 0;
+    }
+    
+    quantize_kernel_q14(kernel_1d, kernel_size, taps);
+    // Paires (w[k], w[k+1]) dans un mot de 32 bits, pour madd_epi16
+    for (int p = 0; p < num_pairs; p++) {
+        uint16_t lo = (uint16_t)taps[2 * p];
+        uint16_t hi = 2 * p + 1 < kernel_size ? (uint16_t)taps[2 * p + 1] : 0;
+        pairs[p] = (int32_t)((uint32_t)lo | ((uint32_t)hi << 16));
+    }
+    
+    int use_avx2 = cpu_has_avx2();
+    
+    // Première passe: horizontale, ligne u8 élargie en int16 avec bords répliqués
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; y++) {
+        int16_t *pad = pads + pad_stride * omp_get_thread_num();
+        const unsigned char *row = src + (size_t)y * length;
+        
+        for (int i = 0; i < length; i++) {
+            pad[half_size * channels + i] = row[i];
+        }
+        for (int p = 0; p < half_size; p++) {
+            for (int ch = 0; ch < channels; ch++) {
+                pad[p * channels + ch] = row[ch];
+                pad[(half_size + width + p) * channels + ch] = row[(width - 1) * channels + ch];
+            }
+        }
+        
+        int16_t *out = inter + (size_t)y * length;
+        if (use_avx2) row_h_avx2(pad, length, channels, taps, pairs, kernel_size, out);
+        else row_h_scalar(pad, 0, length, channels, taps, kernel_size, out);
+    }
+    
+    // Deuxième passe: verticale, écrite directement en u8
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; y++) {
+        unsigned char *out = dst + (size_t)y * length;
+        if (use_avx2) row_v_avx2(inter, y, height, length, taps, pairs, kernel_size, out);
+        else row_v_scalar(inter, y, height, 0, length, taps, kernel_size, out);
+    }
+    
+    free(taps);
+    free(pairs);
+    pool_free(inter);
+    pool_free(pads);
+    return 1;
+}
@@ -0,0 +1,43 @@
+#ifndef FIXED_OPS_H
+#define FIXED_OPS_H
+
+#include <stdint.h>
+
+/**
+ * Convolution séparable en virgule fixe pour les images 8 bits
+ * 
+ * Les pixels restent en u8 (entrelacés, tels que décodés par stb_image) et
+ * les coefficients du noyau gaussien sont quantifiés en Q14 (somme exacte de
+ * 2^14). La passe horizontale accumule sur 32 bits et stocke un plan
+ * intermédiaire int16 en Q7; la passe verticale produit directement des u8.
+ * Les produits sont calculés par paires de coefficients avec
+ * _mm256_madd_epi16 (AVX2, choisi à l'exécution) ou en scalaire: les deux
+ * chemins donnent exactement le même résultat.
+ * 
+ * Écart au calcul flottant arrondi: au plus 1 LSB.
+ */
+
+#define FIXED_KERNEL_BITS 14    // Coefficients en Q14
+#define FIXED_INTER_BITS 7      // Plan intermédiaire en Q7 (255 << 7 tient sur int16)
+
+/**
+ * Quantifie un noyau 1D normalisé en Q14
+ * L'erreur d'arrondi est reportée sur le coefficient central pour que la
+ * somme vaille exactement 1 << FIXED_KERNEL_BITS
+ * @param kernel_1d: noyau flottant (somme 1)
+ * @param taps: [sortie] kernel_size coefficients entiers
+ */
+void quantize_kernel_q14(const float *kernel_1d, int kernel_size, int16_t *taps);
+
+/**
+ * Convolution séparable u8 -> u8 sur pixels entrelacés
+ * Les canaux n'ont pas besoin d'être séparés: les voisins horizontaux d'un
+ * échantillon sont à un multiple de channels octets
+ * @param src: pixels entrelacés width x height x channels
+ * @param dst: destination de même taille (distincte de src)
+ * @return: 1 si succès, 0 sinon
+ */
+int convolve_separable_fixed(const unsigned char *src, int width, int height, int channels,
+                             const float *kernel_1d, int kernel_size, unsigned char *dst);
+
+#endif // FIXED_OPS_H
@@ -0,0 +1,323 @@
+// mmap, pwrite, ftruncate, madvise ne sont pas exposés en C11 strict
+#define _GNU_SOURCE
+
+#include "float_io.h"
+#include "io.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// En-tête du format planaire: 64 octets, pour que les plans qui le suivent
+// restent alignés sur une ligne de cache dans la projection du fichier
+#define PLANAR_HEADER_SIZE 64
+#define PLANAR_ALIGN 64
+static const char PLANAR_MAGIC[8] = {'F', 'P', 'L', 'A', 'N', 'A', 'R', '1'};
+
+static int host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const unsigned char *)&probe == 1;
+}
+
+static uint32_t read_u32_le(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void write_u32_le(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+// Lit un float32 stocké avec le boutisme donné
+static inline float load_float(const unsigned char *p, int swap) {
+    uint32_t bits;
+    memcpy(&bits, p, sizeof(bits));
+    if (swap) bits = __builtin_bswap32(bits);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static const char *file_extension(const char *filename) {
+    const char *dot = strrchr(filename, '.');
+    const char *slash = strrchr(filename, '/');
+    return dot && (!slash || dot > slash) ? dot + 1 : "";
+}
+
+int is_float_image_file(const char *filename) {
+    const char *ext = file_extension(filename);
+    return strcasecmp(ext, "pfm") == 0 || strcasecmp(ext, "planar") == 0;
+}
+
+// Libération d'une image enveloppant la projection d'un fichier
+static void unmap_release(void *base, size_t bytes) {
+    munmap(base, bytes);
+}
+
+// Projette un fichier entier en lecture (copie sur écriture privée)
+static unsigned char *map_file(const char *filename, size_t *bytes) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Erreur: impossible d'ouvrir '%s'\n", filename);
+        return NULL;
+    }
+    
+    struct stat st;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Erreur: impossible de projeter '%s' en mémoire\n", filename);
+        return NULL;
+    }
+    *bytes = (size_t)st.st_size;
+    return (unsigned char *)base;
+}
+
+// Format planaire: enveloppe la projection si possible, sinon copie
+static ImageFloat *load_planar(const char *filename, unsigned char *base, size_t bytes,
+                               int *mapped) {
+    if (bytes < PLANAR_HEADER_SIZE || memcmp(base, PLANAR_MAGIC, sizeof(PLANAR_MAGIC)) != 0) {
+        fprintf(stderr, "Erreur: '%s' n'est pas un fichier planaire (FPLANAR1)\n", filename);
+        munmap(base, bytes);
+        return NULL;
+    }
+    
+    uint32_t width = read_u32_le(base + 8);
+    uint32_t height = read_u32_le(base + 12);
+    uint32_t channels = read_u32_le(base + 16);
+    uint32_t offset = read_u32_le(base + 20);
+    size_t plane_bytes = 0;
+    if (!image_plane_bytes(width, height, channels, sizeof(float), &plane_bytes) ||
+        channels > 4 || offset < PLANAR_HEADER_SIZE || offset > bytes ||
+        bytes - offset < plane_bytes) {
+        fprintf(stderr, "Erreur: en-tête planaire invalide ou fichier tronqué '%s'\n", filename);
+        munmap(base, bytes);
+        return NULL;
+    }
+    
+    // Sans copie: plans alignés (la projection commence sur une page) et
+    // stockés dans le boutisme de la machine
+    if (offset % PLANAR_ALIGN == 0 && host_is_little_endian()) {
+        // Les moteurs liront tout le fichier: lecture anticipée par le noyau
+        madvise(base, bytes, MADV_WILLNEED);
+        ImageFloat *img = image_wrap_external((float *)(base + offset), (int)width, (int)height,
+                                              (int)channels, base, bytes, unmap_release);
+        if (!img) munmap(base, bytes);
+        if (img && mapped) *mapped = 1;
+        return img;
+    }
+    
+    ImageFloat *img = create_image_float_uninit((int)width, (int)height, (int)channels);
+    if (img) {
+        const unsigned char *src = base + offset;
+        size_t total = (size_t)width * height * channels;
+        int swap = !host_is_little_endian();
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < total; i++) {
+            img->data[i] = load_float(src + i * sizeof(float), swap);
+        }
+    }
+    munmap(base, bytes);
+    return img;
+}
+
+// PFM: désentrelacement et retournement vertical vers des plans du pool
+static ImageFloat *load_pfm(const char *filename, unsigned char *base, size_t bytes) {
+    // En-tête texte: "PF"|"Pf", largeur, hauteur, échelle, un blanc, données
+    char header[128];
+    size_t n = bytes < sizeof(header) - 1 ? bytes : sizeof(header) - 1;
+    memcpy(header, base, n);
+    header[n] = '\0';
+    
+    char magic[3];
+    int width = 0, height = 0, consumed = 0;
+    float scale = 0.0f;
+    if (sscanf(header, "%2s %d %d %f%n", magic, &width, &height, &scale, &consumed) != 4 ||
+        (strcmp(magic, "PF") != 0 && strcmp(magic, "Pf") != 0) ||
+        width <= 0 || height <= 0 || scale == 0.0f || (size_t)consumed >= n) {
+        fprintf(stderr, "Erreur: en-tête PFM invalide dans '%s'\n", filename);
+        munmap(base, bytes);
+        return NULL;
+    }
+    
+    int c = magic[1] == 'F' ? 3 : 1;
+    size_t offset = (size_t)consumed + 1;
+    size_t row_bytes = (size_t)width * c * sizeof(float);
+    size_t data_bytes = 0;
+    if (!image_plane_bytes((uint64_t)width, (uint64_t)height, (uint64_t)c, sizeof(float),
+                           &data_bytes)) {
+        fprintf(stderr, "Erreur: dimensions PFM trop grandes dans '%s'\n", filename);
+        munmap(base, bytes);
+        return NULL;
+    }
+    if (bytes - offset < data_bytes) {
+        fprintf(stderr, "Erreur: fichier PFM tronqué '%s'\n", filename);
+        munmap(base, bytes);
+        return NULL;
+    }
+    
+    // Échelle négative: little-endian
+    int swap = (scale < 0.0f) != host_is_little_endian();
+    madvise(base, bytes, MADV_SEQUENTIAL);
+    
+    ImageFloat *img = create_image_float_uninit(width, height, c);
+    if (img) {
+        size_t plane_size = (size_t)width * height;
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < height; y++) {
+            // Les lignes du fichier vont de bas en haut
+            const unsigned char *src = base + offset + (size_t)(height - 1 - y) * row_bytes;
+            for (int ch = 0; ch < c; ch++) {
+                float *dst = img->data + ch * plane_size + (size_t)y * width;
+                for (int x = 0; x < width; x++) {
+                    dst[x] = load_float(src + ((size_t)x * c + ch) * sizeof(float), swap);
+                }
+            }
+        }
+    }
+    munmap(base, bytes);
+    return img;
+}
+
+ImageFloat *load_image_float(const char *filename, int *mapped) {
+    if (mapped) *mapped = 0;
+    
+    size_t bytes = 0;
+    unsigned char *base = map_file(filename, &bytes);
+    if (!base) return NULL;
+    
+    ImageFloat *img = strcasecmp(file_extension(filename), "pfm") == 0
+                      ? load_pfm(filename, base, bytes)
+                      : load_planar(filename, base, bytes, mapped);
+    if (img && !io_is_quiet()) {
+        printf("Image chargée: %s (%dx%d, %d canaux, float32)\n", filename,
+               img->width, img->height, img->channels);
+    }
+    return img;
+}
+
+// pwrite complet (les écritures partielles sont reprises)
+static int pwrite_all(int fd, const void *data, size_t bytes, off_t offset) {
+    const unsigned char *p = (const unsigned char *)data;
+    while (bytes > 0) {
+        ssize_t written = pwrite(fd, p, bytes, offset);
+        if (written <= 0) return 0;
+        p += written;
+        bytes -= (size_t)written;
+        offset += written;
+    }
+    return 1;
+}
+
+static int save_planar(const char *filename, const ImageFloat *img) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 0;
+    
+    unsigned char header[PLANAR_HEADER_SIZE] = {0};
+    memcpy(header, PLANAR_MAGIC, sizeof(PLANAR_MAGIC));
+    write_u32_le(header + 8, (uint32_t)img->width);
+    write_u32_le(header + 12, (uint32_t)img->height);
+    write_u32_le(header + 16, (uint32_t)img->channels);
+    write_u32_le(header + 20, PLANAR_HEADER_SIZE);
+    int ok = pwrite_all(fd, header, sizeof(header), 0);
+    
+    size_t plane_size = (size_t)img->width * img->height;
+    size_t plane_bytes = plane_size * sizeof(float);
+    float *swapped = host_is_little_endian() ? NULL : (float *)malloc(plane_bytes);
+    
+    // Un pwrite par plan entier, directement depuis les plans de l'image
+    for (int ch = 0; ok && ch < img->channels; ch++) {
+        const float *plane = img->data + ch * plane_size;
+        if (!host_is_little_endian()) {
+            if (!swapped) {
+                ok = 0;
+                break;
+            }
+            for (size_t i = 0; i < plane_size; i++) {
+                swapped[i] = load_float((const unsigned char *)(plane + i), 1);
+            }
+            plane = swapped;
+        }
+        ok = pwrite_all(fd, plane, plane_bytes,
+                        (off_t)PLANAR_HEADER_SIZE + (off_t)ch * (off_t)plane_bytes);
+    }
+    
+    free(swapped);
+    if (close(fd) != 0) ok = 0;
+    return ok;
+}
+
+static int save_pfm(const char *filename, const ImageFloat *img) {
+    if (img->channels != 1 && img->channels != 3) {
+        fprintf(stderr, "Erreur: PFM demande 1 ou 3 canaux (%d)\n", img->channels);
+        return 0;
+    }
+    
+    // Données dans le boutisme de la machine: échelle -1 (LE) ou 1 (BE)
+    char header[64];
+    int header_len = snprintf(header, sizeof(header), "%s\n%d %d\n%s\n",
+                              img->channels == 3 ? "PF" : "Pf", img->width, img->height,
+                              host_is_little_endian() ? "-1.0" : "1.0");
+    int c = img->channels, width = img->width, height = img->height;
+    size_t row_floats = (size_t)width * c;
+    size_t bytes = (size_t)header_len + row_floats * height * sizeof(float);
+    
+    int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 0;
+    void *base = MAP_FAILED;
+    if (ftruncate(fd, (off_t)bytes) == 0) {
+        base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+    
+    unsigned char *dst = (unsigned char *)base;
+    memcpy(dst, header, (size_t)header_len);
+    dst += header_len;
+    
+    // Entrelacement direct dans les pages du fichier, lignes de bas en haut
+    // (l'en-tête n'étant pas aligné, chaque float est écrit par memcpy)
+    size_t plane_size = (size_t)width * height;
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; y++) {
+        unsigned char *row = dst + (size_t)(height - 1 - y) * row_floats * sizeof(float);
+        for (int ch = 0; ch < c; ch++) {
+            const float *src = img->data + ch * plane_size + (size_t)y * width;
+            for (int x = 0; x < width; x++) {
+                memcpy(row + ((size_t)x * c + ch) * sizeof(float), &src[x], sizeof(float));
+            }
+        }
+    }
+    
+    return munmap(base, bytes) == 0;
+}
+
+int save_image_float(const char *filename, const ImageFloat *img) {
+    if (!img) return 0;
+    
+    const char *ext = file_extension(filename);
+    int ok;
+    if (strcasecmp(ext, "pfm") == 0) {
+        ok = save_pfm(filename, img);
+    } else if (strcasecmp(ext, "planar") == 0) {
+        ok = save_planar(filename, img);
+    } else {
+        fprintf(stderr, "Erreur: format flottant inconnu '%s' (.pfm ou .planar)\n", filename);
+        return 0;
+    }
+    
+    if (!ok) fprintf(stderr, "Erreur: impossible de sauvegarder '%s'\n", filename);
+    else if (!io_is_quiet()) printf("Image sauvegardée: %s (float32)\n", filename);
+    return ok;
+}
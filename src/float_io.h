@@ -0,0 +1,47 @@
+#ifndef FLOAT_IO_H
+#define FLOAT_IO_H
+
+#include "image.h"
+
+/**
+ * Entrées / sorties flottantes sans conversion u8 (fichiers projetés en mémoire)
+ * 
+ * Deux formats, choisis par l'extension du fichier:
+ * - .pfm (Portable Float Map): "PF" (RGB) ou "Pf" (gris), pixels float32
+ *   entrelacés, lignes de bas en haut, boutisme donné par le signe de l'échelle;
+ * - .planar: en-tête de 64 octets puis plans float32 little-endian, dans
+ *   l'ordre de ImageFloat:
+ *     octets 0-7   "FPLANAR1"
+ *     octets 8-23  largeur, hauteur, canaux, début des données (uint32 LE)
+ *     octets 24-63 réservés (zéros)
+ * 
+ * Les fichiers sont lus par mmap. Un fichier .planar dont les données
+ * commencent à un multiple de 64 octets est enveloppé tel quel
+ * (image_wrap_external): les plans de l'image sont les pages du fichier,
+ * chargées à la demande par le noyau, sans aucune copie. La projection est
+ * privée (MAP_PRIVATE): modifier l'image ne modifie pas le fichier.
+ * Les valeurs sont celles du pipeline (échelle 0-255), sans normalisation.
+ */
+
+/**
+ * Indique si le fichier est un format flottant (.pfm ou .planar)
+ */
+int is_float_image_file(const char *filename);
+
+/**
+ * Charge une image .pfm ou .planar
+ * @param mapped: [sortie] 1 si l'image est la projection du fichier, sans
+ *                copie; 0 si les pixels ont été convertis (peut être NULL)
+ * @return: image planaire, ou NULL en cas d'erreur
+ */
+ImageFloat *load_image_float(const char *filename, int *mapped);
+
+/**
+ * Sauvegarde une image .pfm ou .planar, valeurs telles quelles
+ * PFM: projection partagée du fichier remplie en parallèle (1 ou 3 canaux);
+ * planaire: en-tête puis un pwrite par plan entier (tout nombre de canaux)
+ * @return: 1 si succès, 0 sinon
+ */
+int save_image_float(const char *filename, const ImageFloat *img);
+
+#endif // FLOAT_IO_H
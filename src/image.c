@@ -1,4 +1,5 @@
 #include "image.h"
+#include "pool.h"
 #if __has_include(<mkl.h>)
 #  include <mkl.h>
 #elif __has_include(<mkl/mkl.h>)
@@ -6,12 +7,67 @@
 #else
 #  error "MKL header not found"
 #endif
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
-#include <time.h>
+#include <stdatomic.h>
+#include <omp.h>
+#include <immintrin.h>
 
-ImageFloat *create_image_float(int width, int height, int channels) {
+// Détection à l'exécution d'AVX2 + FMA
+static int cpu_has_avx2_fma(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    return cached;
+}
+
+/**
+ * Tampon de pixels avec compteur de références
+ * Libéré (rendu au pool) lorsque la dernière image qui le référence est libérée
+ */
+struct ImageBuffer {
+    float *data;            // Plans de l'image (tampon du pool)
+    size_t bytes;           // Taille du tampon
+    atomic_int refcount;    // Nombre d'images partageant ce tampon
+    // Tampon externe (image_wrap_external): libéré par release(base, base_bytes)
+    void *base;
+    size_t base_bytes;
+    void (*release)(void *base, size_t bytes);
+};
+
+// Crée un tampon non initialisé de la taille demandée
+static ImageBuffer *buffer_create(size_t bytes) {
+    ImageBuffer *buffer = (ImageBuffer *)malloc(sizeof(ImageBuffer));
+    if (!buffer) return NULL;
+    
+    buffer->data = (float *)pool_alloc(bytes);
+    if (!buffer->data) {
+        free(buffer);
+        return NULL;
+    }
+    
+    buffer->bytes = bytes;
+    buffer->base = NULL;
+    buffer->base_bytes = 0;
+    buffer->release = NULL;
+    atomic_init(&buffer->refcount, 1);
+    return buffer;
+}
+
+// Retire une référence, libère le tampon à la dernière
+static void buffer_release(ImageBuffer *buffer) {
+    if (buffer && atomic_fetch_sub(&buffer->refcount, 1) == 1) {
+        if (buffer->release) buffer->release(buffer->base, buffer->base_bytes);
+        else pool_free(buffer->data);
+        free(buffer);
+    }
+}
+
+ImageFloat *create_image_float_uninit(int width, int height, int channels) {
     ImageFloat *img = (ImageFloat *)malloc(sizeof(ImageFloat));
     if (!img) return NULL;
     
@@ -19,132 +75,923 @@ ImageFloat *create_image_float(int width, int height, int channels) {
     img->height = height;
     img->channels = channels;
     
-    // Allocation alignée sur 64 octets pour AVX-512
+    // Tampon recyclé du pool, aligné sur 64 octets pour AVX-512
     size_t total_pixels = (size_t)width * height * channels;
-    img->data = (float *)mkl_malloc(total_pixels * sizeof(float), 64);
+    img->buffer = buffer_create(total_pixels * sizeof(float));
     
-    if (!img->data) {
+    if (!img->buffer) {
         free(img);
         return NULL;
     }
     
-    // Initialisation à zéro
-    memset(img->data, 0, total_pixels * sizeof(float));
+    img->data = img->buffer->data;
+    return img;
+}
+
+ImageFloat *image_wrap_external(float *data, int width, int height, int channels,
+                                void *base, size_t base_bytes,
+                                void (*release)(void *base, size_t bytes)) {
+    ImageFloat *img = (ImageFloat *)malloc(sizeof(ImageFloat));
+    ImageBuffer *buffer = (ImageBuffer *)malloc(sizeof(ImageBuffer));
+    if (!img || !buffer) {
+        free(img);
+        free(buffer);
+        return NULL;
+    }
+    
+    buffer->data = data;
+    buffer->bytes = (size_t)width * height * channels * sizeof(float);
+    buffer->base = base;
+    buffer->base_bytes = base_bytes;
+    buffer->release = release;
+    atomic_init(&buffer->refcount, 1);
+    
+    img->data = data;
+    img->width = width;
+    img->height = height;
+    img->channels = channels;
+    img->buffer = buffer;
+    return img;
+}
+
+int image_plane_bytes(uint64_t width, uint64_t height, uint64_t channels, size_t sample_bytes,
+                      size_t *bytes) {
+    // Chaque produit est borné par division avant d'être calculé
+    if (width == 0 || height == 0 || channels == 0 || sample_bytes == 0) return 0;
+    if (width > INT_MAX || height > INT_MAX / width) return 0;
+    uint64_t pixels = width * height;
+    if (channels > INT_MAX / pixels) return 0;
+    uint64_t samples = pixels * channels;
+    if (samples > SIZE_MAX / sample_bytes) return 0;
+    *bytes = (size_t)samples * sample_bytes;
+    return 1;
+}
+
+ImageFloat *create_image_float(int width, int height, int channels) {
+    ImageFloat *img = create_image_float_uninit(width, height, channels);
+    if (!img) return NULL;
+    
+    // Initialisation à zéro en parallèle, par bandes de lignes (first-touch NUMA):
+    // le découpage statique est celui des moteurs de convolution, chaque page est
+    // donc placée sur le nœud du thread qui traitera ensuite ces lignes
+    size_t pixels = (size_t)width * height;
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; y++) {
+        for (int c = 0; c < channels; c++) {
+            memset(img->data + c * pixels + (size_t)y * width, 0, width * sizeof(float));
+        }
+    }
     
     return img;
 }
 
 void free_image_float(ImageFloat *img) {
     if (img) {
-        if (img->data) {
-            mkl_free(img->data);
-        }
+        buffer_release(img->buffer);
         free(img);
     }
 }
 
+// Conversion scalaire d'une ligne: canal le plus interne
+static void deinterleave_row_scalar(const unsigned char *src, int n, int c,
+                                    float *const *dst) {
+    for (int x = 0; x < n; x++) {
+        for (int ch = 0; ch < c; ch++) {
+            dst[ch][x] = (float)src[x * c + ch];
+        }
+    }
+}
+
+// Élargit 8 octets u8 en 8 float
+__attribute__((target("avx2")))
+static inline void widen8_store(__m128i bytes, float *dst) {
+    _mm256_storeu_ps(dst, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)));
+}
+
+// Séparation des canaux par pshufb puis élargissement u8 -> float,
+// 16 pixels par itération (RGB, gris) ou 8 (RGBA)
+__attribute__((target("avx2")))
+static void deinterleave_row_avx2(const unsigned char *src, int n, int c,
+                                  float *const *dst) {
+    int x = 0;
+    
+    if (c == 1) {
+        for (; x + 16 <= n; x += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(src + x));
+            widen8_store(v, dst[0] + x);
+            widen8_store(_mm_srli_si128(v, 8), dst[0] + x + 8);
+        }
+    } else if (c == 3) {
+        // Masques: octets du canal ch dans chacun des 3 blocs de 16 octets
+        const __m128i m[3][3] = {
+            {_mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+             _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1),
+             _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)},
+            {_mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+             _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1),
+             _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)},
+            {_mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+             _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1),
+             _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)},
+        };
+        
+        for (; x + 16 <= n; x += 16) {
+            const unsigned char *p = src + (size_t)x * 3;
+            __m128i a = _mm_loadu_si128((const __m128i *)p);
+            __m128i b = _mm_loadu_si128((const __m128i *)(p + 16));
+            __m128i d = _mm_loadu_si128((const __m128i *)(p + 32));
+            for (int ch = 0; ch < 3; ch++) {
+                __m128i v = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m[ch][0]),
+                                                      _mm_shuffle_epi8(b, m[ch][1])),
+                                         _mm_shuffle_epi8(d, m[ch][2]));
+                widen8_store(v, dst[ch] + x);
+                widen8_store(_mm_srli_si128(v, 8), dst[ch] + x + 8);
+            }
+        }
+    } else if (c == 4) {
+        // Par voie: RGBA x4 -> R0-3 G0-3 B0-3 A0-3, puis regroupement des deux voies
+        const __m256i group = _mm256_setr_epi8(
+            0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+            0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        
+        for (; x + 8 <= n; x += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(src + (size_t)x * 4));
+            v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, group), order);
+            __m128i rg = _mm256_castsi256_si128(v);
+            __m128i ba = _mm256_extracti128_si256(v, 1);
+            widen8_store(rg, dst[0] + x);
+            widen8_store(_mm_srli_si128(rg, 8), dst[1] + x);
+            widen8_store(ba, dst[2] + x);
+            widen8_store(_mm_srli_si128(ba, 8), dst[3] + x);
+        }
+    }
+    
+    if (x < n) {
+        float *tail[4];
+        for (int ch = 0; ch < c; ch++) tail[ch] = dst[ch] + x;
+        deinterleave_row_scalar(src + (size_t)x * c, n - x, c, tail);
+    }
+}
+
+void deinterleave_row(const unsigned char *src, int n, int c, float *const *dst) {
+    static int use_avx2 = -1;
+    if (use_avx2 < 0) {
+        __builtin_cpu_init();
+        use_avx2 = __builtin_cpu_supports("avx2");
+    }
+    
+    if (use_avx2 && (c == 1 || c == 3 || c == 4)) deinterleave_row_avx2(src, n, c, dst);
+    else deinterleave_row_scalar(src, n, c, dst);
+}
+
 ImageFloat *interleaved_to_planar(unsigned char *data, int w, int h, int c) {
-    ImageFloat *img = create_image_float(w, h, c);
+    ImageROI full = {0, 0, w, h};
+    return interleaved_to_planar_roi(data, w, h, c, &full);
+}
+
+ImageFloat *interleaved_to_planar_roi(const unsigned char *data, int w, int h, int c,
+                                      const ImageROI *roi) {
+    (void)h;
+    ImageFloat *img = create_image_float_uninit(roi->width, roi->height, c);
     if (!img) return NULL;
     
-    size_t pixels = (size_t)w * h;
+    size_t pixels = (size_t)roi->width * roi->height;
     
-    // Conversion entrelacé -> planaire
+    // Conversion entrelacé -> planaire, lignes réparties entre les threads
     // Entrée: RGBRGBRGB... (data[i*c + ch])
     // Sortie: RRR...GGG...BBB... (img->data[ch*pixels + i])
-    for (size_t i = 0; i < pixels; i++) {
+    // Seules les lignes [roi->y, roi->y + roi->height) de la fenêtre sont lues
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < roi->height; y++) {
+        const unsigned char *row = data + ((size_t)(roi->y + y) * w + roi->x) * c;
+        float *dst[c];
         for (int ch = 0; ch < c; ch++) {
-            img->data[ch * pixels + i] = (float)data[i * c + ch];
+            dst[ch] = img->data + ch * pixels + (size_t)y * roi->width;
         }
+        deinterleave_row(row, roi->width, c, dst);
     }
     
     return img;
 }
 
+int roi_clip(ImageROI *roi, int width, int height) {
+    int x0 = clamp(roi->x, 0, width);
+    int y0 = clamp(roi->y, 0, height);
+    int x1 = clamp(roi->x + roi->width, 0, width);
+    int y1 = clamp(roi->y + roi->height, 0, height);
+    
+    roi->x = x0;
+    roi->y = y0;
+    roi->width = x1 > x0 ? x1 - x0 : 0;
+    roi->height = y1 > y0 ? y1 - y0 : 0;
+    
+    return roi->width > 0 && roi->height > 0;
+}
+
+ImageROI roi_expand(const ImageROI *roi, int margin, int width, int height) {
+    ImageROI expanded = {roi->x - margin, roi->y - margin,
+                         roi->width + 2 * margin, roi->height + 2 * margin};
+    roi_clip(&expanded, width, height);
+    return expanded;
+}
+
+ImageFloat *crop_image(const ImageFloat *img, const ImageROI *roi) {
+    ImageFloat *crop = create_image_float_uninit(roi->width, roi->height, img->channels);
+    if (!crop) return NULL;
+    
+    size_t src_pixels = (size_t)img->width * img->height;
+    size_t dst_pixels = (size_t)roi->width * roi->height;
+    
+    // Copie ligne par ligne de la fenêtre, canal par canal
+    for (int c = 0; c < img->channels; c++) {
+        for (int y = 0; y < roi->height; y++) {
+            memcpy(crop->data + c * dst_pixels + (size_t)y * roi->width,
+                   img->data + c * src_pixels + (size_t)(roi->y + y) * img->width + roi->x,
+                   roi->width * sizeof(float));
+        }
+    }
+    
+    return crop;
+}
+
 unsigned char *planar_to_interleaved(const ImageFloat *img) {
-    size_t pixels = (size_t)img->width * img->height;
-    size_t total_bytes = pixels * img->channels;
+    size_t total_bytes = (size_t)img->width * img->height * img->channels;
     
     unsigned char *data = (unsigned char *)malloc(total_bytes);
     if (!data) return NULL;
     
     // Conversion planaire -> entrelacé avec clipping [0, 255]
-    for (size_t i = 0; i < pixels; i++) {
-        for (int ch = 0; ch < img->channels; ch++) {
-            float val = img->data[ch * pixels + i];
-            // Clamp et arrondi
-            val = clampf(val, 0.0f, 255.0f);
-            data[i * img->channels + ch] = (unsigned char)(val + 0.5f);
-        }
-    }
+    quantize_interleave_rows(img, 1.0f, 0.0f, 0, img->height, data,
+                             (size_t)img->width * img->channels);
     
     return data;
 }
 
 ImageFloat *clone_image(const ImageFloat *img) {
-    ImageFloat *clone = create_image_float(img->width, img->height, img->channels);
+    // Image construite par l'appelant (sans tampon): rien à partager, copie
+    if (!img->buffer) {
+        ImageFloat *copy = create_image_float_uninit(img->width, img->height, img->channels);
+        if (copy) {
+            memcpy(copy->data, img->data,
+                   (size_t)img->width * img->height * img->channels * sizeof(float));
+        }
+        return copy;
+    }
+    
+    ImageFloat *clone = (ImageFloat *)malloc(sizeof(ImageFloat));
     if (!clone) return NULL;
     
-    size_t total_pixels = (size_t)img->width * img->height * img->channels;
-    memcpy(clone->data, img->data, total_pixels * sizeof(float));
+    // Partage du tampon: aucune copie tant que personne n'écrit
+    *clone = *img;
+    atomic_fetch_add(&clone->buffer->refcount, 1);
     
     return clone;
 }
 
-void normalize_image(ImageFloat *img) {
+int image_is_shared(const ImageFloat *img) {
+    return img->buffer && atomic_load(&img->buffer->refcount) > 1;
+}
+
+int image_make_writable(ImageFloat *img) {
+    if (!image_is_shared(img)) return 1;
+    
+    // Copie privée du tampon partagé
+    size_t bytes = (size_t)img->width * img->height * img->channels * sizeof(float);
+    ImageBuffer *copy = buffer_create(bytes);
+    if (!copy) return 0;
+    
+    memcpy(copy->data, img->data, bytes);
+    buffer_release(img->buffer);
+    img->buffer = copy;
+    img->data = copy->data;
+    
+    return 1;
+}
+
+// ============================================================================
+// Normalisation: réduction min/max et mise à l'échelle vectorisées
+// ============================================================================
+
+// Taille des blocs répartis entre les threads (éléments)
+#define REDUCE_BLOCK 65536
+
+// Min/max d'un bloc, 16 éléments par itération (deux accumulateurs AVX2)
+__attribute__((target("avx2,fma")))
+static void minmax_block_avx2(const float *data, size_t n, float *lo, float *hi) {
+    __m256 vmin0 = _mm256_set1_ps(*lo), vmin1 = vmin0;
+    __m256 vmax0 = _mm256_set1_ps(*hi), vmax1 = vmax0;
+    size_t i = 0;
+    
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_loadu_ps(data + i);
+        __m256 b = _mm256_loadu_ps(data + i + 8);
+        vmin0 = _mm256_min_ps(vmin0, a);
+        vmax0 = _mm256_max_ps(vmax0, a);
+        vmin1 = _mm256_min_ps(vmin1, b);
+        vmax1 = _mm256_max_ps(vmax1, b);
+    }
+    
+    // Réduction horizontale des 8 voies
+    float lanes_min[8], lanes_max[8];
+    _mm256_storeu_ps(lanes_min, _mm256_min_ps(vmin0, vmin1));
+    _mm256_storeu_ps(lanes_max, _mm256_max_ps(vmax0, vmax1));
+    float l = lanes_min[0], h = lanes_max[0];
+    for (int k = 1; k < 8; k++) {
+        if (lanes_min[k] < l) l = lanes_min[k];
+        if (lanes_max[k] > h) h = lanes_max[k];
+    }
+    
+    for (; i < n; i++) {
+        if (data[i] < l) l = data[i];
+        if (data[i] > h) h = data[i];
+    }
+    *lo = l;
+    *hi = h;
+}
+
+// Min/max d'un bloc, version portable (vectorisée par le compilateur)
+static void minmax_block_scalar(const float *data, size_t n, float *lo, float *hi) {
+    float l = *lo, h = *hi;
+    #pragma omp simd reduction(min:l) reduction(max:h)
+    for (size_t i = 0; i < n; i++) {
+        l = data[i] < l ? data[i] : l;
+        h = data[i] > h ? data[i] : h;
+    }
+    *lo = l;
+    *hi = h;
+}
+
+// data = data * scale + offset sur un bloc (FMA)
+__attribute__((target("avx2,fma")))
+static void scale_block_avx2(float *data, size_t n, float scale, float offset) {
+    __m256 vscale = _mm256_set1_ps(scale);
+    __m256 voffset = _mm256_set1_ps(offset);
+    size_t i = 0;
+    
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(data + i);
+        _mm256_storeu_ps(data + i, _mm256_fmadd_ps(v, vscale, voffset));
+    }
+    // Reste avec la même FMA (arrondi unique), comme quantize_span_avx2
+    for (; i < n; i++) {
+        data[i] = fmaf(data[i], scale, offset);
+    }
+}
+
+static void scale_block_scalar(float *data, size_t n, float scale, float offset) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        data[i] = data[i] * scale + offset;
+    }
+}
+
+void image_minmax(const ImageFloat *img, float *min_out, float *max_out) {
     size_t total_pixels = (size_t)img->width * img->height * img->channels;
+    long long num_blocks = (long long)((total_pixels + REDUCE_BLOCK - 1) / REDUCE_BLOCK);
+    int use_avx2 = cpu_has_avx2_fma();
     
-    // Trouver min et max
     float min_val = img->data[0];
     float max_val = img->data[0];
     
-    for (size_t i = 1; i < total_pixels; i++) {
-        if (img->data[i] < min_val) min_val = img->data[i];
-        if (img->data[i] > max_val) max_val = img->data[i];
+    // Chaque thread réduit ses blocs, puis réduction OpenMP entre threads
+    #pragma omp parallel for schedule(static) reduction(min:min_val) reduction(max:max_val)
+    for (long long b = 0; b < num_blocks; b++) {
+        size_t start = (size_t)b * REDUCE_BLOCK;
+        size_t n = total_pixels - start < REDUCE_BLOCK ? total_pixels - start : REDUCE_BLOCK;
+        float lo = img->data[start], hi = img->data[start];
+        
+        if (use_avx2) minmax_block_avx2(img->data + start, n, &lo, &hi);
+        else minmax_block_scalar(img->data + start, n, &lo, &hi);
+        
+        if (lo < min_val) min_val = lo;
+        if (hi > max_val) max_val = hi;
     }
     
-    // Normaliser [min, max] -> [0, 255]
+    *min_out = min_val;
+    *max_out = max_val;
+}
+
+int normalize_coefficients(float min_val, float max_val, float *scale, float *offset) {
     float range = max_val - min_val;
-    if (range > 1e-6f) {
-        float scale = 255.0f / range;
-        for (size_t i = 0; i < total_pixels; i++) {
-            img->data[i] = (img->data[i] - min_val) * scale;
+    if (range <= 1e-6f) {
+        *scale = 1.0f;
+        *offset = 0.0f;
+        return 0;
+    }
+    *scale = 255.0f / range;
+    *offset = -min_val * *scale;
+    return 1;
+}
+
+void normalize_image_range(ImageFloat *img, float min_val, float max_val) {
+    // Normaliser [min, max] -> [0, 255], une seule FMA par pixel
+    float scale, offset;
+    if (!normalize_coefficients(min_val, max_val, &scale, &offset)) return;
+    if (!image_make_writable(img)) return;
+    
+    size_t total_pixels = (size_t)img->width * img->height * img->channels;
+    long long num_blocks = (long long)((total_pixels + REDUCE_BLOCK - 1) / REDUCE_BLOCK);
+    int use_avx2 = cpu_has_avx2_fma();
+    
+    #pragma omp parallel for schedule(static)
+    for (long long b = 0; b < num_blocks; b++) {
+        size_t start = (size_t)b * REDUCE_BLOCK;
+        size_t n = total_pixels - start < REDUCE_BLOCK ? total_pixels - start : REDUCE_BLOCK;
+        
+        if (use_avx2) scale_block_avx2(img->data + start, n, scale, offset);
+        else scale_block_scalar(img->data + start, n, scale, offset);
+    }
+}
+
+void normalize_image(ImageFloat *img) {
+    float min_val, max_val;
+    
+    // Trouver min et max, puis normaliser
+    image_minmax(img, &min_val, &max_val);
+    normalize_image_range(img, min_val, max_val);
+}
+
+// ============================================================================
+// Stockage demi-précision (binary16)
+// ============================================================================
+
+static int cpu_has_f16c(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    }
+    return cached;
+}
+
+__attribute__((target("avx,f16c")))
+static void half_to_float_row_f16c(const uint16_t *src, size_t n, float *dst) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+    for (; i < n; i++) dst[i] = half_to_float(src[i]);
+}
+
+__attribute__((target("avx,f16c")))
+static void float_to_half_row_f16c(const float *src, size_t n, uint16_t *dst) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i *)(dst + i), h);
+    }
+    for (; i < n; i++) dst[i] = float_to_half(src[i]);
+}
+
+void half_to_float_row(const uint16_t *src, size_t n, float *dst) {
+    if (cpu_has_f16c()) {
+        half_to_float_row_f16c(src, n, dst);
+    } else {
+        for (size_t i = 0; i < n; i++) dst[i] = half_to_float(src[i]);
+    }
+}
+
+void float_to_half_row(const float *src, size_t n, uint16_t *dst) {
+    if (cpu_has_f16c()) {
+        float_to_half_row_f16c(src, n, dst);
+    } else {
+        for (size_t i = 0; i < n; i++) dst[i] = float_to_half(src[i]);
+    }
+}
+
+ImageHalf *create_image_half(int width, int height, int channels) {
+    ImageHalf *img = (ImageHalf *)malloc(sizeof(ImageHalf));
+    if (!img) return NULL;
+    
+    img->width = width;
+    img->height = height;
+    img->channels = channels;
+    img->data = (uint16_t *)pool_alloc((size_t)width * height * channels * sizeof(uint16_t));
+    if (!img->data) {
+        free(img);
+        return NULL;
+    }
+    
+    return img;
+}
+
+void free_image_half(ImageHalf *img) {
+    if (img) {
+        pool_free(img->data);
+        free(img);
+    }
+}
+
+ImageHalf *image_to_half(const ImageFloat *img) {
+    ImageHalf *half = create_image_half(img->width, img->height, img->channels);
+    if (!half) return NULL;
+    
+    size_t total = (size_t)img->width * img->height * img->channels;
+    long long num_blocks = (long long)((total + REDUCE_BLOCK - 1) / REDUCE_BLOCK);
+    
+    #pragma omp parallel for schedule(static)
+    for (long long b = 0; b < num_blocks; b++) {
+        size_t start = (size_t)b * REDUCE_BLOCK;
+        size_t n = total - start < REDUCE_BLOCK ? total - start : REDUCE_BLOCK;
+        float_to_half_row(img->data + start, n, half->data + start);
+    }
+    
+    return half;
+}
+
+ImageFloat *half_to_image(const ImageHalf *half) {
+    ImageFloat *img = create_image_float_uninit(half->width, half->height, half->channels);
+    if (!img) return NULL;
+    
+    size_t total = (size_t)half->width * half->height * half->channels;
+    long long num_blocks = (long long)((total + REDUCE_BLOCK - 1) / REDUCE_BLOCK);
+    
+    #pragma omp parallel for schedule(static)
+    for (long long b = 0; b < num_blocks; b++) {
+        size_t start = (size_t)b * REDUCE_BLOCK;
+        size_t n = total - start < REDUCE_BLOCK ? total - start : REDUCE_BLOCK;
+        half_to_float_row(half->data + start, n, img->data + start);
+    }
+    
+    return img;
+}
+
+double image_psnr(const ImageFloat *a, const ImageFloat *b, float peak) {
+    if (a->width != b->width || a->height != b->height || a->channels != b->channels) {
+        return -1.0;
+    }
+    
+    size_t total = (size_t)a->width * a->height * a->channels;
+    double sum = 0.0;
+    
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (size_t i = 0; i < total; i++) {
+        double d = (double)a->data[i] - (double)b->data[i];
+        sum += d * d;
+    }
+    
+    double mse = sum / (double)total;
+    if (mse <= 0.0) return INFINITY;
+    return 10.0 * log10((double)peak * peak / mse);
+}
+
+// Largeur des tuiles de quantification (multiple de 16 pour l'entrelacement SIMD)
+#define QUANT_TILE 256
+
+// u8 = trunc(clamp((x * scale + offset) + 0.5, 0.5, 255.5)): même arrondi que
+// clamp(x * scale + offset, 0, 255) + 0.5 tronqué. Le + 0.5 n'est pas replié
+// dans offset, pour arrondir exactement comme normalize_image_range suivi de
+// planar_to_interleaved
+static void quantize_span_scalar(const float *src, int n, float scale, float offset,
+                                 unsigned char *dst) {
+    for (int i = 0; i < n; i++) {
+        dst[i] = (unsigned char)clampf((src[i] * scale + offset) + 0.5f, 0.5f, 255.5f);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void quantize_span_avx2(const float *src, int n, float scale, float offset,
+                               unsigned char *dst) {
+    __m256 vscale = _mm256_set1_ps(scale);
+    __m256 voffset = _mm256_set1_ps(offset);
+    __m256 vlo = _mm256_set1_ps(0.5f);
+    __m256 vhi = _mm256_set1_ps(255.5f);
+    int i = 0;
+    
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_fmadd_ps(_mm256_loadu_ps(src + i), vscale, voffset);
+        __m256 b = _mm256_fmadd_ps(_mm256_loadu_ps(src + i + 8), vscale, voffset);
+        a = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(a, vlo), vlo), vhi);
+        b = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(b, vlo), vlo), vhi);
+        
+        // 16 x int32 -> 16 x uint8 (packs par voie de 128 bits, puis remise en ordre)
+        __m256i w = _mm256_packus_epi32(_mm256_cvttps_epi32(a), _mm256_cvttps_epi32(b));
+        w = _mm256_permute4x64_epi64(w, 0xD8);
+        __m128i q = _mm_packus_epi16(_mm256_castsi256_si128(w),
+                                     _mm256_extracti128_si256(w, 1));
+        _mm_storeu_si128((__m128i *)(dst + i), q);
+    }
+    for (; i < n; i++) {
+        dst[i] = (unsigned char)clampf(fmaf(src[i], scale, offset) + 0.5f, 0.5f, 255.5f);
+    }
+}
+
+// Entrelacement de 16 pixels par itération (pshufb / unpack), reste en scalaire
+__attribute__((target("avx2")))
+static void interleave_tile_simd(unsigned char tile[][QUANT_TILE], int channels, int n,
+                                 unsigned char *dst) {
+    int i = 0;
+    
+    if (channels == 3) {
+        const __m128i r0 = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5);
+        const __m128i g0 = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+        const __m128i b0 = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+        const __m128i r1 = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1);
+        const __m128i g1 = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10);
+        const __m128i b1 = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1);
+        const __m128i r2 = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1);
+        const __m128i g2 = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1);
+        const __m128i b2 = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15);
+        
+        for (; i + 16 <= n; i += 16) {
+            __m128i r = _mm_loadu_si128((const __m128i *)(tile[0] + i));
+            __m128i g = _mm_loadu_si128((const __m128i *)(tile[1] + i));
+            __m128i b = _mm_loadu_si128((const __m128i *)(tile[2] + i));
+            unsigned char *out = dst + 3 * i;
+            _mm_storeu_si128((__m128i *)out, _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(r, r0), _mm_shuffle_epi8(g, g0)), _mm_shuffle_epi8(b, b0)));
+            _mm_storeu_si128((__m128i *)(out + 16), _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(r, r1), _mm_shuffle_epi8(g, g1)), _mm_shuffle_epi8(b, b1)));
+            _mm_storeu_si128((__m128i *)(out + 32), _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(r, r2), _mm_shuffle_epi8(g, g2)), _mm_shuffle_epi8(b, b2)));
+        }
+    } else if (channels == 4) {
+        for (; i + 16 <= n; i += 16) {
+            __m128i r = _mm_loadu_si128((const __m128i *)(tile[0] + i));
+            __m128i g = _mm_loadu_si128((const __m128i *)(tile[1] + i));
+            __m128i b = _mm_loadu_si128((const __m128i *)(tile[2] + i));
+            __m128i a = _mm_loadu_si128((const __m128i *)(tile[3] + i));
+            __m128i rg_lo = _mm_unpacklo_epi8(r, g), rg_hi = _mm_unpackhi_epi8(r, g);
+            __m128i ba_lo = _mm_unpacklo_epi8(b, a), ba_hi = _mm_unpackhi_epi8(b, a);
+            unsigned char *out = dst + 4 * i;
+            _mm_storeu_si128((__m128i *)out, _mm_unpacklo_epi16(rg_lo, ba_lo));
+            _mm_storeu_si128((__m128i *)(out + 16), _mm_unpackhi_epi16(rg_lo, ba_lo));
+            _mm_storeu_si128((__m128i *)(out + 32), _mm_unpacklo_epi16(rg_hi, ba_hi));
+            _mm_storeu_si128((__m128i *)(out + 48), _mm_unpackhi_epi16(rg_hi, ba_hi));
+        }
+    } else if (channels == 2) {
+        for (; i + 16 <= n; i += 16) {
+            __m128i l = _mm_loadu_si128((const __m128i *)(tile[0] + i));
+            __m128i a = _mm_loadu_si128((const __m128i *)(tile[1] + i));
+            _mm_storeu_si128((__m128i *)(dst + 2 * i), _mm_unpacklo_epi8(l, a));
+            _mm_storeu_si128((__m128i *)(dst + 2 * i + 16), _mm_unpackhi_epi8(l, a));
+        }
+    }
+    
+    for (; i < n; i++) {
+        for (int ch = 0; ch < channels; ch++) {
+            dst[(size_t)i * channels + ch] = tile[ch][i];
         }
     }
 }
 
-// Générateur de nombres aléatoires gaussiens (Box-Muller transform)
-static float randn() {
-    static int has_spare = 0;
-    static float spare;
+// Quantifie n valeurs du canal de sortie ch, à partir du pixel start:
+// plan couleur (scale, offset), plan alpha recopié tel quel, ou alpha opaque
+static void quantize_channel_span(const ImageFloat *img, const ImageFloat *alpha, int ch,
+                                  size_t start, int n, float scale, float offset,
+                                  int use_avx2, unsigned char *out) {
+    const float *src;
+    if (ch < img->channels) {
+        src = img->data + ch * (size_t)img->width * img->height + start;
+    } else if (alpha) {
+        src = alpha->data + start;
+        scale = 1.0f;
+        offset = 0.0f;
+    } else {
+        memset(out, 255, n);
+        return;
+    }
+    
+    if (use_avx2) quantize_span_avx2(src, n, scale, offset, out);
+    else quantize_span_scalar(src, n, scale, offset, out);
+}
+
+// Cœur de quantification + entrelacement, avec canal alpha ajouté éventuel
+static void quantize_interleave_core(const ImageFloat *img, float scale, float offset,
+                                     const ImageFloat *alpha, int with_alpha,
+                                     int y0, int y1, unsigned char *dst, size_t dst_stride) {
+    int width = img->width;
+    int channels = img->channels + (with_alpha ? 1 : 0);
+    int use_avx2 = cpu_has_avx2_fma();
     
-    if (has_spare) {
-        has_spare = 0;
-        return spare;
+    #pragma omp parallel for schedule(static)
+    for (int y = y0; y < y1; y++) {
+        unsigned char *row = dst + (size_t)(y - y0) * dst_stride;
+        size_t row_start = (size_t)y * width;
+        
+        // Un seul canal: la quantification écrit directement dans la ligne
+        if (channels == 1) {
+            quantize_channel_span(img, alpha, 0, row_start, width, scale, offset, use_avx2, row);
+            continue;
+        }
+        
+        // Sinon, tuile par tuile: quantification de chaque plan dans un tampon
+        // resté en L1, puis entrelacement vers la ligne de destination
+        unsigned char tile[4][QUANT_TILE];
+        for (int x0 = 0; x0 < width; x0 += QUANT_TILE) {
+            int n = width - x0 < QUANT_TILE ? width - x0 : QUANT_TILE;
+            unsigned char *out = row + (size_t)x0 * channels;
+            
+            if (channels > 4) {
+                // Cas générique (rare): scalaire, canal le plus interne
+                for (int ch = 0; ch < channels; ch++) {
+                    quantize_channel_span(img, alpha, ch, row_start + x0, n, scale, offset,
+                                          0, tile[0]);
+                    for (int i = 0; i < n; i++) out[(size_t)i * channels + ch] = tile[0][i];
+                }
+                continue;
+            }
+            
+            for (int ch = 0; ch < channels; ch++) {
+                quantize_channel_span(img, alpha, ch, row_start + x0, n, scale, offset,
+                                      use_avx2, tile[ch]);
+            }
+            
+            if (use_avx2) {
+                interleave_tile_simd(tile, channels, n, out);
+            } else {
+                for (int i = 0; i < n; i++) {
+                    for (int ch = 0; ch < channels; ch++) {
+                        out[(size_t)i * channels + ch] = tile[ch][i];
+                    }
+                }
+            }
+        }
     }
+}
+
+void quantize_interleave_rows(const ImageFloat *img, float scale, float offset,
+                              int y0, int y1, unsigned char *dst, size_t dst_stride) {
+    quantize_interleave_core(img, scale, offset, NULL, 0, y0, y1, dst, dst_stride);
+}
+
+void quantize_interleave_rows_alpha(const ImageFloat *img, float scale, float offset,
+                                    const ImageFloat *alpha, int y0, int y1,
+                                    unsigned char *dst, size_t dst_stride) {
+    quantize_interleave_core(img, scale, offset, alpha, 1, y0, y1, dst, dst_stride);
+}
+
+unsigned char *planar_to_interleaved_normalized(const ImageFloat *img,
+                                                float min_val, float max_val) {
+    size_t total_bytes = (size_t)img->width * img->height * img->channels;
     
-    has_spare = 1;
+    unsigned char *data = (unsigned char *)malloc(total_bytes);
+    if (!data) return NULL;
     
-    float u, v, s;
-    do {
-        u = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-        v = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-        s = u * u + v * v;
-    } while (s >= 1.0f || s == 0.0f);
+    float scale, offset;
+    normalize_coefficients(min_val, max_val, &scale, &offset);
+    quantize_interleave_rows(img, scale, offset, 0, img->height, data,
+                             (size_t)img->width * img->channels);
     
-    s = sqrtf(-2.0f * logf(s) / s);
-    spare = v * s;
-    return u * s;
+    return data;
 }
 
-void add_gaussian_noise(ImageFloat *img, float sigma) {
-    size_t total_pixels = (size_t)img->width * img->height * img->channels;
+unsigned char *planar_to_interleaved_alpha(const ImageFloat *img, float min_val, float max_val,
+                                           const ImageFloat *alpha) {
+    if (alpha && (alpha->width != img->width || alpha->height != img->height ||
+                  alpha->channels != 1)) {
+        return NULL;
+    }
+    
+    int channels = img->channels + 1;
+    unsigned char *data = (unsigned char *)malloc((size_t)img->width * img->height * channels);
+    if (!data) return NULL;
     
-    // Initialiser le générateur aléatoire
-    srand((unsigned int)time(NULL));
+    float scale, offset;
+    normalize_coefficients(min_val, max_val, &scale, &offset);
+    quantize_interleave_core(img, scale, offset, alpha, 1, 0, img->height, data,
+                             (size_t)img->width * channels);
     
-    for (size_t i = 0; i < total_pixels; i++) {
-        float noise = randn() * sigma;
-        img->data[i] += noise;
+    return data;
+}
+
+// ============================================================================
+// Canal alpha
+// ============================================================================
+
+// Nombre de pixels par bloc de la recherche d'alpha non opaque
+#define ALPHA_BLOCK 65536
+
+static int alpha_block_opaque_scalar(const unsigned char *data, size_t n, int channels) {
+    unsigned char all = 255;
+    for (size_t i = 0; i < n; i++) all &= data[i * channels + channels - 1];
+    return all == 255;
+}
+
+// 32 octets par itération: les octets de couleur sont forcés à 0xFF par un OU,
+// le vecteur accumulé (ET) reste entièrement à 0xFF si tous les alpha valent 255
+__attribute__((target("avx2")))
+static int alpha_block_opaque_avx2(const unsigned char *data, size_t n, int channels) {
+    const __m256i color_mask = channels == 4 ? _mm256_set1_epi32(0x00FFFFFF)
+                                             : _mm256_set1_epi16(0x00FF);
+    __m256i all = _mm256_set1_epi8(-1);
+    size_t bytes = n * channels;
+    size_t i = 0;
+    
+    for (; i + 128 <= bytes; i += 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(data + i + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(data + i + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(data + i + 96));
+        __m256i ab = _mm256_and_si256(a, b), cd = _mm256_and_si256(c, d);
+        all = _mm256_and_si256(all, _mm256_or_si256(_mm256_and_si256(ab, cd), color_mask));
+    }
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(all, _mm256_set1_epi8(-1))) != -1) return 0;
+    
+    return alpha_block_opaque_scalar(data + i, (bytes - i) / channels, channels);
+}
+
+int alpha_is_opaque(const unsigned char *data, size_t pixels, int channels) {
+    if (channels != 2 && channels != 4) return 0;
+    
+    long long num_blocks = (long long)((pixels + ALPHA_BLOCK - 1) / ALPHA_BLOCK);
+    int use_avx2 = cpu_has_avx2_fma();
+    atomic_int transparent = 0;
+    
+    // Les blocs restants sont sautés dès qu'un pixel non opaque est trouvé
+    #pragma omp parallel for schedule(static)
+    for (long long b = 0; b < num_blocks; b++) {
+        if (atomic_load_explicit(&transparent, memory_order_relaxed)) continue;
+        
+        size_t start = (size_t)b * ALPHA_BLOCK;
+        size_t n = pixels - start < ALPHA_BLOCK ? pixels - start : ALPHA_BLOCK;
+        const unsigned char *block = data + start * channels;
+        
+        int opaque = use_avx2 ? alpha_block_opaque_avx2(block, n, channels)
+                              : alpha_block_opaque_scalar(block, n, channels);
+        if (!opaque) atomic_store_explicit(&transparent, 1, memory_order_relaxed);
+    }
+    
+    return !atomic_load(&transparent);
+}
+
+ImageFloat *interleaved_to_planar_color(const unsigned char *data, int w, int c,
+                                        const ImageROI *roi, ImageFloat **alpha) {
+    int color = c - 1;
+    ImageFloat *img = create_image_float_uninit(roi->width, roi->height, color);
+    ImageFloat *alpha_plane = alpha ? create_image_float_uninit(roi->width, roi->height, 1)
+                                    : NULL;
+    // Ligne jetable par thread pour le canal alpha non conservé
+    float *discard = alpha ? NULL
+                           : (float *)pool_alloc((size_t)roi->width * omp_get_max_threads() *
+                                                 sizeof(float));
+    if (!img || (alpha && !alpha_plane) || (!alpha && !discard)) {
+        free_image_float(img);
+        free_image_float(alpha_plane);
+        pool_free(discard);
+        return NULL;
+    }
+    
+    size_t pixels = (size_t)roi->width * roi->height;
+    
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < roi->height; y++) {
+        const unsigned char *row = data + ((size_t)(roi->y + y) * w + roi->x) * c;
+        float *dst[4];
+        for (int ch = 0; ch < color; ch++) {
+            dst[ch] = img->data + ch * pixels + (size_t)y * roi->width;
+        }
+        dst[color] = alpha_plane ? alpha_plane->data + (size_t)y * roi->width
+                                 : discard + (size_t)roi->width * omp_get_thread_num();
+        deinterleave_row(row, roi->width, c, dst);
+    }
+    
+    pool_free(discard);
+    if (alpha) *alpha = alpha_plane;
+    return img;
+}
+
+// Taille d'un bloc de génération du bruit (échantillons)
+#define NOISE_BLOCK 4096
+
+void add_gaussian_noise(ImageFloat *img, float sigma, unsigned int seed) {
+    if (!image_make_writable(img)) return;
+    
+    size_t total_pixels = (size_t)img->width * img->height * img->channels;
+    long long num_blocks = (long long)((total_pixels + NOISE_BLOCK - 1) / NOISE_BLOCK);
+    float *data = img->data;
+    
+    // Un flux VSL par thread, tous issus de la même graine. Chaque bloc est
+    // généré à sa position absolue dans la séquence (saut en avant), le bruit
+    // est donc identique quel que soit le nombre de threads.
+    #pragma omp parallel
+    {
+        VSLStreamStatePtr stream;
+        float noise[NOISE_BLOCK] __attribute__((aligned(64)));
+        long long position = 0;
+        
+        vslNewStream(&stream, VSL_BRNG_PHILOX4X32X10, seed);
+        
+        #pragma omp for schedule(static)
+        for (long long b = 0; b < num_blocks; b++) {
+            size_t start = (size_t)b * NOISE_BLOCK;
+            int count = (int)(total_pixels - start < NOISE_BLOCK ? total_pixels - start : NOISE_BLOCK);
+            
+            // La méthode ICDF consomme exactement un nombre uniforme par échantillon
+            vslSkipAheadStream(stream, (long long)start - position);
+            vsRngGaussian(VSL_RNG_METHOD_GAUSSIAN_ICDF, stream, count, noise, 0.0f, sigma);
+            position = (long long)start + count;
+            
+            // Ajout vectorisé en place
+            float *dst = data + start;
+            #pragma omp simd aligned(noise : 64)
+            for (int i = 0; i < count; i++) {
+                dst[i] += noise[i];
+            }
+        }
+        
+        vslDeleteStream(&stream);
     }
 }
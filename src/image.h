@@ -2,29 +2,89 @@
 #define IMAGE_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Fonctions exportées par libdenoise.so (API de denoise.h): les objets sont
+ * compilés avec -fvisibility=hidden, tout le reste (stb, png_stream, pool,
+ * service...) reste interne à la bibliothèque
+ */
+#define DENOISE_API __attribute__((visibility("default")))
+
+/**
+ * Tampon de pixels partagé entre plusieurs images (compteur de références)
+ * Structure opaque, gérée par image.c
+ */
+typedef struct ImageBuffer ImageBuffer;
 
 /**
  * Structure pour représenter une image en virgule flottante
  * Format planaire : tous les pixels R, puis tous les G, puis tous les B
  * Layout mémoire : [R0 R1 R2 ... Rn G0 G1 G2 ... Gn B0 B1 B2 ... Bn]
+ * 
+ * Les pixels sont partagés en copie sur écriture: clone_image ne copie rien,
+ * et une image dont le tampon est partagé doit appeler image_make_writable
+ * avant d'écrire dans data (les fonctions de la bibliothèque le font).
+ * 
+ * Une image remplie à la main (buffer à NULL, data appartenant à l'appelant)
+ * n'est ni partagée ni possédée: elle est modifiée en place, et clone_image
+ * en fait une copie. Pour que la bibliothèque partage puis libère des plans
+ * de l'appelant, les envelopper avec image_wrap_external.
  */
 typedef struct {
-    float *data;      // Données en format planaire (alignées pour MKL)
-    int width;        // Largeur de l'image
-    int height;       // Hauteur de l'image
-    int channels;     // Nombre de canaux (1=grayscale, 3=RGB)
+    float *data;          // Données en format planaire (alignées pour MKL)
+    int width;            // Largeur de l'image
+    int height;           // Hauteur de l'image
+    int channels;         // Nombre de canaux (1=grayscale, 3=RGB)
+    ImageBuffer *buffer;  // Tampon propriétaire de data (partagé entre clones)
 } ImageFloat;
 
 /**
- * Crée une nouvelle image flottante
- * Utilise mkl_malloc pour garantir l'alignement mémoire optimal
+ * Région d'intérêt (fenêtre rectangulaire) dans une image
+ * Coordonnées en pixels, relatives au coin supérieur gauche de l'image
+ */
+typedef struct {
+    int x;            // Colonne du coin supérieur gauche
+    int y;            // Ligne du coin supérieur gauche
+    int width;        // Largeur de la fenêtre
+    int height;       // Hauteur de la fenêtre
+} ImageROI;
+
+/**
+ * Image stockée en demi-précision (IEEE 754 binary16), même format planaire
+ * Stockage optionnel pour les moteurs limités par la bande passante: les
+ * plans occupent deux fois moins d'octets, les calculs restent en float32
+ * (conversion F16C au chargement et au stockage). 11 bits de mantisse
+ * suffisent pour des sources 8/10 bits.
+ */
+typedef struct {
+    uint16_t *data;       // Plans binary16 (tampon du pool)
+    int width;
+    int height;
+    int channels;
+} ImageHalf;
+
+/**
+ * Crée une nouvelle image flottante initialisée à zéro
+ * Les plans proviennent du pool de tampons alignés sur 64 octets (pool.h)
+ * La mise à zéro est faite en parallèle par bandes de lignes, avec le même
+ * découpage que les moteurs (placement NUMA par first-touch)
+ */
+DENOISE_API ImageFloat *create_image_float(int width, int height, int channels);
+
+/**
+ * Crée une nouvelle image flottante sans initialiser ses pixels
+ * Évite le memset lorsque l'appelant écrit ensuite tous les pixels
+ * (sorties de convolution, conversions, copies); pour un tampon neuf, la
+ * première écriture par les threads du moteur place alors les pages
  */
-ImageFloat *create_image_float(int width, int height, int channels);
+DENOISE_API ImageFloat *create_image_float_uninit(int width, int height, int channels);
 
 /**
  * Libère la mémoire d'une image flottante
  */
-void free_image_float(ImageFloat *img);
+DENOISE_API void free_image_float(ImageFloat *img);
 
 /**
  * Convertit une image entrelacée (RGBRGBRGB...) en format planaire (RRR...GGG...BBB...)
@@ -34,31 +94,274 @@ void free_image_float(ImageFloat *img);
  * @param c: nombre de canaux
  * @return: nouvelle image au format planaire
  */
-ImageFloat *interleaved_to_planar(unsigned char *data, int w, int h, int c);
+DENOISE_API ImageFloat *interleaved_to_planar(unsigned char *data, int w, int h, int c);
+
+/**
+ * Convertit une ligne entrelacée u8 en plans float (dst[ch][x] = src[x*c + ch])
+ * Noyaux AVX2 (pshufb + élargissement) pour 1, 3 et 4 canaux, choisis à
+ * l'exécution selon le processeur; boucle scalaire sinon
+ * @param n: nombre de pixels de la ligne
+ * @param dst: un pointeur de destination par canal
+ */
+DENOISE_API void deinterleave_row(const unsigned char *src, int n, int c, float *const *dst);
 
 /**
  * Convertit une image planaire (RRR...GGG...BBB...) en format entrelacé (RGBRGBRGB...)
  * @param img: image source au format planaire
  * @return: données au format entrelacé (unsigned char), à libérer avec free()
  */
-unsigned char *planar_to_interleaved(const ImageFloat *img);
+DENOISE_API unsigned char *planar_to_interleaved(const ImageFloat *img);
+
+/**
+ * Comme planar_to_interleaved_normalized, avec un canal alpha ajouté en
+ * dernière position (recopié sans normalisation; NULL = opaque, 255)
+ * @param alpha: plan alpha (1 canal, mêmes dimensions) ou NULL
+ * @return: données entrelacées à img->channels + 1 canaux, à libérer avec free()
+ */
+DENOISE_API unsigned char *planar_to_interleaved_alpha(const ImageFloat *img, float min_val,
+                                                       float max_val, const ImageFloat *alpha);
+
+/**
+ * Vérifie (scan SIMD parallèle) que le canal alpha de pixels entrelacés vaut
+ * 255 partout; le canal alpha est le dernier (2 ou 4 canaux)
+ * @return: 1 si entièrement opaque, 0 sinon (ou si l'image n'a pas d'alpha)
+ */
+DENOISE_API int alpha_is_opaque(const unsigned char *data, size_t pixels, int channels);
+
+/**
+ * Convertit une fenêtre de pixels entrelacés avec alpha (2 ou 4 canaux) en
+ * image planaire des seuls canaux de couleur
+ * @param alpha: si non NULL, reçoit le plan alpha (1 canal); sinon le canal
+ *               alpha est ignoré (image opaque)
+ * @return: image planaire à c - 1 canaux, ou NULL en cas d'erreur
+ */
+DENOISE_API ImageFloat *interleaved_to_planar_color(const unsigned char *data, int w, int c,
+                                                    const ImageROI *roi, ImageFloat **alpha);
+
+/**
+ * Quantifie et entrelace des lignes d'une image planaire en une seule lecture:
+ * u8 = arrondi(clamp(x * scale + offset, 0, 255)), au format RGBRGB...
+ * Lignes parallélisées, AVX2 (FMA + pshufb) si le processeur le permet
+ * @param y0, y1: lignes [y0, y1) à convertir
+ * @param dst: destination de la ligne y0, lignes espacées de dst_stride octets
+ */
+DENOISE_API void quantize_interleave_rows(const ImageFloat *img, float scale, float offset,
+                                          int y0, int y1, unsigned char *dst, size_t dst_stride);
+
+/**
+ * Comme quantize_interleave_rows, avec le canal alpha ajouté en dernière
+ * position (img->channels + 1 canaux en sortie)
+ * @param alpha: plan alpha (1 canal, même largeur) recopié sans mise à
+ *               l'échelle, ou NULL pour un alpha opaque (255)
+ */
+DENOISE_API void quantize_interleave_rows_alpha(const ImageFloat *img, float scale, float offset,
+                                                const ImageFloat *alpha, int y0, int y1,
+                                                unsigned char *dst, size_t dst_stride);
+
+/**
+ * Équivaut à normalize_image_range puis planar_to_interleaved, sans modifier
+ * l'image ni la relire: normalisation, arrondi et entrelacement fusionnés
+ * @return: données entrelacées (unsigned char), à libérer avec free()
+ */
+DENOISE_API unsigned char *planar_to_interleaved_normalized(const ImageFloat *img,
+                                                            float min_val, float max_val);
+
+/**
+ * Convertit uniquement une fenêtre d'une image entrelacée en format planaire
+ * Seuls les pixels de la fenêtre sont lus et convertis en flottant
+ * @param data: données sources au format entrelacé (image complète w x h)
+ * @param roi: fenêtre à convertir (doit être contenue dans l'image)
+ * @return: nouvelle image planaire de taille roi->width x roi->height
+ */
+DENOISE_API ImageFloat *interleaved_to_planar_roi(const unsigned char *data, int w, int h, int c,
+                                                  const ImageROI *roi);
+
+/**
+ * Restreint une fenêtre aux bornes d'une image de taille width x height
+ * @return: 1 si la fenêtre résultante est non vide, 0 sinon
+ */
+DENOISE_API int roi_clip(ImageROI *roi, int width, int height);
+
+/**
+ * Agrandit une fenêtre d'une marge (halo du noyau) de chaque côté,
+ * puis la restreint aux bornes de l'image
+ */
+DENOISE_API ImageROI roi_expand(const ImageROI *roi, int margin, int width, int height);
 
 /**
- * Clone une image (copie profonde)
+ * Extrait une fenêtre d'une image (copie des lignes concernées uniquement)
+ * @param roi: fenêtre à extraire (doit être contenue dans l'image)
  */
-ImageFloat *clone_image(const ImageFloat *img);
+DENOISE_API ImageFloat *crop_image(const ImageFloat *img, const ImageROI *roi);
+
+/**
+ * Enveloppe des plans existants dans une image, sans copie (par exemple la
+ * projection mmap d'un fichier planaire). L'image se comporte comme les
+ * autres (clones, copie sur écriture); à la libération du dernier clone,
+ * release(base, base_bytes) rend la mémoire à son propriétaire.
+ * @param data: plans width x height x channels (alignés sur 64 octets)
+ * @param base, base_bytes: région à libérer (contient data)
+ * @return: image, ou NULL en cas d'échec (release n'est alors pas appelée)
+ */
+DENOISE_API ImageFloat *image_wrap_external(float *data, int width, int height, int channels,
+                                            void *base, size_t base_bytes,
+                                            void (*release)(void *base, size_t bytes));
+
+/**
+ * Taille des plans d'une image décrite par un en-tête externe (fichier,
+ * segment partagé), calculée sans débordement: au plus INT_MAX
+ * échantillons (width * height * channels), limite des boucles des moteurs
+ * @param sample_bytes: octets par échantillon (1: u8, 4: float32)
+ * @param bytes: [sortie] width * height * channels * sample_bytes
+ * @return: 1 si la géométrie est valide, 0 si une dimension est nulle ou
+ *          si l'image dépasse la limite
+ */
+DENOISE_API int image_plane_bytes(uint64_t width, uint64_t height, uint64_t channels,
+                                  size_t sample_bytes, size_t *bytes);
+
+/**
+ * Clone une image sans copier ses pixels
+ * Le clone partage le tampon de l'original jusqu'à la première écriture
+ * (copie sur écriture, voir image_make_writable); une image sans tampon
+ * (buffer à NULL) est copiée
+ */
+DENOISE_API ImageFloat *clone_image(const ImageFloat *img);
+
+/**
+ * Indique si le tampon de l'image est partagé avec d'autres images
+ * (0 pour une image sans tampon)
+ */
+DENOISE_API int image_is_shared(const ImageFloat *img);
+
+/**
+ * Rend l'image modifiable: si son tampon est partagé, elle en reçoit une
+ * copie privée; sinon (seul propriétaire) rien n'est copié.
+ * Un producteur qui n'a plus besoin de son image la libère simplement: le
+ * clone restant devient propriétaire et sera modifié en place, sans copie.
+ * @return: 1 si succès, 0 en cas d'échec d'allocation
+ */
+DENOISE_API int image_make_writable(ImageFloat *img);
 
 /**
  * Normalise les valeurs de l'image dans la plage [0, 255]
+ * Modifie l'image en place (copie préalable uniquement si son tampon est partagé)
+ * Équivaut à image_minmax suivi de normalize_image_range
+ */
+DENOISE_API void normalize_image(ImageFloat *img);
+
+/**
+ * Calcule le minimum et le maximum de tous les pixels de l'image
+ * Réduction parallèle (OpenMP) et vectorisée (AVX2 si disponible)
+ */
+DENOISE_API void image_minmax(const ImageFloat *img, float *min_val, float *max_val);
+
+/**
+ * Normalise l'image de [min_val, max_val] vers [0, 255] en une seule passe
+ * Variante de normalize_image sans passe de recherche du min/max, lorsque
+ * celui-ci est déjà connu (calculé par le moteur qui a produit l'image,
+ * voir convolve_separable_into_range)
+ */
+DENOISE_API void normalize_image_range(ImageFloat *img, float min_val, float max_val);
+
+/**
+ * Coefficients de [min_val, max_val] -> [0, 255]:
+ * (x - min_val) * scale = x * scale + offset (voir quantize_interleave_rows)
+ * @return: 0 si la plage est vide (scale = 1, offset = 0: valeurs inchangées)
  */
-void normalize_image(ImageFloat *img);
+DENOISE_API int normalize_coefficients(float min_val, float max_val, float *scale, float *offset);
 
 /**
  * Ajoute du bruit gaussien à une image
+ * Modifie l'image en place (copie préalable uniquement si son tampon est partagé)
+ * Génération parallèle par blocs avec les flux MKL VSL (vsRngGaussian): pour
+ * une graine donnée, le bruit est identique quel que soit le nombre de threads
  * @param img: image à bruiter
  * @param sigma: écart-type du bruit gaussien
+ * @param seed: graine du générateur (reproductibilité)
  */
-void add_gaussian_noise(ImageFloat *img, float sigma);
+DENOISE_API void add_gaussian_noise(ImageFloat *img, float sigma, unsigned int seed);
+
+/**
+ * Crée une image demi-précision sans initialiser ses pixels
+ */
+DENOISE_API ImageHalf *create_image_half(int width, int height, int channels);
+
+/**
+ * Libère une image demi-précision
+ */
+DENOISE_API void free_image_half(ImageHalf *img);
+
+/**
+ * Convertit une image flottante en demi-précision (arrondi au plus proche)
+ * @return: nouvelle image, ou NULL en cas d'erreur
+ */
+DENOISE_API ImageHalf *image_to_half(const ImageFloat *img);
+
+/**
+ * Convertit une image demi-précision en image flottante (conversion exacte)
+ * @return: nouvelle image, ou NULL en cas d'erreur
+ */
+DENOISE_API ImageFloat *half_to_image(const ImageHalf *img);
+
+/**
+ * Rapport signal/bruit crête entre deux images de mêmes dimensions
+ * @param peak: valeur crête (255 pour des images normalisées)
+ * @return: PSNR en dB (INFINITY si identiques, -1 si dimensions différentes)
+ */
+DENOISE_API double image_psnr(const ImageFloat *a, const ImageFloat *b, float peak);
+
+/**
+ * Conversions d'une ligne binary16 <-> float, F16C si disponible
+ */
+DENOISE_API void half_to_float_row(const uint16_t *src, size_t n, float *dst);
+DENOISE_API void float_to_half_row(const float *src, size_t n, uint16_t *dst);
+
+/**
+ * Conversions scalaires binary16 <-> float (repli sans F16C)
+ */
+static inline float half_to_float(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+    uint32_t bits;
+    float f;
+    
+    if (exp == 0) {
+        // Zéro ou sous-normal: mant * 2^-24
+        f = (float)mant * (1.0f / 16777216.0f);
+        return sign ? -f : f;
+    }
+    if (exp == 31) bits = sign | 0x7F800000 | (mant << 13);
+    else bits = sign | ((exp + 112) << 23) | (mant << 13);
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static inline uint16_t float_to_half(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    uint32_t abs_bits = bits & 0x7FFFFFFF;
+    
+    if (abs_bits > 0x7F800000) return sign | 0x7E00;     // NaN
+    if (abs_bits >= 0x477FF000) return sign | 0x7C00;    // >= 65520: infini
+    if (abs_bits < 0x38800000) {
+        // Sous-normal: arrondi au plus proche de |f| * 2^24
+        float a;
+        memcpy(&a, &abs_bits, sizeof(a));
+        a *= 16777216.0f;
+        uint32_t q = (uint32_t)a;
+        float r = a - (float)q;
+        if (r > 0.5f || (r == 0.5f && (q & 1))) q++;
+        return sign | (uint16_t)q;
+    }
+    
+    // Normal: rebiaisage de l'exposant, arrondi pair des 13 bits perdus
+    uint32_t h = ((abs_bits >> 23) - 112) << 10 | ((abs_bits >> 13) & 0x3FF);
+    uint32_t rest = abs_bits & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (h & 1))) h++;
+    return sign | (uint16_t)h;
+}
 
 /**
  * Fonction utilitaire pour clamper une valeur
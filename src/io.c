@@ -1,6 +1,11 @@
 #include "io.h"
+#include "png_stream.h"
+#include "float_io.h"
+#include <ctype.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <math.h>
 
@@ -15,12 +20,21 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
-ImageFloat *load_image(const char *filename) {
-    int width, height, channels;
-    
+// Messages par fichier (chargement, sauvegarde) désactivés par set_io_quiet
+static int io_quiet = 0;
+
+void set_io_quiet(int quiet) {
+    io_quiet = quiet;
+}
+
+int io_is_quiet(void) {
+    return io_quiet;
+}
+
+unsigned char *load_image_u8(const char *filename, int *width, int *height, int *channels) {
     // Charger l'image avec stb_image
     // Force à charger en RGB (3 canaux) ou grayscale (1 canal)
-    unsigned char *data = stbi_load(filename, &width, &height, &channels, 0);
+    unsigned char *data = stbi_load(filename, width, height, channels, 0);
     
     if (!data) {
         fprintf(stderr, "Erreur: impossible de charger l'image '%s'\n", filename);
@@ -28,17 +42,141 @@ ImageFloat *load_image(const char *filename) {
         return NULL;
     }
     
-    printf("Image chargée: %s (%dx%d, %d canaux)\n", filename, width, height, channels);
+    if (!io_quiet) {
+        printf("Image chargée: %s (%dx%d, %d canaux)\n", filename, *width, *height, *channels);
+    }
+    
+    return data;
+}
+
+void free_image_u8(unsigned char *data) {
+    stbi_image_free(data);
+}
+
+ImageFloat *load_image(const char *filename) {
+    int width, height, channels;
+    
+    unsigned char *data = load_image_u8(filename, &width, &height, &channels);
+    if (!data) return NULL;
     
     // Convertir en format planaire
     ImageFloat *img = interleaved_to_planar(data, width, height, channels);
     
     // Libérer les données stb_image
+    free_image_u8(data);
+    
+    return img;
+}
+
+ImageFloat *load_image_color(const char *filename, const ImageROI *roi, int halo,
+                            ImageROI *loaded, AlphaChannel *alpha) {
+    int width, height, channels;
+    
+    unsigned char *data = stbi_load(filename, &width, &height, &channels, 0);
+    
+    if (!data) {
+        fprintf(stderr, "Erreur: impossible de charger l'image '%s'\n", filename);
+        fprintf(stderr, "Raison: %s\n", stbi_failure_reason());
+        return NULL;
+    }
+    
+    ImageROI region = {0, 0, width, height};
+    if (roi) {
+        ImageROI window = *roi;
+        if (!roi_clip(&window, width, height)) {
+            fprintf(stderr, "Erreur: la fenêtre %d,%d,%d,%d est hors de l'image (%dx%d)\n",
+                    roi->x, roi->y, roi->width, roi->height, width, height);
+            stbi_image_free(data);
+            return NULL;
+        }
+        
+        // Région à convertir: fenêtre + halo du noyau, bornée à l'image
+        region = roi_expand(&window, halo, width, height);
+        
+        if (!io_quiet) {
+            printf("Image chargée: %s (%dx%d, %d canaux), région %dx%d à (%d,%d)\n",
+                   filename, width, height, channels,
+                   region.width, region.height, region.x, region.y);
+        }
+    } else if (!io_quiet) {
+        printf("Image chargée: %s (%dx%d, %d canaux)\n", filename, width, height, channels);
+    }
+    if (loaded) *loaded = region;
+    
+    ImageFloat *img = NULL;
+    if (alpha && (channels == 2 || channels == 4)) {
+        // Canal alpha séparé: seuls les canaux de couleur sont débruités
+        alpha->present = 1;
+        alpha->plane = NULL;
+        if (alpha_is_opaque(data, (size_t)width * height, channels)) {
+            if (!io_quiet) printf("Canal alpha opaque: ignoré (rétabli à 255 à la sauvegarde)\n");
+            img = interleaved_to_planar_color(data, width, channels, &region, NULL);
+        } else {
+            if (!io_quiet) printf("Canal alpha: recopié sans débruitage\n");
+            img = interleaved_to_planar_color(data, width, channels, &region, &alpha->plane);
+        }
+    } else {
+        if (alpha) {
+            alpha->present = 0;
+            alpha->plane = NULL;
+        }
+        img = interleaved_to_planar_roi(data, width, height, channels, &region);
+    }
+    
     stbi_image_free(data);
     
     return img;
 }
 
+ImageFloat *load_image_roi(const char *filename, const ImageROI *roi, int halo,
+                           ImageROI *loaded) {
+    return load_image_color(filename, roi, halo, loaded, NULL);
+}
+
+void free_alpha_channel(AlphaChannel *alpha) {
+    if (!alpha) return;
+    free_image_float(alpha->plane);
+    alpha->plane = NULL;
+    alpha->present = 0;
+}
+
+// Niveau zlib des PNG sauvegardés: 1 (Z_RLE) par défaut, le plus rapide et,
+// sur des images débruitées, plus compact que le niveau 6
+static int png_compression_level = 1;
+
+void set_png_compression_level(int level) {
+    png_compression_level = level < -1 ? -1 : (level > 9 ? 9 : level);
+}
+
+int save_image_u8(const char *filename, const unsigned char *data,
+                  int width, int height, int channels) {
+    // Filtrage et deflate répartis entre les threads (stbi_write_png est séquentiel)
+    int result = png_write_image(filename, data, width, height, channels,
+                                 png_compression_level);
+    
+    if (result) {
+        if (!io_quiet) printf("Image sauvegardée: %s\n", filename);
+    } else {
+        fprintf(stderr, "Erreur: impossible de sauvegarder '%s'\n", filename);
+    }
+    
+    return result;
+}
+
+// Écrit le tampon entrelacé en PNG puis le libère
+static int write_png(const char *filename, const ImageFloat *img, unsigned char *data) {
+    if (!data) {
+        fprintf(stderr, "Erreur: échec de la conversion planaire->entrelacé\n");
+        return 0;
+    }
+    
+    int result = save_image_u8(filename, data, img->width, img->height, img->channels);
+    
+    free(data);
+    
+    return result;
+}
+
 int save_image(const char *filename, const ImageFloat *img) {
     if (!img || !img->data) {
         fprintf(stderr, "Erreur: image invalide\n");
@@ -46,29 +184,335 @@ int save_image(const char *filename, const ImageFloat *img) {
     }
     
     // Convertir en format entrelacé
-    unsigned char *data = planar_to_interleaved(img);
-    if (!data) {
-        fprintf(stderr, "Erreur: échec de la conversion planaire->entrelacé\n");
+    return write_png(filename, img, planar_to_interleaved(img));
+}
+
+int save_image_normalized(const char *filename, const ImageFloat *img,
+                          float min_val, float max_val) {
+    if (!img || !img->data) {
+        fprintf(stderr, "Erreur: image invalide\n");
         return 0;
     }
     
-    // Sauvegarder en PNG avec stb_image_write
-    int result = stbi_write_png(filename, img->width, img->height, 
-                                 img->channels, data, img->width * img->channels);
+    // Normalisation, arrondi et entrelacement en une passe vers le tampon de l'encodeur
+    return write_png(filename, img, planar_to_interleaved_normalized(img, min_val, max_val));
+}
+
+// ============================================================================
+// Formats de sortie (PNG, PPM/PGM, PFM, planaire, QOI, JPEG)
+// ============================================================================
+
+// Lignes encodées par bloc par les écrivains en flux (PPM/PGM, QOI)
+#define SOURCE_BLOCK_ROWS 64
+
+// Qualité des JPEG (stbi_write_jpg, 1-100)
+#define JPEG_QUALITY 90
+
+static const struct {
+    const char *name;
+    ImageFormat format;
+} format_names[] = {
+    {"png", IMAGE_FORMAT_PNG}, {"ppm", IMAGE_FORMAT_PNM}, {"pgm", IMAGE_FORMAT_PNM},
+    {"pnm", IMAGE_FORMAT_PNM}, {"pfm", IMAGE_FORMAT_PFM}, {"planar", IMAGE_FORMAT_PLANAR},
+    {"qoi", IMAGE_FORMAT_QOI}, {"jpg", IMAGE_FORMAT_JPEG}, {"jpeg", IMAGE_FORMAT_JPEG},
+};
+
+ImageFormat image_format_from_name(const char *name) {
+    char lower[8];
+    size_t n = 0;
+    while (name[n] && n < sizeof(lower) - 1) {
+        lower[n] = (char)tolower((unsigned char)name[n]);
+        n++;
+    }
+    lower[n] = '\0';
+    if (name[n]) return IMAGE_FORMAT_UNKNOWN;
     
-    free(data);
+    for (size_t i = 0; i < sizeof(format_names) / sizeof(format_names[0]); i++) {
+        if (strcmp(lower, format_names[i].name) == 0) return format_names[i].format;
+    }
+    return IMAGE_FORMAT_UNKNOWN;
+}
+
+ImageFormat image_format_from_filename(const char *filename) {
+    const char *dot = strrchr(filename, '.');
+    const char *slash = strrchr(filename, '/');
+    if (!dot || (slash && dot < slash)) return IMAGE_FORMAT_UNKNOWN;
+    return image_format_from_name(dot + 1);
+}
+
+const char *image_format_extension(ImageFormat format, int channels) {
+    switch (format) {
+        case IMAGE_FORMAT_PNG: return "png";
+        case IMAGE_FORMAT_PNM: return channels == 1 ? "pgm" : "ppm";
+        case IMAGE_FORMAT_PFM: return "pfm";
+        case IMAGE_FORMAT_PLANAR: return "planar";
+        case IMAGE_FORMAT_QOI: return "qoi";
+        case IMAGE_FORMAT_JPEG: return "jpg";
+        default: return "";
+    }
+}
+
+// Pixels u8 entrelacés à encoder: image planaire quantifiée (et alpha
+// ajouté) bloc par bloc, ou pixels u8 déjà entrelacés
+typedef struct {
+    const ImageFloat *img;        // NULL: pixels u8 (data)
+    float scale, offset;          // [min, max] -> [0, 255]
+    int with_alpha;               // Canal alpha ajouté après les couleurs
+    const ImageFloat *alpha;      // Plan alpha, NULL si opaque
+    const unsigned char *data;
+    int width, height, channels;  // Dimensions des lignes produites
+} PixelSource;
+
+// Lignes [y0, y1) entrelacées: directement dans les pixels u8, ou
+// quantifiées dans block (SOURCE_BLOCK_ROWS lignes au plus)
+static const unsigned char *source_rows(const PixelSource *src, int y0, int y1,
+                                        unsigned char *block) {
+    size_t stride = (size_t)src->width * src->channels;
+    if (!src->img) return src->data + (size_t)y0 * stride;
     
-    if (result) {
-        printf("Image sauvegardée: %s\n", filename);
+    if (src->with_alpha) {
+        quantize_interleave_rows_alpha(src->img, src->scale, src->offset, src->alpha,
+                                       y0, y1, block, stride);
+    } else {
+        quantize_interleave_rows(src->img, src->scale, src->offset, y0, y1, block, stride);
+    }
+    return block;
+}
+
+// Parcourt l'image par blocs de lignes; block est alloué si la source est planaire
+static unsigned char *source_block(const PixelSource *src) {
+    if (!src->img) return NULL;
+    return (unsigned char *)malloc((size_t)SOURCE_BLOCK_ROWS * src->width * src->channels);
+}
+
+// PPM (P6) / PGM (P5) binaires 8 bits: en-tête puis lignes brutes
+static int write_pnm(const char *filename, const PixelSource *src) {
+    if (src->channels != 1 && src->channels != 3) {
+        fprintf(stderr, "Erreur: PPM/PGM demande 1 ou 3 canaux (%d)\n", src->channels);
+        return 0;
+    }
+    
+    FILE *file = fopen(filename, "wb");
+    if (!file) return 0;
+    
+    size_t stride = (size_t)src->width * src->channels;
+    unsigned char *block = source_block(src);
+    int ok = (!src->img || block) &&
+             fprintf(file, "P%d\n%d %d\n255\n", src->channels == 3 ? 6 : 5,
+                     src->width, src->height) > 0;
+    for (int y = 0; ok && y < src->height; y += SOURCE_BLOCK_ROWS) {
+        int y1 = y + SOURCE_BLOCK_ROWS < src->height ? y + SOURCE_BLOCK_ROWS : src->height;
+        const unsigned char *rows = source_rows(src, y, y1, block);
+        ok = fwrite(rows, stride, (size_t)(y1 - y), file) == (size_t)(y1 - y);
+    }
+    
+    free(block);
+    if (fclose(file) != 0) ok = 0;
+    return ok;
+}
+
+// Opérations QOI (spécification 1.0, qoiformat.org)
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF 0x40
+#define QOI_OP_LUMA 0x80
+#define QOI_OP_RUN 0xc0
+#define QOI_OP_RGB 0xfe
+#define QOI_OP_RGBA 0xff
+
+// Octets QOI accumulés avant écriture (un pixel produit au plus 5 octets)
+#define QOI_BUFFER 65536
+
+static void put_be32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+// QOI: compression sans perte en une passe séquentielle; niveaux de gris
+// écrits en RGB, gris + alpha en RGBA
+static int write_qoi(const char *filename, const PixelSource *src) {
+    int c = src->channels;
+    int has_alpha = c == 2 || c == 4;
+    
+    FILE *file = fopen(filename, "wb");
+    if (!file) return 0;
+    
+    unsigned char *block = source_block(src);
+    unsigned char *out = (unsigned char *)malloc(QOI_BUFFER + 16);
+    int ok = (!src->img || block) && out;
+    
+    unsigned char header[14] = {'q', 'o', 'i', 'f'};
+    put_be32(header + 4, (uint32_t)src->width);
+    put_be32(header + 8, (uint32_t)src->height);
+    header[12] = (unsigned char)(has_alpha ? 4 : 3);
+    header[13] = 0;                        // sRGB, alpha non prémultiplié
+    ok = ok && fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    
+    unsigned char index[64][4];
+    memset(index, 0, sizeof(index));
+    unsigned char prev[4] = {0, 0, 0, 255};
+    size_t pos = 0;
+    int run = 0;
+    
+    for (int y = 0; ok && y < src->height; y += SOURCE_BLOCK_ROWS) {
+        int y1 = y + SOURCE_BLOCK_ROWS < src->height ? y + SOURCE_BLOCK_ROWS : src->height;
+        const unsigned char *p = source_rows(src, y, y1, block);
+        size_t pixels = (size_t)(y1 - y) * src->width;
+        
+        for (size_t i = 0; i < pixels; i++, p += c) {
+            unsigned char px[4];
+            px[0] = p[0];
+            px[1] = c >= 3 ? p[1] : p[0];
+            px[2] = c >= 3 ? p[2] : p[0];
+            px[3] = has_alpha ? p[c - 1] : 255;
+            
+            if (memcmp(px, prev, 4) == 0) {
+                if (++run == 62) {
+                    out[pos++] = (unsigned char)(QOI_OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                out[pos++] = (unsigned char)(QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+            
+            int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+            if (memcmp(index[hash], px, 4) == 0) {
+                out[pos++] = (unsigned char)(QOI_OP_INDEX | hash);
+            } else {
+                memcpy(index[hash], px, 4);
+                if (px[3] == prev[3]) {
+                    signed char vr = (signed char)(px[0] - prev[0]);
+                    signed char vg = (signed char)(px[1] - prev[1]);
+                    signed char vb = (signed char)(px[2] - prev[2]);
+                    signed char vg_r = (signed char)(vr - vg);
+                    signed char vg_b = (signed char)(vb - vg);
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                        out[pos++] = (unsigned char)(QOI_OP_DIFF | (vr + 2) << 4 |
+                                                     (vg + 2) << 2 | (vb + 2));
+                    } else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 &&
+                               vg_b > -9 && vg_b < 8) {
+                        out[pos++] = (unsigned char)(QOI_OP_LUMA | (vg + 32));
+                        out[pos++] = (unsigned char)((vg_r + 8) << 4 | (vg_b + 8));
+                    } else {
+                        out[pos++] = QOI_OP_RGB;
+                        memcpy(out + pos, px, 3);
+                        pos += 3;
+                    }
+                } else {
+                    out[pos++] = QOI_OP_RGBA;
+                    memcpy(out + pos, px, 4);
+                    pos += 4;
+                }
+            }
+            memcpy(prev, px, 4);
+            
+            if (pos >= QOI_BUFFER) {
+                ok = fwrite(out, 1, pos, file) == pos;
+                pos = 0;
+                if (!ok) break;
+            }
+        }
+    }
+    
+    if (ok) {
+        static const unsigned char padding[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+        if (run > 0) out[pos++] = (unsigned char)(QOI_OP_RUN | (run - 1));
+        memcpy(out + pos, padding, sizeof(padding));
+        pos += sizeof(padding);
+        ok = fwrite(out, 1, pos, file) == pos;
+    }
+    
+    free(out);
+    free(block);
+    if (fclose(file) != 0) ok = 0;
+    return ok;
+}
+
+// Écrit la source dans le format demandé; float_img: valeurs brutes des
+// formats flottants (NULL: converties depuis les pixels u8)
+static int save_source(const char *filename, ImageFormat format, const PixelSource *src,
+                       const ImageFloat *float_img) {
+    int ok = 0;
+    
+    if (format == IMAGE_FORMAT_PNM) {
+        ok = write_pnm(filename, src);
+    } else if (format == IMAGE_FORMAT_QOI) {
+        ok = write_qoi(filename, src);
+    } else if (format == IMAGE_FORMAT_PFM || format == IMAGE_FORMAT_PLANAR) {
+        ImageFloat *converted = NULL;
+        if (!float_img) {
+            converted = interleaved_to_planar((unsigned char *)src->data, src->width,
+                                              src->height, src->channels);
+            float_img = converted;
+        }
+        // save_image_float affiche son propre message
+        ok = float_img && save_image_float(filename, float_img);
+        free_image_float(converted);
+        return ok;
+    } else if (format == IMAGE_FORMAT_PNG || format == IMAGE_FORMAT_JPEG) {
+        // Encodeurs sur l'image entière: tampon entrelacé complet si la source
+        // est planaire
+        size_t bytes = (size_t)src->width * src->height * src->channels;
+        unsigned char *owned = src->img ? (unsigned char *)malloc(bytes) : NULL;
+        const unsigned char *data = src->img ? owned : src->data;
+        if (data) {
+            if (owned) source_rows(src, 0, src->height, owned);
+            ok = format == IMAGE_FORMAT_PNG
+                 ? png_write_image(filename, data, src->width, src->height, src->channels,
+                                   png_compression_level)
+                 : stbi_write_jpg(filename, src->width, src->height, src->channels, data,
+                                  JPEG_QUALITY);
+        }
+        free(owned);
+    } else {
+        fprintf(stderr, "Erreur: format de sortie inconnu pour '%s'\n", filename);
+        return 0;
+    }
+    
+    if (ok) {
+        if (!io_quiet) printf("Image sauvegardée: %s\n", filename);
     } else {
         fprintf(stderr, "Erreur: impossible de sauvegarder '%s'\n", filename);
     }
+    return ok;
+}
+
+int save_image_as(const char *filename, const ImageFloat *img,
+                  float min_val, float max_val, const AlphaChannel *alpha) {
+    if (!img || !img->data) {
+        fprintf(stderr, "Erreur: image invalide\n");
+        return 0;
+    }
     
-    return result;
+    ImageFormat format = image_format_from_filename(filename);
+    PixelSource src = {img, 1.0f, 0.0f, 0, NULL, NULL, img->width, img->height, img->channels};
+    normalize_coefficients(min_val, max_val, &src.scale, &src.offset);
+    // Alpha rétabli pour les formats qui le portent (PNG, QOI)
+    if (alpha && alpha->present && (format == IMAGE_FORMAT_PNG || format == IMAGE_FORMAT_QOI)) {
+        if (alpha->plane && (alpha->plane->width != img->width ||
+                             alpha->plane->height != img->height)) {
+            fprintf(stderr, "Erreur: plan alpha de dimensions différentes\n");
+            return 0;
+        }
+        src.with_alpha = 1;
+        src.alpha = alpha->plane;
+        src.channels++;
+    }
+    return save_source(filename, format, &src, img);
+}
+
+int save_image_u8_as(const char *filename, const unsigned char *data,
+                     int width, int height, int channels) {
+    PixelSource src = {NULL, 1.0f, 0.0f, 0, NULL, data, width, height, channels};
+    return save_source(filename, image_format_from_filename(filename), &src, NULL);
 }
 
 ImageFloat *create_test_image(int width, int height) {
-    ImageFloat *img = create_image_float(width, height, 3);
+    ImageFloat *img = create_image_float_uninit(width, height, 3);
     if (!img) return NULL;
     
     size_t pixels = (size_t)width * height;
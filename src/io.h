@@ -3,6 +3,57 @@
 
 #include "image.h"
 
+/**
+ * Canal alpha mis de côté au chargement (images à 2 ou 4 canaux)
+ * Il n'est pas débruité: il est recopié tel quel à la sauvegarde
+ */
+typedef struct {
+    int present;          // L'image d'entrée avait un canal alpha
+    ImageFloat *plane;    // Plan alpha (1 canal), NULL si entièrement opaque
+} AlphaChannel;
+
+/**
+ * Formats de sortie, choisis par l'extension du fichier ou par nom (--format)
+ */
+typedef enum {
+    IMAGE_FORMAT_UNKNOWN,
+    IMAGE_FORMAT_PNG,       // zlib, encodeur parallèle (alpha conservé)
+    IMAGE_FORMAT_PNM,       // PPM (P6) / PGM (P5) sans compression
+    IMAGE_FORMAT_PFM,       // Flottants bruts, voir float_io.h
+    IMAGE_FORMAT_PLANAR,    // Flottants bruts planaires, voir float_io.h
+    IMAGE_FORMAT_QOI,       // Sans perte, compression rapide (alpha conservé)
+    IMAGE_FORMAT_JPEG       // Avec perte (stbi_write_jpg)
+} ImageFormat;
+
+/**
+ * Désactive (quiet = 1) les messages affichés pour chaque fichier chargé
+ * ou sauvegardé; les erreurs restent affichées
+ */
+void set_io_quiet(int quiet);
+
+/**
+ * Indique si les messages par fichier sont désactivés
+ */
+int io_is_quiet(void);
+
+/**
+ * Format désigné par son nom: png, ppm, pgm, pnm, pfm, planar, qoi, jpg, jpeg
+ * (casse indifférente)
+ * @return: format, ou IMAGE_FORMAT_UNKNOWN
+ */
+ImageFormat image_format_from_name(const char *name);
+
+/**
+ * Format désigné par l'extension d'un nom de fichier
+ * @return: format, ou IMAGE_FORMAT_UNKNOWN (extension absente ou inconnue)
+ */
+ImageFormat image_format_from_filename(const char *filename);
+
+/**
+ * Extension des fichiers d'un format (ppm ou pgm selon le nombre de canaux)
+ */
+const char *image_format_extension(ImageFormat format, int channels);
+
 /**
  * Charge une image depuis un fichier (PNG, JPG, etc.)
  * Utilise stb_image pour la lecture
@@ -12,9 +63,59 @@
  */
 ImageFloat *load_image(const char *filename);
 
+/**
+ * Charge une image sans conversion: pixels u8 entrelacés tels que décodés
+ * par stb_image (pour convolve_separable_u8_into)
+ * 
+ * @param filename: chemin du fichier image
+ * @param width, height, channels: [sortie] dimensions de l'image
+ * @return: pixels entrelacés, à libérer avec free_image_u8, ou NULL en cas d'erreur
+ */
+unsigned char *load_image_u8(const char *filename, int *width, int *height, int *channels);
+
+/**
+ * Libère les pixels renvoyés par load_image_u8
+ */
+void free_image_u8(unsigned char *data);
+
+/**
+ * Charge uniquement une fenêtre d'une image, agrandie d'un halo
+ * Le fichier est décodé par stb_image, mais seules les lignes et colonnes
+ * de la fenêtre (halo compris) sont converties au format planaire flottant
+ * 
+ * @param filename: chemin du fichier image
+ * @param roi: fenêtre demandée (coordonnées dans l'image complète)
+ * @param halo: marge à charger autour de la fenêtre (demi-taille du noyau)
+ * @param loaded: [sortie] région effectivement chargée (fenêtre + halo, bornée à l'image)
+ * @return: image planaire de la région chargée, ou NULL en cas d'erreur
+ */
+ImageFloat *load_image_roi(const char *filename, const ImageROI *roi, int halo,
+                           ImageROI *loaded);
+
+/**
+ * Charge une image (ou une fenêtre + halo) en séparant le canal alpha
+ * L'alpha est détecté puis retiré: seuls les canaux de couleur sont convertis
+ * en flottant. Un alpha entièrement opaque (255) n'est pas conservé du tout.
+ * 
+ * @param filename: chemin du fichier image
+ * @param roi: fenêtre demandée, ou NULL pour l'image complète
+ * @param halo: marge à charger autour de la fenêtre (ignorée si roi == NULL)
+ * @param loaded: [sortie] région effectivement chargée (peut être NULL)
+ * @param alpha: [sortie] canal alpha (à libérer avec free_alpha_channel);
+ *               si NULL, l'alpha est traité comme un canal de couleur
+ * @return: image planaire des canaux de couleur, ou NULL en cas d'erreur
+ */
+ImageFloat *load_image_color(const char *filename, const ImageROI *roi, int halo,
+                            ImageROI *loaded, AlphaChannel *alpha);
+
+/**
+ * Libère le plan alpha et remet la structure à zéro
+ */
+void free_alpha_channel(AlphaChannel *alpha);
+
 /**
  * Sauvegarde une image dans un fichier PNG
- * Utilise stb_image_write pour l'écriture
+ * Utilise l'encodeur PNG parallèle (png_write_image)
  * 
  * @param filename: chemin du fichier de sortie
  * @param img: image à sauvegarder
@@ -22,6 +123,59 @@ ImageFloat *load_image(const char *filename);
  */
 int save_image(const char *filename, const ImageFloat *img);
 
+/**
+ * Niveau de compression des PNG sauvegardés (encodeur parallèle de png_stream)
+ * @param level: 0 (stockage, fichiers intermédiaires), 1 (rapide, défaut)
+ *               à 9, -1 = défaut zlib (6)
+ */
+void set_png_compression_level(int level);
+
+/**
+ * Sauvegarde des pixels u8 entrelacés en PNG, sans conversion
+ * 
+ * @param filename: chemin du fichier de sortie
+ * @param data: pixels entrelacés width x height x channels
+ * @return: 1 si succès, 0 sinon
+ */
+int save_image_u8(const char *filename, const unsigned char *data,
+                  int width, int height, int channels);
+
+/**
+ * Sauvegarde une image en PNG en normalisant [min_val, max_val] -> [0, 255]
+ * à la volée (l'image n'est pas modifiée)
+ * 
+ * @param filename: chemin du fichier de sortie
+ * @param img: image à sauvegarder
+ * @param min_val, max_val: plage des valeurs (voir image_minmax)
+ * @return: 1 si succès, 0 sinon
+ */
+int save_image_normalized(const char *filename, const ImageFloat *img,
+                          float min_val, float max_val);
+
+/**
+ * Sauvegarde une image dans le format donné par l'extension du fichier
+ * Formats 8 bits: normalisation [min_val, max_val] -> [0, 255] à la volée;
+ * PPM/PGM et QOI sont encodés par blocs de lignes depuis les plans, sans
+ * tampon entrelacé de l'image entière (PNG et JPEG en demandent un).
+ * Formats flottants (PFM, planaire): valeurs brutes, min_val/max_val ignorés.
+ * L'alpha mis de côté est rétabli en PNG et QOI, ignoré par les autres formats.
+ * 
+ * @param alpha: canal alpha de l'entrée (peut être NULL)
+ * @return: 1 si succès, 0 sinon (format inconnu, nombre de canaux non pris
+ *          en charge: PPM/PGM et PFM demandent 1 ou 3 canaux)
+ */
+int save_image_as(const char *filename, const ImageFloat *img,
+                  float min_val, float max_val, const AlphaChannel *alpha);
+
+/**
+ * Sauvegarde des pixels u8 entrelacés dans le format donné par l'extension
+ * du fichier (pixels écrits tels quels, sans copie pour PPM/PGM, QOI, PNG
+ * et JPEG)
+ * @return: 1 si succès, 0 sinon
+ */
+int save_image_u8_as(const char *filename, const unsigned char *data,
+                     int width, int height, int channels);
+
 /**
  * Crée une image de test synthétique (dégradé + motifs)
  * Utile pour les tests sans avoir besoin d'images externes
@@ -0,0 +1,63 @@
+/**
+ * Appelant C minimal de libdenoise.so (make test_lib)
+ * N'inclut que denoise.h et n'utilise que les fonctions exportées: vérifie
+ * que la bibliothèque partagée se lie et s'exécute sans image_denoise
+ */
+
+#include "denoise.h"
+#include <math.h>
+#include <stdio.h>
+
+int main(void) {
+    if (!denoise_init(2) || denoise_version_major() != DENOISE_VERSION_MAJOR) {
+        fprintf(stderr, "Erreur: libdenoise %s incompatible avec l'en-tête %s\n",
+                denoise_version(), DENOISE_VERSION);
+        return 1;
+    }
+
+    const int w = 64, h = 48, c = 3, size = 7;
+    ImageFloat *img = create_image_float(w, h, c);
+    ImageFloat *spatial = create_image_float_uninit(w, h, c);
+    ImageFloat *separable = create_image_float_uninit(w, h, c);
+    Kernel *kernel = create_gaussian_kernel(size, 2.0f);
+    float *kernel_1d = create_gaussian_kernel_1d(size, 2.0f);
+    ConvWorkspace *ws = create_conv_workspace();
+
+    int ok = img && spatial && separable && kernel && kernel_1d && ws;
+    if (ok) {
+        for (int i = 0; i < w * h * c; i++) img->data[i] = (float)(i % 251);
+        ok = convolve_spatial_into(img, kernel, spatial) &&
+             convolve_separable_into(img, kernel_1d, size, separable, ws);
+    }
+    // Deux moteurs, un même noyau gaussien: résultats quasi identiques
+    double psnr = ok ? image_psnr(spatial, separable, 255.0f) : 0.0;
+    ok = ok && psnr > 60.0;
+    
+    // Aller-retour FFT d'un plan: tampons rendus par la bibliothèque, libérés
+    // par l'appelant avec mkl_free
+    float fft_error = INFINITY;
+    void *spectrum = ok ? fft_2d_forward(img->data, w, h) : NULL;
+    float *plane = spectrum ? fft_2d_backward(spectrum, w, h) : NULL;
+    if (plane) {
+        fft_error = 0.0f;
+        for (int i = 0; i < w * h; i++) {
+            float error = fabsf(plane[i] - img->data[i]);
+            if (!(error <= fft_error)) fft_error = error;
+        }
+    }
+    mkl_free(plane);
+    mkl_free(spectrum);
+    ok = ok && fft_error < 1e-2f;
+    
+    printf("libdenoise %s: %s (PSNR spatial/séparable %.1f dB, aller-retour FFT %.1e)\n",
+           denoise_version(), ok ? "OK" : "ÉCHEC", psnr, fft_error);
+
+    free_conv_workspace(ws);
+    mkl_free(kernel_1d);
+    free_kernel(kernel);
+    free_image_float(separable);
+    free_image_float(spatial);
+    free_image_float(img);
+    denoise_shutdown();
+    return ok ? 0 : 1;
+}
@@ -3,10 +3,19 @@
 #include <string.h>
 #include <time.h>
 #include <sys/time.h>
+#include <sys/resource.h>
 #include "image.h"
 #include "filters.h"
 #include "mkl_ops.h"
 #include "io.h"
+#include "fixed_ops.h"
+#include "color.h"
+#include "strip.h"
+#include "batch.h"
+#include "server.h"
+#include "float_io.h"
+#include "pool.h"
+#include "affinity.h"
 
 // Fonction pour mesurer le temps d'exécution en millisecondes
 double get_time_ms(void) {
@@ -22,6 +31,269 @@ typedef struct {
     ImageFloat *result;
 } BenchResult;
 
+// Une trame du mode flux: variante _into de la méthode demandée
+static int stream_frame(int method_id, const ImageFloat *noisy, const Kernel *kernel_2d,
+                        const float *kernel_1d, int kernel_size,
+                        ImageFloat *output, ConvWorkspace *ws) {
+    switch (method_id) {
+        case 0: return convolve_spatial_into(noisy, kernel_2d, output);
+        case 1: return convolve_spatial_blas_into(noisy, kernel_2d, output, ws);
+        case 2: return convolve_separable_into(noisy, kernel_1d, kernel_size, output, ws);
+        default: return convolve_fft_into(noisy, kernel_2d, output, ws);
+    }
+}
+
+// Mode flux: traite plusieurs trames de même taille avec une destination et
+// un espace de travail réutilisés, et compte les allocations du pool après
+// la première trame (qui dimensionne l'espace de travail)
+static void run_stream(const ImageFloat *noisy, const Kernel *kernel_2d,
+                       const float *kernel_1d, int kernel_size,
+                       const char *method, int frames) {
+    static const char *names[] = {"spatial", "spatial_blas", "separable", "fft"};
+    static const char *labels[] = {"Spatial (naïve)", "Spatial (BLAS)", "Séparable", "FFT"};
+    
+    ImageFloat *output = create_image_float_uninit(noisy->width, noisy->height, noisy->channels);
+    ConvWorkspace *ws = create_conv_workspace();
+    if (!output || !ws) {
+        fprintf(stderr, "Erreur: allocation du mode flux impossible\n");
+        free_image_float(output);
+        free_conv_workspace(ws);
+        return;
+    }
+    
+    printf("\n=== MODE FLUX (%d trames) ===\n\n", frames);
+    
+    for (int m = 0; m < 4; m++) {
+        if (strcmp(method, "all") != 0 && strcmp(method, names[m]) != 0) continue;
+        
+        if (!stream_frame(m, noisy, kernel_2d, kernel_1d, kernel_size, output, ws)) {
+            fprintf(stderr, "Erreur: échec de la méthode %s en mode flux\n", names[m]);
+            continue;
+        }
+        
+        PoolStats before, after;
+        pool_get_stats(&before);
+        double t0 = get_time_ms();
+        for (int f = 1; f < frames; f++) {
+            stream_frame(m, noisy, kernel_2d, kernel_1d, kernel_size, output, ws);
+        }
+        double t1 = get_time_ms();
+        pool_get_stats(&after);
+        
+        size_t allocations = (after.hits + after.misses) - (before.hits + before.misses);
+        printf("  %-18s: %10.2f ms/trame, %zu allocations en régime permanent\n",
+               labels[m], (t1 - t0) / (frames - 1), allocations);
+    }
+    printf("\n");
+    
+    free_conv_workspace(ws);
+    free_image_float(output);
+}
+
+// Écart maximal (en LSB) entre une sortie u8 et la convolution séparable
+// flottante des mêmes pixels u8, arrondie; -1 en cas d'erreur
+static int u8_error_vs_float(const unsigned char *src8, const unsigned char *out8,
+                             int w, int h, int c, const float *kernel_1d, int kernel_size) {
+    ImageFloat *reference = create_image_float_uninit(w, h, c);
+    if (!reference || !convolve_separable_u8_into(src8, w, h, c, kernel_1d, kernel_size,
+                                                  reference, NULL, NULL, NULL)) {
+        free_image_float(reference);
+        return -1;
+    }
+    
+    unsigned char *ref8 = planar_to_interleaved(reference);
+    free_image_float(reference);
+    if (!ref8) return -1;
+    
+    int max_error = 0;
+    for (size_t i = 0; i < (size_t)w * h * c; i++) {
+        int error = abs((int)out8[i] - (int)ref8[i]);
+        if (error > max_error) max_error = error;
+    }
+    
+    free(ref8);
+    return max_error;
+}
+
+// Sauvegarde d'un résultat sous <préfixe>_<nom>.<extension du format>:
+// normalisé [lo, hi] -> [0, 255] (alpha d'origine en PNG et QOI), ou
+// flottants bruts (pfm, planar)
+static void save_result(const char *output_prefix, const char *name, ImageFormat format,
+                        const ImageFloat *img, float lo, float hi, const AlphaChannel *alpha) {
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s_%s.%s", output_prefix, name,
+             image_format_extension(format, img->channels));
+    save_image_as(filename, img, lo, hi, alpha);
+}
+
+// Même chose pour les méthodes qui produisent des pixels u8 entrelacés
+static void save_result_u8(const char *output_prefix, const char *name, ImageFormat format,
+                           const unsigned char *data, int w, int h, int c) {
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s_%s.%s", output_prefix, name,
+             image_format_extension(format, c));
+    save_image_u8_as(filename, data, w, h, c);
+}
+
+// Chemin direct pour une entrée sans bruit ajouté en méthode séparable:
+// la passe horizontale lit les pixels u8 décodés par stb_image, sans image
+// flottante intermédiaire pour l'entrée
+// @return: code de sortie, ou -1 si l'image a un canal alpha (chemin général)
+static int run_direct_u8(const char *input_file, const char *output_prefix,
+                         int kernel_size, float sigma, ImageFormat format) {
+    int width, height, channels;
+    unsigned char *data = load_image_u8(input_file, &width, &height, &channels);
+    if (data && (channels == 2 || channels == 4)) {
+        // L'alpha ne doit pas être flouté: il passe par load_image_color
+        free_image_u8(data);
+        return -1;
+    }
+    float *kernel_1d = create_gaussian_kernel_1d(kernel_size, sigma);
+    ImageFloat *result = data ? create_image_float_uninit(width, height, channels) : NULL;
+    if (!data || !kernel_1d || !result) {
+        fprintf(stderr, "Erreur: impossible de charger l'image ou de créer le noyau\n");
+        free_image_u8(data);
+        if (kernel_1d) mkl_free(kernel_1d);
+        free_image_float(result);
+        return 1;
+    }
+    
+    printf("\n=== DÉBRUITAGE EN COURS (lecture u8 directe) ===\n\n");
+    printf("Méthode 2: Convolution Séparable...\n");
+    float lo = 0.0f, hi = 0.0f;
+    double t0 = get_time_ms();
+    int ok = convolve_separable_u8_into(data, width, height, channels, kernel_1d,
+                                        kernel_size, result, NULL, &lo, &hi);
+    double t1 = get_time_ms();
+    free_image_u8(data);
+    
+    if (ok) {
+        save_result(output_prefix, "separable", format, result, lo, hi, NULL);
+        printf("  → Temps: %.2f ms\n\n", t1 - t0);
+    } else {
+        fprintf(stderr, "Erreur: échec de la convolution séparable\n");
+    }
+    
+    free_image_float(result);
+    mkl_free(kernel_1d);
+    
+    pool_print_stats();
+    
+    if (ok) printf("Traitement terminé avec succès!\n\n");
+    return ok ? 0 : 1;
+}
+
+// Mode bandes: décodage PNG, convolution séparable et encodage PNG ligne à
+// ligne, mémoire indépendante de la hauteur de l'image
+static int run_strips(const char *input_file, const char *output_prefix,
+                      int kernel_size, float sigma, int strip_rows, int png_level) {
+    float *kernel_1d = create_gaussian_kernel_1d(kernel_size, sigma);
+    if (!kernel_1d) {
+        fprintf(stderr, "Erreur: impossible de créer le noyau\n");
+        return 1;
+    }
+    
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s_separable.png", output_prefix);
+    
+    printf("\n=== DÉBRUITAGE PAR BANDES (%d lignes) ===\n\n", strip_rows);
+    printf("Méthode 2: Convolution Séparable, %s -> %s...\n", input_file, filename);
+    StripStats stats;
+    double t0 = get_time_ms();
+    int ok = denoise_png_strips(input_file, filename, kernel_1d, kernel_size, strip_rows,
+                                png_level, &stats);
+    double t1 = get_time_ms();
+    mkl_free(kernel_1d);
+    
+    if (!ok) return 1;
+    
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    double pixels = (double)stats.width * stats.height;
+    printf("  → Image: %dx%d, %d canaux\n", stats.width, stats.height, stats.channels);
+    printf("  → Mémoire de travail: %.1f Mo (image décodée: %.1f Mo), pic RSS: %.1f Mo\n",
+           stats.work_bytes / 1048576.0, pixels * stats.channels / 1048576.0,
+           usage.ru_maxrss / 1024.0);
+    printf("  → Temps: %.2f ms (%.1f Mpixels/s)\n\n", t1 - t0, pixels / ((t1 - t0) * 1e3));
+    
+    printf("Traitement terminé avec succès!\n\n");
+    return 0;
+}
+
+// Mode lots: toutes les images d'un répertoire ou d'une liste dans un seul
+// processus, noyaux et plans créés une fois, images réparties entre workers
+static int run_batch_mode(const char *source, const BatchOptions *options) {
+    int count = 0;
+    char **paths = batch_collect_inputs(source, &count);
+    if (!paths) return 1;
+    
+    printf("\n=== TRAITEMENT PAR LOTS (%d images) ===\n\n", count);
+    if (options->queue_depth > 0) {
+        printf("Méthode: %s, pipeline lecture -> calcul (%d threads) -> écriture, "
+               "files de %d images\n", options->method, options->threads_per_image,
+               options->queue_depth);
+    } else {
+        printf("Méthode: %s, %d workers x %d threads par image\n", options->method,
+               options->workers, options->threads_per_image);
+    }
+    BatchStats stats;
+    int ok = run_batch(paths, count, options, &stats);
+    free_batch_inputs(paths, count);
+    
+    double seconds = stats.wall_ms * 1e-3;
+    printf("  → Images traitées: %d (échecs: %d) en %.2f s\n", stats.images, stats.failed,
+           seconds);
+    printf("  → Débit: %.1f images/s, %.1f Mpixels/s\n", stats.images / seconds,
+           stats.pixels / (seconds * 1e6));
+    printf("  → Latence par image (ms): p50 %.2f, p90 %.2f, p99 %.2f, max %.2f\n",
+           stats.latency_p50, stats.latency_p90, stats.latency_p99, stats.latency_max);
+    printf("  → Temps moyen par étape (ms): lecture %.2f, filtrage %.2f, écriture %.2f\n\n",
+           stats.load_ms, stats.filter_ms, stats.save_ms);
+    
+    if (options->queue_depth > 0) {
+        // Attentes sur les files: l'étape qui n'attend pas est l'étape limitante
+        static const char *labels[] = {"Lecture  ", "Calcul   ", "Écriture "};
+        printf("╔═══════════╦═════════════╦═════════════════╦═════════════════╗\n");
+        printf("║ Étape     ║ Active (ms) ║ Attente entrée  ║ Attente sortie  ║\n");
+        printf("╠═══════════╬═════════════╬═════════════════╬═════════════════╣\n");
+        for (int s = 0; s < 3; s++) {
+            printf("║ %s ║ %10.1f  ║ %12.1f ms ║ %12.1f ms ║\n", labels[s],
+                   stats.stages[s].busy_ms, stats.stages[s].wait_in_ms,
+                   stats.stages[s].wait_out_ms);
+        }
+        printf("╚═══════════╩═════════════╩═════════════════╩═════════════════╝\n\n");
+    }
+    
+    pool_print_stats();
+    
+    if (ok) printf("Traitement terminé avec succès!\n\n");
+    return ok ? 0 : 1;
+}
+
+// Client du service (--serve): une requête, réponse affichée telle quelle
+static int run_client(const char *socket_path, const char *input_file,
+                      const char *output_prefix, const BatchOptions *options, int stop,
+                      int shm) {
+    char reply[1024];
+    int ok;
+    if (input_file) {
+        // Même nom de résultat qu'un appel direct: <préfixe>_<méthode>.<ext>,
+        // extension ajoutée d'après les canaux de l'image lue (options->format)
+        char output_file[512];
+        snprintf(output_file, sizeof(output_file), "%s_%s", output_prefix, options->method);
+        ok = shm ? server_denoise_shm(socket_path, input_file, output_file, options, reply,
+                                      sizeof(reply))
+                 : server_denoise(socket_path, input_file, output_file, options, reply,
+                                  sizeof(reply));
+    } else {
+        ok = server_request(socket_path, stop ? "QUIT" : "STATS", reply, sizeof(reply)) &&
+             strncmp(reply, "OK", 2) == 0;
+        if (!ok && !reply[0]) snprintf(reply, sizeof(reply), "ERR service injoignable");
+    }
+    printf("%s\n", reply);
+    return ok ? 0 : 1;
+}
+
 void print_banner(void) {
     printf("\n");
     printf("╔════════════════════════════════════════════════════════════════╗\n");
@@ -35,13 +307,44 @@ void print_banner(void) {
 void print_usage(const char *prog_name) {
     printf("Usage: %s [options]\n\n", prog_name);
     printf("Options:\n");
-    printf("  -i <file>      Image d'entrée (PNG/JPG)\n");
+    printf("  -i <file>      Image d'entrée (PNG/JPG, ou flottante .pfm/.planar lue par mmap)\n");
     printf("  -o <prefix>    Préfixe pour les fichiers de sortie (défaut: output)\n");
     printf("  -k <size>      Taille du noyau gaussien (défaut: 7)\n");
     printf("  -s <sigma>     Sigma du filtre gaussien (défaut: 2.0)\n");
     printf("  -n <sigma>     Sigma du bruit à ajouter (défaut: 20.0)\n");
+    printf("  --seed <n>     Graine du bruit gaussien (défaut: 42)\n");
     printf("  -t <threads>   Nombre de threads MKL (défaut: auto)\n");
+    printf("  --affinity <m> Placement des threads: none|compact|scatter (défaut: none)\n");
     printf("  -m <method>    Méthode: spatial|spatial_blas|separable|fft|all (défaut: all)\n");
+    printf("                 ou separable_int (virgule fixe Q14, u8 -> u8, hors --roi)\n");
+    printf("                 ou separable_f16 (plans en demi-précision, hors --roi)\n");
+    printf("                 ou separable_packed (pixels entrelacés, sans conversion planaire, hors --roi)\n");
+    printf("                 ou luma_chroma (Y pleine résolution, Cb/Cr à mi-résolution, RGB, hors --roi)\n");
+    printf("  --roi x,y,w,h  Ne débruiter que la fenêtre (x,y) de taille w x h\n");
+    printf("  --frames <n>   Mode flux: n trames avec tampons réutilisés (variantes _into)\n");
+    printf("  --strip <n>    PNG débruité par bandes de n lignes (séparable, sans bruit ajouté,\n");
+    printf("                 mémoire indépendante de la hauteur)\n");
+    printf("  --png-level <n> Compression des PNG: 0 (stockage) | 1 (rapide, défaut) ... 9\n");
+    printf("  --format <f>   Format des résultats: png|ppm|pgm|pfm|planar|qoi|jpg (défaut: png,\n");
+    printf("                 ou extension de -o); pfm et planar gardent les flottants bruts\n");
+    printf("  -q             Pas de message par fichier chargé ou sauvegardé\n");
+    printf("  --batch <src>  Débruiter toutes les images d'un répertoire ou d'une liste (un\n");
+    printf("                 chemin par ligne): <préfixe>_<nom>_<méthode>.<ext>, méthode\n");
+    printf("                 spatial|spatial_blas|separable|fft (défaut: separable)\n");
+    printf("  --workers <n>  Images traitées simultanément en mode lots; les threads (-t)\n");
+    printf("                 sont répartis entre elles (défaut: une image par thread)\n");
+    printf("  --pipeline <n> Mode lots en pipeline: lecture de l'image suivante et écriture\n");
+    printf("                 de la précédente pendant le calcul, files de n images (2: double\n");
+    printf("                 tampon); attentes de chaque étape affichées\n");
+    printf("  --serve <sock> Service persistant sur la socket Unix sock: MKL, noyaux et plans\n");
+    printf("                 FFT gardés entre requêtes; --workers requêtes simultanées (défaut:\n");
+    printf("                 1), threads (-t) répartis entre elles\n");
+    printf("  --client <sock> Débruiter -i par le service (mêmes options et même résultat\n");
+    printf("                 qu'un appel direct); sans -i: statistiques du service\n");
+    printf("  --stop         Avec --client sans -i: arrêter le service\n");
+    printf("  --shm          Avec --client -i: image et résultat passés par mémoire partagée\n");
+    printf("                 POSIX (u8, ou float32 pour .pfm/.planar), sans fichier ni encodage\n");
+    printf("                 côté service\n");
     printf("  --test         Utiliser une image de test synthétique\n");
     printf("  -h             Afficher cette aide\n");
     printf("\n");
@@ -54,9 +357,24 @@ int main(int argc, char *argv[]) {
     int kernel_size = 7;
     float sigma = 2.0f;
     float noise_sigma = 20.0f;
+    unsigned int noise_seed = 42;
     int num_threads = 0;  // Auto
     const char *method = "all";
     int use_test_image = 0;
+    int use_roi = 0;
+    int frames = 0;
+    int strip_rows = 0;
+    ImageFormat format = IMAGE_FORMAT_UNKNOWN;
+    int png_level = 1;
+    const char *batch_source = NULL;
+    int workers = 0;  // Auto: un worker par thread
+    int queue_depth = 0;
+    const char *serve_socket = NULL;
+    const char *client_socket = NULL;
+    int stop_server = 0;
+    int use_shm = 0;
+    AffinityMode affinity = AFFINITY_NONE;
+    ImageROI roi = {0, 0, 0, 0};
     
     // Parsing des arguments
     for (int i = 1; i < argc; i++) {
@@ -70,10 +388,70 @@ int main(int argc, char *argv[]) {
             sigma = atof(argv[++i]);
         } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
             noise_sigma = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            noise_seed = (unsigned int)strtoul(argv[++i], NULL, 10);
         } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
             num_threads = atoi(argv[++i]);
         } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
             method = argv[++i];
+        } else if (strcmp(argv[i], "--roi") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d,%d,%d,%d", &roi.x, &roi.y, &roi.width, &roi.height) != 4 ||
+                roi.width <= 0 || roi.height <= 0) {
+                fprintf(stderr, "Erreur: fenêtre invalide '%s' (attendu: x,y,w,h)\n", argv[i]);
+                return 1;
+            }
+            use_roi = 1;
+        } else if (strcmp(argv[i], "--affinity") == 0 && i + 1 < argc) {
+            if (!affinity_parse(argv[++i], &affinity)) {
+                fprintf(stderr, "Erreur: placement inconnu '%s' (none|compact|scatter)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--strip") == 0 && i + 1 < argc) {
+            strip_rows = atoi(argv[++i]);
+            if (strip_rows < 1) {
+                fprintf(stderr, "Erreur: nombre de lignes par bande invalide '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--png-level") == 0 && i + 1 < argc) {
+            png_level = atoi(argv[++i]);
+            if (png_level < 0 || png_level > 9) {
+                fprintf(stderr, "Erreur: niveau de compression invalide '%s' (0-9)\n", argv[i]);
+                return 1;
+            }
+            set_png_compression_level(png_level);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = image_format_from_name(argv[++i]);
+            if (format == IMAGE_FORMAT_UNKNOWN) {
+                fprintf(stderr, "Erreur: format inconnu '%s' (png|ppm|pgm|pfm|planar|qoi|jpg)\n",
+                        argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_source = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+            if (workers < 1) {
+                fprintf(stderr, "Erreur: nombre de workers invalide '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc) {
+            queue_depth = atoi(argv[++i]);
+            if (queue_depth < 1) {
+                fprintf(stderr, "Erreur: profondeur de file invalide '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serve_socket = argv[++i];
+        } else if (strcmp(argv[i], "--client") == 0 && i + 1 < argc) {
+            client_socket = argv[++i];
+        } else if (strcmp(argv[i], "--stop") == 0) {
+            stop_server = 1;
+        } else if (strcmp(argv[i], "--shm") == 0) {
+            use_shm = 1;
+        } else if (strcmp(argv[i], "-q") == 0) {
+            set_io_quiet(1);
         } else if (strcmp(argv[i], "--test") == 0) {
             use_test_image = 1;
         } else if (strcmp(argv[i], "-h") == 0) {
@@ -82,39 +460,184 @@ int main(int argc, char *argv[]) {
         }
     }
     
+    // -o resultat.qoi: le format vient de l'extension, retirée du préfixe
+    ImageFormat prefix_format = image_format_from_filename(output_prefix);
+    if (prefix_format != IMAGE_FORMAT_UNKNOWN) {
+        *strrchr(output_prefix, '.') = '\0';
+        if (format == IMAGE_FORMAT_UNKNOWN) format = prefix_format;
+    }
+    if (format == IMAGE_FORMAT_UNKNOWN) format = IMAGE_FORMAT_PNG;
+    
+    // Client: le calcul est fait par le service, sans initialiser MKL ici
+    if (client_socket) {
+        if (use_test_image || use_roi || frames > 1 || strip_rows > 0 || batch_source ||
+            (stop_server && input_file) || (use_shm && !input_file)) {
+            fprintf(stderr, "Erreur: --client demande -i (ou rien, ou --stop), sans --test, "
+                            "--roi, --frames, --strip ni --batch; --shm demande -i\n");
+            return 1;
+        }
+        const char *client_method = strcmp(method, "all") == 0 ? "separable" : method;
+        if (!batch_method_supported(client_method)) {
+            fprintf(stderr, "Erreur: méthode '%s' indisponible par le service "
+                            "(spatial|spatial_blas|separable|fft)\n", client_method);
+            return 1;
+        }
+        BatchOptions options = {client_method, kernel_size, sigma, noise_sigma, noise_seed,
+                                format, output_prefix, 1, 1, 0};
+        return run_client(client_socket, input_file, output_prefix, &options, stop_server,
+                          use_shm);
+    }
+    
     print_banner();
     
     // Initialiser MKL
     mkl_init(num_threads);
     mkl_print_info();
     
+    // Épingler les threads avant toute allocation d'image (first-touch NUMA)
+    if (affinity != AFFINITY_NONE) {
+        printf("Threads épinglés: %d\n", affinity_pin_threads(affinity));
+        affinity_print_info();
+    }
+    
+    // Mode lots: -t threads au total, répartis entre les workers
+    if (batch_source) {
+        if (input_file || use_test_image || use_roi || frames > 1 || strip_rows > 0 ||
+            serve_socket) {
+            fprintf(stderr, "Erreur: --batch est incompatible avec -i, --test, --roi, "
+                            "--frames, --strip et --serve\n");
+            return 1;
+        }
+        int total_threads = mkl_get_max_threads();
+        if (queue_depth > 0 && workers > 0) {
+            fprintf(stderr, "Erreur: --pipeline traite une image à la fois, sans --workers\n");
+            return 1;
+        }
+        // Pipeline: un seul worker, toute l'équipe de threads sur chaque image
+        if (workers == 0) workers = queue_depth > 0 ? 1 : total_threads;
+        BatchOptions options = {
+            strcmp(method, "all") == 0 ? "separable" : method, kernel_size, sigma,
+            noise_sigma, noise_seed, format, output_prefix,
+            workers, total_threads / workers > 0 ? total_threads / workers : 1, queue_depth
+        };
+        return run_batch_mode(batch_source, &options);
+    }
+    
+    // Service: --workers requêtes simultanées, -t threads répartis entre elles
+    if (serve_socket) {
+        if (input_file || use_test_image || use_roi || frames > 1 || strip_rows > 0 ||
+            queue_depth > 0) {
+            fprintf(stderr, "Erreur: --serve est incompatible avec -i, --test, --roi, "
+                            "--frames, --strip et --pipeline\n");
+            return 1;
+        }
+        int total_threads = mkl_get_max_threads();
+        int slots = workers > 0 ? workers : 1;
+        return run_server(serve_socket, slots,
+                          total_threads / slots > 0 ? total_threads / slots : 1) ? 0 : 1;
+    }
+    
+    // Mode bandes: l'image d'entrée est débruitée telle quelle, sans être chargée entière
+    if (strip_rows > 0) {
+        if (!input_file || is_float_image_file(input_file) || use_test_image || use_roi ||
+            frames > 1 || format != IMAGE_FORMAT_PNG) {
+            fprintf(stderr, "Erreur: --strip demande -i (PNG) et une sortie PNG, sans --test, "
+                            "--roi ni --frames\n");
+            return 1;
+        }
+        return run_strips(input_file, output_prefix, kernel_size, sigma, strip_rows,
+                          png_level);
+    }
+    
+    // Image externe sans bruit ajouté, méthode séparable: lecture u8 directe
+    if (input_file && !is_float_image_file(input_file) && !use_test_image && !use_roi &&
+        noise_sigma <= 0.0f &&
+        frames <= 1 && strcmp(method, "separable") == 0) {
+        int rc = run_direct_u8(input_file, output_prefix, kernel_size, sigma, format);
+        if (rc >= 0) return rc;
+    }
+    
     // Charger ou créer l'image
+    // En mode ROI, seule la fenêtre et son halo (demi-taille du noyau) sont chargés
     ImageFloat *original = NULL;
-    if (use_test_image || input_file == NULL) {
-        printf("Création d'une image de test synthétique (512x512)...\n");
-        original = create_test_image(512, 512);
+    ImageROI loaded = {0, 0, 0, 0};
+    AlphaChannel alpha = {0, NULL};
+    if (use_test_image || input_file == NULL || is_float_image_file(input_file)) {
+        if (use_test_image || input_file == NULL) {
+            printf("Création d'une image de test synthétique (512x512)...\n");
+            original = create_test_image(512, 512);
+        } else {
+            // Fichier flottant projeté en mémoire: chargé entier, la fenêtre
+            // ne fait que restreindre les pages lues
+            int mapped = 0;
+            printf("Chargement de l'image: %s\n", input_file);
+            original = load_image_float(input_file, &mapped);
+            printf("  → %s\n", mapped ? "Plans projetés depuis le fichier (mmap, sans copie)"
+                                       : "Pixels convertis depuis la projection du fichier");
+        }
+        if (original && use_roi) {
+            if (!roi_clip(&roi, original->width, original->height)) {
+                fprintf(stderr, "Erreur: la fenêtre est hors de l'image\n");
+                free_image_float(original);
+                return 1;
+            }
+            loaded = roi_expand(&roi, kernel_size / 2, original->width, original->height);
+            ImageFloat *region = crop_image(original, &loaded);
+            free_image_float(original);
+            original = region;
+        }
     } else {
         printf("Chargement de l'image: %s\n", input_file);
-        original = load_image(input_file);
+        original = load_image_color(input_file, use_roi ? &roi : NULL, kernel_size / 2,
+                                    &loaded, &alpha);
     }
     
     if (!original) {
         fprintf(stderr, "Erreur: impossible de charger/créer l'image\n");
+        free_alpha_channel(&alpha);
         return 1;
     }
     
     printf("Dimensions: %dx%d, %d canaux\n", original->width, original->height, original->channels);
     
+    // Fenêtre exprimée dans le repère de la région chargée
+    ImageROI window = {0, 0, original->width, original->height};
+    if (use_roi) {
+        window.x = roi.x - loaded.x;
+        window.y = roi.y - loaded.y;
+        window.width = roi.width;
+        window.height = roi.height;
+        printf("Fenêtre: %dx%d à (%d,%d)\n", roi.width, roi.height, roi.x, roi.y);
+        
+        // Les résultats ont la taille de la fenêtre: l'alpha est recadré d'avance
+        if (alpha.plane) {
+            ImageFloat *alpha_window = crop_image(alpha.plane, &window);
+            free_image_float(alpha.plane);
+            alpha.plane = alpha_window;
+        }
+    }
+    
     // Ajouter du bruit gaussien
-    printf("\nAjout de bruit gaussien (sigma=%.1f)...\n", noise_sigma);
+    printf("\nAjout de bruit gaussien (sigma=%.1f, graine=%u)...\n", noise_sigma, noise_seed);
+    // Le clone partage les pixels de l'original; l'original n'étant plus
+    // utilisé, sa libération rend le clone seul propriétaire et le bruit est
+    // ajouté en place, sans copie de l'image
     ImageFloat *noisy = clone_image(original);
-    add_gaussian_noise(noisy, noise_sigma);
+    free_image_float(original);
+    original = NULL;
+    add_gaussian_noise(noisy, noise_sigma, noise_seed);
     normalize_image(noisy);
     
     // Sauvegarder l'image bruitée
-    char filename[256];
-    snprintf(filename, sizeof(filename), "%s_noisy.png", output_prefix);
-    save_image(filename, noisy);
+    if (use_roi) {
+        ImageFloat *noisy_window = crop_image(noisy, &window);
+        if (noisy_window) {
+            save_result(output_prefix, "noisy", format, noisy_window, 0.0f, 255.0f, &alpha);
+            free_image_float(noisy_window);
+        }
+    } else {
+        save_result(output_prefix, "noisy", format, noisy, 0.0f, 255.0f, &alpha);
+    }
     
     // Créer les noyaux
     printf("\nCréation du noyau gaussien (taille=%d, sigma=%.2f)...\n", kernel_size, sigma);
@@ -125,6 +648,7 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Erreur: impossible de créer les noyaux\n");
         free_image_float(original);
         free_image_float(noisy);
+        free_alpha_channel(&alpha);
         return 1;
     }
     
@@ -138,13 +662,14 @@ int main(int argc, char *argv[]) {
     if (strcmp(method, "all") == 0 || strcmp(method, "spatial") == 0) {
         printf("Méthode 1: Convolution Spatiale Directe...\n");
         double t0 = get_time_ms();
-        ImageFloat *result = convolve_spatial(noisy, kernel_2d);
+        ImageFloat *result = use_roi ? convolve_spatial_roi(noisy, kernel_2d, &window)
+                                     : convolve_spatial(noisy, kernel_2d);
         double t1 = get_time_ms();
         
         if (result) {
-            normalize_image(result);
-            snprintf(filename, sizeof(filename), "%s_spatial.png", output_prefix);
-            save_image(filename, result);
+            float lo, hi;
+            image_minmax(result, &lo, &hi);
+            save_result(output_prefix, "spatial", format, result, lo, hi, &alpha);
             
             results[num_results].method_name = "Spatial (naïve)";
             results[num_results].time_ms = t1 - t0;
@@ -159,13 +684,14 @@ int main(int argc, char *argv[]) {
     if (strcmp(method, "all") == 0 || strcmp(method, "spatial_blas") == 0) {
         printf("Méthode 1bis: Convolution Spatiale avec BLAS...\n");
         double t0 = get_time_ms();
-        ImageFloat *result = convolve_spatial_blas(noisy, kernel_2d);
+        ImageFloat *result = use_roi ? convolve_spatial_blas_roi(noisy, kernel_2d, &window)
+                                     : convolve_spatial_blas(noisy, kernel_2d);
         double t1 = get_time_ms();
         
         if (result) {
-            normalize_image(result);
-            snprintf(filename, sizeof(filename), "%s_spatial_blas.png", output_prefix);
-            save_image(filename, result);
+            float lo, hi;
+            image_minmax(result, &lo, &hi);
+            save_result(output_prefix, "spatial_blas", format, result, lo, hi, &alpha);
             
             results[num_results].method_name = "Spatial (BLAS)";
             results[num_results].time_ms = t1 - t0;
@@ -180,13 +706,28 @@ int main(int argc, char *argv[]) {
     if (strcmp(method, "all") == 0 || strcmp(method, "separable") == 0) {
         printf("Méthode 2: Convolution Séparable...\n");
         double t0 = get_time_ms();
-        ImageFloat *result = convolve_separable(noisy, kernel_1d, kernel_size);
+        // Hors ROI, le min/max du résultat est calculé par la passe verticale
+        float lo = 0.0f, hi = 0.0f;
+        int have_range = 0;
+        ImageFloat *result = NULL;
+        if (use_roi) {
+            result = convolve_separable_roi(noisy, kernel_1d, kernel_size, &window);
+        } else {
+            result = create_image_float_uninit(noisy->width, noisy->height, noisy->channels);
+            if (result) {
+                have_range = convolve_separable_into_range(noisy, kernel_1d, kernel_size,
+                                                           result, NULL, &lo, &hi);
+                if (!have_range) {
+                    free_image_float(result);
+                    result = NULL;
+                }
+            }
+        }
         double t1 = get_time_ms();
         
         if (result) {
-            normalize_image(result);
-            snprintf(filename, sizeof(filename), "%s_separable.png", output_prefix);
-            save_image(filename, result);
+            if (!have_range) image_minmax(result, &lo, &hi);
+            save_result(output_prefix, "separable", format, result, lo, hi, &alpha);
             
             results[num_results].method_name = "Séparable";
             results[num_results].time_ms = t1 - t0;
@@ -201,13 +742,14 @@ int main(int argc, char *argv[]) {
     if (strcmp(method, "all") == 0 || strcmp(method, "fft") == 0) {
         printf("Méthode 3: Convolution par FFT...\n");
         double t0 = get_time_ms();
-        ImageFloat *result = convolve_fft(noisy, kernel_2d);
+        ImageFloat *result = use_roi ? convolve_fft_roi(noisy, kernel_2d, &window)
+                                     : convolve_fft(noisy, kernel_2d);
         double t1 = get_time_ms();
         
         if (result) {
-            normalize_image(result);
-            snprintf(filename, sizeof(filename), "%s_fft.png", output_prefix);
-            save_image(filename, result);
+            float lo, hi;
+            image_minmax(result, &lo, &hi);
+            save_result(output_prefix, "fft", format, result, lo, hi, &alpha);
             
             results[num_results].method_name = "FFT";
             results[num_results].time_ms = t1 - t0;
@@ -218,6 +760,156 @@ int main(int argc, char *argv[]) {
         }
     }
     
+    // Méthode 4: Convolution Séparable en virgule fixe (u8 -> u8)
+    if (strcmp(method, "separable_int") == 0 && use_roi) {
+        fprintf(stderr, "Erreur: la méthode separable_int n'est pas disponible avec --roi\n");
+    } else if (strcmp(method, "separable_int") == 0) {
+        printf("Méthode 4: Convolution Séparable en virgule fixe (Q14, u8)...\n");
+        int w = noisy->width, h = noisy->height, c = noisy->channels;
+        // Entrée: les pixels u8 de l'image bruitée sauvegardée
+        unsigned char *src8 = planar_to_interleaved(noisy);
+        unsigned char *dst8 = (unsigned char *)malloc((size_t)w * h * c);
+        
+        double t0 = get_time_ms();
+        int ok = src8 && dst8 &&
+                 convolve_separable_fixed(src8, w, h, c, kernel_1d, kernel_size, dst8);
+        double t1 = get_time_ms();
+        
+        if (ok) {
+            save_result_u8(output_prefix, "separable_int", format, dst8, w, h, c);
+            
+            int max_error = u8_error_vs_float(src8, dst8, w, h, c, kernel_1d, kernel_size);
+            if (max_error >= 0) printf("  → Écart max vs flottant: %d LSB\n", max_error);
+            
+            results[num_results].method_name = "Séparable (Q14, u8)";
+            results[num_results].time_ms = t1 - t0;
+            results[num_results].result = NULL;
+            num_results++;
+            
+            printf("  → Temps: %.2f ms\n\n", t1 - t0);
+        } else {
+            fprintf(stderr, "Erreur: échec de la convolution en virgule fixe\n");
+        }
+        
+        free(src8);
+        free(dst8);
+    }
+    
+    // Méthode 5: Convolution Séparable sur plans demi-précision
+    if (strcmp(method, "separable_f16") == 0 && use_roi) {
+        fprintf(stderr, "Erreur: la méthode separable_f16 n'est pas disponible avec --roi\n");
+    } else if (strcmp(method, "separable_f16") == 0) {
+        printf("Méthode 5: Convolution Séparable, stockage demi-précision (FP16)...\n");
+        ImageHalf *noisy_half = image_to_half(noisy);
+        ImageHalf *output_half = create_image_half(noisy->width, noisy->height, noisy->channels);
+        
+        double t0 = get_time_ms();
+        int ok = noisy_half && output_half &&
+                 convolve_separable_half_into(noisy_half, kernel_1d, kernel_size,
+                                              output_half, NULL);
+        double t1 = get_time_ms();
+        
+        ImageFloat *result = ok ? half_to_image(output_half) : NULL;
+        if (result) {
+            // Perte de précision par rapport au moteur float32
+            ImageFloat *reference = convolve_separable(noisy, kernel_1d, kernel_size);
+            if (reference) {
+                printf("  → PSNR vs float32: %.1f dB\n", image_psnr(result, reference, 255.0f));
+                free_image_float(reference);
+            }
+            
+            float lo, hi;
+            image_minmax(result, &lo, &hi);
+            save_result(output_prefix, "separable_f16", format, result, lo, hi, &alpha);
+            
+            results[num_results].method_name = "Séparable (FP16)";
+            results[num_results].time_ms = t1 - t0;
+            results[num_results].result = result;
+            num_results++;
+            
+            printf("  → Temps: %.2f ms\n\n", t1 - t0);
+        } else {
+            fprintf(stderr, "Erreur: échec de la convolution en demi-précision\n");
+        }
+        
+        free_image_half(noisy_half);
+        free_image_half(output_half);
+    }
+    
+    // Méthode 6: Convolution Séparable sur pixels entrelacés (u8 -> u8)
+    if (strcmp(method, "separable_packed") == 0 && use_roi) {
+        fprintf(stderr, "Erreur: la méthode separable_packed n'est pas disponible avec --roi\n");
+    } else if (strcmp(method, "separable_packed") == 0) {
+        printf("Méthode 6: Convolution Séparable sur pixels entrelacés...\n");
+        int w = noisy->width, h = noisy->height, c = noisy->channels;
+        unsigned char *src8 = planar_to_interleaved(noisy);
+        unsigned char *dst8 = (unsigned char *)malloc((size_t)w * h * c);
+        
+        double t0 = get_time_ms();
+        int ok = src8 && dst8 &&
+                 convolve_separable_packed(src8, w, h, c, kernel_1d, kernel_size, dst8);
+        double t1 = get_time_ms();
+        
+        if (ok) {
+            save_result_u8(output_prefix, "separable_packed", format, dst8, w, h, c);
+            
+            int max_error = u8_error_vs_float(src8, dst8, w, h, c, kernel_1d, kernel_size);
+            if (max_error >= 0) printf("  → Écart max vs planaire: %d LSB\n", max_error);
+            
+            results[num_results].method_name = "Séparable (entrelacé)";
+            results[num_results].time_ms = t1 - t0;
+            results[num_results].result = NULL;
+            num_results++;
+            
+            printf("  → Temps: %.2f ms\n\n", t1 - t0);
+        } else {
+            fprintf(stderr, "Erreur: échec de la convolution entrelacée\n");
+        }
+        
+        free(src8);
+        free(dst8);
+    }
+    
+    // Méthode 7: Luminance pleine résolution, chrominance à mi-résolution
+    if (strcmp(method, "luma_chroma") == 0 && (use_roi || noisy->channels != 3)) {
+        fprintf(stderr, "Erreur: la méthode luma_chroma demande une image RGB, hors --roi\n");
+    } else if (strcmp(method, "luma_chroma") == 0) {
+        printf("Méthode 7: Séparable sur Y (pleine résolution) + Cb/Cr (mi-résolution)...\n");
+        printf("  → Noyau chroma: %dx%d, sigma=%.2f\n", chroma_kernel_size(kernel_size),
+               chroma_kernel_size(kernel_size), sigma * 0.5f);
+        double t0 = get_time_ms();
+        ImageFloat *result = denoise_luma_chroma(noisy, kernel_size, sigma);
+        double t1 = get_time_ms();
+        
+        if (result) {
+            // Écart au filtrage des trois canaux RGB à pleine résolution
+            ImageFloat *reference = convolve_separable(noisy, kernel_1d, kernel_size);
+            if (reference) {
+                printf("  → PSNR vs séparable RGB: %.1f dB\n",
+                       image_psnr(result, reference, 255.0f));
+                free_image_float(reference);
+            }
+            
+            float lo, hi;
+            image_minmax(result, &lo, &hi);
+            save_result(output_prefix, "luma_chroma", format, result, lo, hi, &alpha);
+            
+            results[num_results].method_name = "Séparable (YCbCr 4:2:0)";
+            results[num_results].time_ms = t1 - t0;
+            results[num_results].result = result;
+            num_results++;
+            
+            printf("  → Temps: %.2f ms\n\n", t1 - t0);
+        } else {
+            fprintf(stderr, "Erreur: échec du débruitage luma/chroma\n");
+        }
+    }
+    
+    // Mode flux: mêmes méthodes, tampons réutilisés d'une trame à l'autre
+    if (frames > 1) {
+        run_stream(noisy, kernel_2d, kernel_1d, kernel_size, method, frames);
+    }
+    
     // Afficher le tableau comparatif
     if (num_results > 1) {
         printf("\n=== COMPARAISON DES PERFORMANCES ===\n\n");
@@ -240,9 +932,12 @@ int main(int argc, char *argv[]) {
     }
     free_image_float(original);
     free_image_float(noisy);
+    free_alpha_channel(&alpha);
     free_kernel(kernel_2d);
     mkl_free(kernel_1d);
     
+    pool_print_stats();
+    
     printf("Traitement terminé avec succès!\n\n");
     
     return 0;
@@ -1,6 +1,9 @@
 #include "mkl_ops.h"
+#include "pool.h"
 #include <mkl/mkl.h>
 #include <mkl/mkl_dfti.h>
+#include <omp.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -12,6 +15,8 @@
 void mkl_init(int num_threads) {
     if (num_threads > 0) {
         mkl_set_num_threads(num_threads);
+        // Les boucles OpenMP des moteurs utilisent le même nombre de threads
+        omp_set_num_threads(num_threads);
     }
     printf("MKL initialisé avec %d threads\n", mkl_get_max_threads());
 }
@@ -23,13 +28,69 @@ void mkl_print_info(void) {
     printf("\n");
 }
 
+// ============================================================================
+// Espace de travail des variantes _into
+// ============================================================================
+
+struct ConvWorkspace {
+    float *plane;                   // Plan intermédiaire (séparable) / noyau paddé (FFT)
+    size_t plane_capacity;
+    float *patch;                   // Patch de la convolution BLAS / lignes élargies (u8)
+    size_t patch_capacity;
+    float *spectrum;                // Spectre du canal courant (FFT)
+    size_t spectrum_capacity;
+    float *kernel_spectrum;         // Spectre du noyau (FFT), réutilisé d'un appel à l'autre
+    size_t kernel_spectrum_capacity;
+    float *kernel_weights;          // Copie du noyau dont le spectre est en cache
+    size_t kernel_weights_capacity;
+    int kernel_size;                // Taille du noyau en cache (0 = aucun)
+    DFTI_DESCRIPTOR_HANDLE fft_forward;   // Plans FFT pour fft_width x fft_height
+    DFTI_DESCRIPTOR_HANDLE fft_backward;
+    int fft_width;
+    int fft_height;
+};
+
+ConvWorkspace *create_conv_workspace(void) {
+    return (ConvWorkspace *)calloc(1, sizeof(ConvWorkspace));
+}
+
+void free_conv_workspace(ConvWorkspace *ws) {
+    if (ws) {
+        pool_free(ws->plane);
+        pool_free(ws->patch);
+        pool_free(ws->spectrum);
+        pool_free(ws->kernel_spectrum);
+        pool_free(ws->kernel_weights);
+        if (ws->fft_forward) DftiFreeDescriptor(&ws->fft_forward);
+        if (ws->fft_backward) DftiFreeDescriptor(&ws->fft_backward);
+        free(ws);
+    }
+}
+
+// Garantit qu'un tampon de l'espace de travail contient au moins count floats
+// Le tampon n'est réalloué que s'il est trop petit (aucune allocation en régime permanent)
+static float *ws_reserve(float **buffer, size_t *capacity, size_t count) {
+    if (*capacity < count) {
+        pool_free(*buffer);
+        *buffer = (float *)pool_alloc(count * sizeof(float));
+        *capacity = *buffer ? count : 0;
+    }
+    return *buffer;
+}
+
+// Vérifie que la destination a les dimensions de la source et la rend modifiable
+// (une destination qui partage son tampon, même avec la source, en reçoit une copie privée)
+static int prepare_output(const ImageFloat *img, ImageFloat *output) {
+    return img->width == output->width && img->height == output->height &&
+           img->channels == output->channels && image_make_writable(output);
+}
+
 // ============================================================================
 // MÉTHODE 1: Convolution Spatiale Directe
 // ============================================================================
 
-ImageFloat *convolve_spatial(const ImageFloat *img, const Kernel *kernel) {
-    ImageFloat *output = create_image_float(img->width, img->height, img->channels);
-    if (!output) return NULL;
+int convolve_spatial_into(const ImageFloat *img, const Kernel *kernel, ImageFloat *output) {
+    if (!prepare_output(img, output)) return 0;
     
     int half_size = kernel->size / 2;
     size_t pixels_per_channel = (size_t)img->width * img->height;
@@ -40,6 +101,7 @@ ImageFloat *convolve_spatial(const ImageFloat *img, const Kernel *kernel) {
         float *dst = output->data + c * pixels_per_channel;
         
         // Pour chaque pixel
+        #pragma omp parallel for schedule(static)
         for (int y = 0; y < img->height; y++) {
             for (int x = 0; x < img->width; x++) {
                 float sum = 0.0f;
@@ -62,6 +124,54 @@ ImageFloat *convolve_spatial(const ImageFloat *img, const Kernel *kernel) {
         }
     }
     
+    return 1;
+}
+
+ImageFloat *convolve_spatial(const ImageFloat *img, const Kernel *kernel) {
+    ImageFloat *output = create_image_float_uninit(img->width, img->height, img->channels);
+    if (!output) return NULL;
+    
+    if (!convolve_spatial_into(img, kernel, output)) {
+        free_image_float(output);
+        return NULL;
+    }
+    
+    return output;
+}
+
+ImageFloat *convolve_spatial_roi(const ImageFloat *img, const Kernel *kernel,
+                                 const ImageROI *roi) {
+    ImageFloat *output = create_image_float_uninit(roi->width, roi->height, img->channels);
+    if (!output) return NULL;
+    
+    int half_size = kernel->size / 2;
+    size_t pixels_per_channel = (size_t)img->width * img->height;
+    size_t roi_pixels = (size_t)roi->width * roi->height;
+    
+    for (int c = 0; c < img->channels; c++) {
+        const float *src = img->data + c * pixels_per_channel;
+        float *dst = output->data + c * roi_pixels;
+        
+        // Uniquement les pixels de la fenêtre
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < roi->height; y++) {
+            for (int x = 0; x < roi->width; x++) {
+                float sum = 0.0f;
+                
+                for (int ky = 0; ky < kernel->size; ky++) {
+                    for (int kx = 0; kx < kernel->size; kx++) {
+                        int img_y = clamp(roi->y + y + ky - half_size, 0, img->height - 1);
+                        int img_x = clamp(roi->x + x + kx - half_size, 0, img->width - 1);
+                        sum += src[img_y * img->width + img_x] *
+                               kernel->weights[ky * kernel->size + kx];
+                    }
+                }
+                
+                dst[y * roi->width + x] = sum;
+            }
+        }
+    }
+    
     return output;
 }
 
@@ -90,27 +200,32 @@ static float convolve_pixel_blas(const float *patch, const float *kernel, int si
     return cblas_sdot(size * size, patch, 1, kernel, 1);
 }
 
-ImageFloat *convolve_spatial_blas(const ImageFloat *img, const Kernel *kernel) {
-    ImageFloat *output = create_image_float(img->width, img->height, img->channels);
-    if (!output) return NULL;
+int convolve_spatial_blas_into(const ImageFloat *img, const Kernel *kernel,
+                               ImageFloat *output, ConvWorkspace *ws) {
+    if (!prepare_output(img, output)) return 0;
     
     size_t pixels_per_channel = (size_t)img->width * img->height;
     int patch_size_sq = kernel->size * kernel->size;
     
-    // Buffer temporaire pour le patch (réutilisé pour chaque pixel)
-    float *patch = (float *)mkl_malloc(patch_size_sq * sizeof(float), 64);
-    if (!patch) {
-        free_image_float(output);
-        return NULL;
-    }
+    // Buffer temporaire pour le patch (réutilisé pour chaque pixel), un par thread
+    // Fourni par l'espace de travail s'il y en a un
+    int num_threads = omp_get_max_threads();
+    size_t patch_stride = ((size_t)patch_size_sq + 15) & ~(size_t)15;  // 64 octets
+    size_t patch_total = patch_stride * num_threads;
+    float *own_patch = NULL;
+    float *patches = ws ? ws_reserve(&ws->patch, &ws->patch_capacity, patch_total)
+                        : (own_patch = (float *)pool_alloc(patch_total * sizeof(float)));
+    if (!patches) return 0;
     
     // Pour chaque canal
     for (int c = 0; c < img->channels; c++) {
         const float *src = img->data + c * pixels_per_channel;
         float *dst = output->data + c * pixels_per_channel;
         
-        // Pour chaque pixel
+        // Pour chaque pixel (bandes de lignes réparties entre les threads)
+        #pragma omp parallel for schedule(static)
         for (int y = 0; y < img->height; y++) {
+            float *patch = patches + patch_stride * omp_get_thread_num();
             for (int x = 0; x < img->width; x++) {
                 // Extraire le patch autour du pixel
                 extract_patch(src, img->width, img->height, x, y, kernel->size, patch);
@@ -121,7 +236,57 @@ ImageFloat *convolve_spatial_blas(const ImageFloat *img, const Kernel *kernel) {
         }
     }
     
-    mkl_free(patch);
+    pool_free(own_patch);
+    return 1;
+}
+
+ImageFloat *convolve_spatial_blas(const ImageFloat *img, const Kernel *kernel) {
+    ImageFloat *output = create_image_float_uninit(img->width, img->height, img->channels);
+    if (!output) return NULL;
+    
+    if (!convolve_spatial_blas_into(img, kernel, output, NULL)) {
+        free_image_float(output);
+        return NULL;
+    }
+    
+    return output;
+}
+
+ImageFloat *convolve_spatial_blas_roi(const ImageFloat *img, const Kernel *kernel,
+                                      const ImageROI *roi) {
+    ImageFloat *output = create_image_float_uninit(roi->width, roi->height, img->channels);
+    if (!output) return NULL;
+    
+    size_t pixels_per_channel = (size_t)img->width * img->height;
+    size_t roi_pixels = (size_t)roi->width * roi->height;
+    int patch_size_sq = kernel->size * kernel->size;
+    
+    // Un patch par thread, comme convolve_spatial_blas_into
+    int num_threads = omp_get_max_threads();
+    size_t patch_stride = ((size_t)patch_size_sq + 15) & ~(size_t)15;  // 64 octets
+    float *patches = (float *)pool_alloc(patch_stride * num_threads * sizeof(float));
+    if (!patches) {
+        free_image_float(output);
+        return NULL;
+    }
+    
+    for (int c = 0; c < img->channels; c++) {
+        const float *src = img->data + c * pixels_per_channel;
+        float *dst = output->data + c * roi_pixels;
+        
+        // Uniquement les pixels de la fenêtre
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < roi->height; y++) {
+            float *patch = patches + patch_stride * omp_get_thread_num();
+            for (int x = 0; x < roi->width; x++) {
+                extract_patch(src, img->width, img->height, roi->x + x, roi->y + y,
+                              kernel->size, patch);
+                dst[y * roi->width + x] = convolve_pixel_blas(patch, kernel->weights, kernel->size);
+            }
+        }
+    }
+    
+    pool_free(patches);
     return output;
 }
 // Ce fichier contient la partie 2 de mkl_ops.c
@@ -131,67 +296,469 @@ ImageFloat *convolve_spatial_blas(const ImageFloat *img, const Kernel *kernel) {
 // MÉTHODE 2: Convolution Séparable (continuation de mkl_ops.c)
 // ============================================================================
 
+// Passe 1D sur un seul plan (horizontale ou verticale)
+// Si range n'est pas NULL, range[0..1] est étendu au min/max des valeurs produites
+static void convolve_plane_1d(const float *src, float *dst, int width, int height,
+                              const float *kernel_1d, int kernel_size, int horizontal,
+                              float *range) {
+    int half_size = kernel_size / 2;
+    
+    // Les sommes sont accumulées coefficient par coefficient sur toute la
+    // ligne (boucle interne vectorisable), dans le même ordre que le calcul
+    // pixel par pixel: résultats identiques
+    if (horizontal) {
+        // Convolution horizontale (sur chaque ligne)
+        int inner_end = width - half_size;
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < height; y++) {
+            const float *src_row = src + (size_t)y * width;
+            float *dst_row = dst + (size_t)y * width;
+            
+            // Bords: indices bornés à l'image
+            for (int x = 0; x < width; x++) {
+                if (x == half_size && half_size < inner_end) x = inner_end;
+                float sum = 0.0f;
+                for (int k = 0; k < kernel_size; k++) {
+                    int src_x = clamp(x + k - half_size, 0, width - 1);
+                    sum += src_row[src_x] * kernel_1d[k];
+                }
+                dst_row[x] = sum;
+            }
+            
+            // Intérieur: tous les voisins sont dans la ligne
+            for (int x = half_size; x < inner_end; x++) dst_row[x] = 0.0f;
+            for (int k = 0; k < kernel_size; k++) {
+                const float *shifted = src_row + k - half_size;
+                float weight = kernel_1d[k];
+                #pragma omp simd
+                for (int x = half_size; x < inner_end; x++) {
+                    dst_row[x] += shifted[x] * weight;
+                }
+            }
+        }
+    } else {
+        // Convolution verticale: chaque ligne de sortie accumule les lignes voisines
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < height; y++) {
+            float *dst_row = dst + (size_t)y * width;
+            
+            for (int x = 0; x < width; x++) dst_row[x] = 0.0f;
+            for (int k = 0; k < kernel_size; k++) {
+                int src_y = clamp(y + k - half_size, 0, height - 1);
+                const float *src_row = src + (size_t)src_y * width;
+                float weight = kernel_1d[k];
+                #pragma omp simd
+                for (int x = 0; x < width; x++) {
+                    dst_row[x] += src_row[x] * weight;
+                }
+            }
+        }
+    }
+    
+    // Min/max des lignes produites, pendant qu'elles sont encore en cache
+    // (évite une passe complète de normalize_image sur le résultat)
+    if (range) {
+        float lo = range[0], hi = range[1];
+        #pragma omp parallel for schedule(static) reduction(min:lo) reduction(max:hi)
+        for (int y = 0; y < height; y++) {
+            const float *row = dst + (size_t)y * width;
+            #pragma omp simd reduction(min:lo) reduction(max:hi)
+            for (int x = 0; x < width; x++) {
+                lo = row[x] < lo ? row[x] : lo;
+                hi = row[x] > hi ? row[x] : hi;
+            }
+        }
+        range[0] = lo;
+        range[1] = hi;
+    }
+}
+
+int convolve_separable_1d_into(const ImageFloat *img, const float *kernel_1d,
+                               int kernel_size, int horizontal, ImageFloat *output) {
+    if (!prepare_output(img, output)) return 0;
+    
+    size_t pixels_per_channel = (size_t)img->width * img->height;
+    
+    // Pour chaque canal
+    for (int c = 0; c < img->channels; c++) {
+        convolve_plane_1d(img->data + c * pixels_per_channel,
+                          output->data + c * pixels_per_channel,
+                          img->width, img->height, kernel_1d, kernel_size, horizontal, NULL);
+    }
+    
+    return 1;
+}
+
 ImageFloat *convolve_separable_1d(const ImageFloat *img, const float *kernel_1d, 
                                    int kernel_size, int horizontal) {
-    ImageFloat *output = create_image_float(img->width, img->height, img->channels);
+    ImageFloat *output = create_image_float_uninit(img->width, img->height, img->channels);
     if (!output) return NULL;
     
-    int half_size = kernel_size / 2;
+    if (!convolve_separable_1d_into(img, kernel_1d, kernel_size, horizontal, output)) {
+        free_image_float(output);
+        return NULL;
+    }
+    
+    return output;
+}
+
+int convolve_separable_into_range(const ImageFloat *img, const float *kernel_1d,
+                                  int kernel_size, ImageFloat *output, ConvWorkspace *ws,
+                                  float *min_val, float *max_val) {
+    if (!prepare_output(img, output)) return 0;
+    
     size_t pixels_per_channel = (size_t)img->width * img->height;
     
-    // Pour chaque canal
+    // Un seul plan intermédiaire suffit: les canaux sont traités l'un après l'autre
+    float *own_plane = NULL;
+    float *temp = ws ? ws_reserve(&ws->plane, &ws->plane_capacity, pixels_per_channel)
+                     : (own_plane = (float *)pool_alloc(pixels_per_channel * sizeof(float)));
+    if (!temp) return 0;
+    
+    // Plage des valeurs produites, si demandée
+    float range[2] = {INFINITY, -INFINITY};
+    float *track = (min_val && max_val) ? range : NULL;
+    
     for (int c = 0; c < img->channels; c++) {
-        const float *src = img->data + c * pixels_per_channel;
-        float *dst = output->data + c * pixels_per_channel;
+        // Première passe: convolution horizontale
+        convolve_plane_1d(img->data + c * pixels_per_channel, temp,
+                          img->width, img->height, kernel_1d, kernel_size, 1, NULL);
         
-        if (horizontal) {
-            // Convolution horizontale (sur chaque ligne)
-            for (int y = 0; y < img->height; y++) {
-                for (int x = 0; x < img->width; x++) {
-                    float sum = 0.0f;
-                    
-                    for (int k = 0; k < kernel_size; k++) {
-                        int src_x = clamp(x + k - half_size, 0, img->width - 1);
-                        sum += src[y * img->width + src_x] * kernel_1d[k];
-                    }
-                    
-                    dst[y * img->width + x] = sum;
+        // Deuxième passe: convolution verticale
+        convolve_plane_1d(temp, output->data + c * pixels_per_channel,
+                          img->width, img->height, kernel_1d, kernel_size, 0, track);
+    }
+    
+    if (track) {
+        *min_val = range[0];
+        *max_val = range[1];
+    }
+    
+    pool_free(own_plane);
+    return 1;
+}
+
+int convolve_separable_into(const ImageFloat *img, const float *kernel_1d, int kernel_size,
+                            ImageFloat *output, ConvWorkspace *ws) {
+    return convolve_separable_into_range(img, kernel_1d, kernel_size, output, ws, NULL, NULL);
+}
+
+// Passe horizontale d'une ligne entrelacée: les voisins d'un échantillon sont
+// à un multiple de channels, chaque canal occupant ses propres voies SIMD
+static void packed_row_horizontal(const unsigned char *src, int width, int channels,
+                                  const float *kernel_1d, int kernel_size,
+                                  float *pad, float *dst) {
+    int half_size = kernel_size / 2;
+    int length = width * channels;
+    
+    // Élargissement u8 -> float, pixels de bord répliqués
+    for (int i = 0; i < length; i++) pad[half_size * channels + i] = (float)src[i];
+    for (int p = 0; p < half_size; p++) {
+        for (int ch = 0; ch < channels; ch++) {
+            pad[p * channels + ch] = pad[half_size * channels + ch];
+            pad[(half_size + width + p) * channels + ch] =
+                pad[(half_size + width - 1) * channels + ch];
+        }
+    }
+    
+    for (int i = 0; i < length; i++) dst[i] = 0.0f;
+    for (int k = 0; k < kernel_size; k++) {
+        const float *shifted = pad + k * channels;
+        float weight = kernel_1d[k];
+        #pragma omp simd
+        for (int i = 0; i < length; i++) {
+            dst[i] += shifted[i] * weight;
+        }
+    }
+}
+
+int convolve_separable_packed(const unsigned char *src, int width, int height, int channels,
+                              const float *kernel_1d, int kernel_size, unsigned char *dst) {
+    if (!src || !dst || src == dst || width < 1 || height < 1 || channels < 1) return 0;
+    
+    int half_size = kernel_size / 2;
+    size_t length = (size_t)width * channels;
+    
+    // Par thread: ligne paddée, accumulateur et anneau des 2 * half + 1 dernières
+    // lignes horizontales (aucun plan intermédiaire complet)
+    size_t pad_len = ((size_t)(width + 2 * half_size) * channels + 15) & ~(size_t)15;
+    size_t row_len = (length + 15) & ~(size_t)15;
+    int ring_rows = 2 * half_size + 1;
+    size_t per_thread = pad_len + row_len * (ring_rows + 1);
+    int num_threads = omp_get_max_threads();
+    float *scratch = (float *)pool_alloc(per_thread * num_threads * sizeof(float));
+    if (!scratch) return 0;
+    
+    // Bandes de lignes contiguës, une par thread
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int tid = omp_get_thread_num();
+        int nth = omp_get_num_threads();
+        int y0 = (int)((long long)height * tid / nth);
+        int y1 = (int)((long long)height * (tid + 1) / nth);
+        
+        float *pad = scratch + per_thread * tid;
+        float *acc = pad + pad_len;
+        float *ring = acc + row_len;
+        
+        // La ligne r (non bornée) occupe l'emplacement (r - (y0 - half)) % ring_rows
+        for (int r = y0 - half_size; r < y0 + half_size && y0 < y1; r++) {
+            int slot = (r - (y0 - half_size)) % ring_rows;
+            int src_y = clamp(r, 0, height - 1);
+            packed_row_horizontal(src + (size_t)src_y * length, width, channels,
+                                  kernel_1d, kernel_size, pad, ring + row_len * slot);
+        }
+        
+        for (int y = y0; y < y1; y++) {
+            // Ligne entrante: y + half
+            int r = y + half_size;
+            packed_row_horizontal(src + (size_t)clamp(r, 0, height - 1) * length, width,
+                                  channels, kernel_1d, kernel_size, pad,
+                                  ring + row_len * ((r - (y0 - half_size)) % ring_rows));
+            
+            for (size_t i = 0; i < length; i++) acc[i] = 0.0f;
+            for (int k = 0; k < kernel_size; k++) {
+                int slot = (y + k - half_size - (y0 - half_size)) % ring_rows;
+                const float *row = ring + row_len * slot;
+                float weight = kernel_1d[k];
+                #pragma omp simd
+                for (size_t i = 0; i < length; i++) {
+                    acc[i] += row[i] * weight;
                 }
             }
-        } else {
-            // Convolution verticale (sur chaque colonne)
-            for (int y = 0; y < img->height; y++) {
-                for (int x = 0; x < img->width; x++) {
-                    float sum = 0.0f;
-                    
-                    for (int k = 0; k < kernel_size; k++) {
-                        int src_y = clamp(y + k - half_size, 0, img->height - 1);
-                        sum += src[src_y * img->width + x] * kernel_1d[k];
-                    }
-                    
-                    dst[y * img->width + x] = sum;
+            
+            // Même arrondi que planar_to_interleaved
+            unsigned char *out = dst + (size_t)y * length;
+            for (size_t i = 0; i < length; i++) {
+                out[i] = (unsigned char)(clampf(acc[i], 0.0f, 255.0f) + 0.5f);
+            }
+        }
+    }
+    
+    pool_free(scratch);
+    return 1;
+}
+
+int convolve_separable_half_into(const ImageHalf *img, const float *kernel_1d, int kernel_size,
+                                 ImageHalf *output, ConvWorkspace *ws) {
+    if (img->width != output->width || img->height != output->height ||
+        img->channels != output->channels) {
+        return 0;
+    }
+    
+    int width = img->width, height = img->height;
+    int half_size = kernel_size / 2;
+    size_t pixels_per_channel = (size_t)width * height;
+    
+    // Plan intermédiaire binary16 + par thread: ligne élargie paddée et accumulateur float
+    size_t pad_stride = ((size_t)width + 2 * half_size + 15) & ~(size_t)15;
+    size_t acc_stride = ((size_t)width + 15) & ~(size_t)15;
+    size_t rows_total = (pad_stride + acc_stride) * omp_get_max_threads();
+    size_t plane_floats = (pixels_per_channel + 1) / 2;
+    float *own_plane = NULL, *own_rows = NULL;
+    float *plane = ws ? ws_reserve(&ws->plane, &ws->plane_capacity, plane_floats)
+                      : (own_plane = (float *)pool_alloc(plane_floats * sizeof(float)));
+    float *rows = ws ? ws_reserve(&ws->patch, &ws->patch_capacity, rows_total)
+                     : (own_rows = (float *)pool_alloc(rows_total * sizeof(float)));
+    if (!plane || !rows) {
+        pool_free(own_plane);
+        pool_free(own_rows);
+        return 0;
+    }
+    uint16_t *temp = (uint16_t *)plane;
+    
+    for (int c = 0; c < img->channels; c++) {
+        const uint16_t *src = img->data + c * pixels_per_channel;
+        uint16_t *dst = output->data + c * pixels_per_channel;
+        
+        // Première passe: horizontale (chargement binary16 -> float, calcul float32)
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < height; y++) {
+            float *row = rows + (pad_stride + acc_stride) * omp_get_thread_num();
+            float *acc = row + pad_stride;
+            
+            half_to_float_row(src + (size_t)y * width, width, row + half_size);
+            for (int k = 0; k < half_size; k++) {
+                row[k] = row[half_size];
+                row[half_size + width + k] = row[half_size + width - 1];
+            }
+            
+            for (int x = 0; x < width; x++) acc[x] = 0.0f;
+            for (int k = 0; k < kernel_size; k++) {
+                float weight = kernel_1d[k];
+                #pragma omp simd
+                for (int x = 0; x < width; x++) {
+                    acc[x] += row[x + k] * weight;
                 }
             }
+            float_to_half_row(acc, width, temp + (size_t)y * width);
+        }
+        
+        // Deuxième passe: verticale, ligne par ligne dans un accumulateur float
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < height; y++) {
+            float *row = rows + (pad_stride + acc_stride) * omp_get_thread_num();
+            float *acc = row + pad_stride;
+            
+            for (int x = 0; x < width; x++) acc[x] = 0.0f;
+            for (int k = 0; k < kernel_size; k++) {
+                int src_y = clamp(y + k - half_size, 0, height - 1);
+                half_to_float_row(temp + (size_t)src_y * width, width, row);
+                float weight = kernel_1d[k];
+                #pragma omp simd
+                for (int x = 0; x < width; x++) {
+                    acc[x] += row[x] * weight;
+                }
+            }
+            float_to_half_row(acc, width, dst + (size_t)y * width);
         }
     }
     
-    return output;
+    pool_free(own_plane);
+    pool_free(own_rows);
+    return 1;
+}
+
+int convolve_separable_u8_into(const unsigned char *data, int width, int height, int channels,
+                               const float *kernel_1d, int kernel_size, ImageFloat *output,
+                               ConvWorkspace *ws, float *min_val, float *max_val) {
+    if (output->width != width || output->height != height ||
+        output->channels != channels || !image_make_writable(output)) {
+        return 0;
+    }
+    
+    int half_size = kernel_size / 2;
+    size_t pixels_per_channel = (size_t)width * height;
+    
+    // Plan intermédiaire unique + une ligne élargie (bords répliqués) par thread
+    size_t row_stride = ((size_t)width + 2 * half_size + 15) & ~(size_t)15;
+    size_t rows_total = row_stride * omp_get_max_threads();
+    float *own_plane = NULL, *own_rows = NULL;
+    float *temp = ws ? ws_reserve(&ws->plane, &ws->plane_capacity, pixels_per_channel)
+                     : (own_plane = (float *)pool_alloc(pixels_per_channel * sizeof(float)));
+    float *rows = ws ? ws_reserve(&ws->patch, &ws->patch_capacity, rows_total)
+                     : (own_rows = (float *)pool_alloc(rows_total * sizeof(float)));
+    if (!temp || !rows) {
+        pool_free(own_plane);
+        pool_free(own_rows);
+        return 0;
+    }
+    
+    float range[2] = {INFINITY, -INFINITY};
+    float *track = (min_val && max_val) ? range : NULL;
+    
+    for (int c = 0; c < channels; c++) {
+        // Première passe: horizontale, lue directement dans le tampon u8 entrelacé
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < height; y++) {
+            float *row = rows + row_stride * omp_get_thread_num();
+            const unsigned char *src = data + (size_t)y * width * channels + c;
+            
+            // Élargissement u8 -> float du canal c, bords répliqués (= clamp)
+            for (int x = 0; x < width; x++) {
+                row[half_size + x] = (float)src[(size_t)x * channels];
+            }
+            for (int k = 0; k < half_size; k++) {
+                row[k] = row[half_size];
+                row[half_size + width + k] = row[half_size + width - 1];
+            }
+            
+            float *dst = temp + (size_t)y * width;
+            for (int x = 0; x < width; x++) {
+                float sum = 0.0f;
+                for (int k = 0; k < kernel_size; k++) {
+                    sum += row[x + k] * kernel_1d[k];
+                }
+                dst[x] = sum;
+            }
+        }
+        
+        // Deuxième passe: verticale, vers le plan de sortie
+        convolve_plane_1d(temp, output->data + c * pixels_per_channel,
+                          width, height, kernel_1d, kernel_size, 0, track);
+    }
+    
+    if (track) {
+        *min_val = range[0];
+        *max_val = range[1];
+    }
+    
+    pool_free(own_plane);
+    pool_free(own_rows);
+    return 1;
 }
 
 ImageFloat *convolve_separable(const ImageFloat *img, const float *kernel_1d, 
                                 int kernel_size) {
-    // Première passe: convolution horizontale
-    ImageFloat *temp = convolve_separable_1d(img, kernel_1d, kernel_size, 1);
-    if (!temp) return NULL;
+    ImageFloat *output = create_image_float_uninit(img->width, img->height, img->channels);
+    if (!output) return NULL;
     
-    // Deuxième passe: convolution verticale
-    ImageFloat *result = convolve_separable_1d(temp, kernel_1d, kernel_size, 0);
+    if (!convolve_separable_into(img, kernel_1d, kernel_size, output, NULL)) {
+        free_image_float(output);
+        return NULL;
+    }
     
-    // Libérer l'image temporaire
-    free_image_float(temp);
+    return output;
+}
+
+ImageFloat *convolve_separable_roi(const ImageFloat *img, const float *kernel_1d,
+                                   int kernel_size, const ImageROI *roi) {
+    int half_size = kernel_size / 2;
     
-    return result;
+    // Lignes nécessaires à la passe verticale: fenêtre + halo, bornées à l'image
+    int row0 = clamp(roi->y - half_size, 0, img->height - 1);
+    int row1 = clamp(roi->y + roi->height - 1 + half_size, 0, img->height - 1);
+    int rows = row1 - row0 + 1;
+    
+    ImageFloat *temp = create_image_float_uninit(roi->width, rows, img->channels);
+    ImageFloat *output = create_image_float_uninit(roi->width, roi->height, img->channels);
+    if (!temp || !output) {
+        free_image_float(temp);
+        free_image_float(output);
+        return NULL;
+    }
+    
+    size_t pixels_per_channel = (size_t)img->width * img->height;
+    size_t temp_pixels = (size_t)roi->width * rows;
+    size_t roi_pixels = (size_t)roi->width * roi->height;
+    
+    for (int c = 0; c < img->channels; c++) {
+        const float *src = img->data + c * pixels_per_channel;
+        float *tmp = temp->data + c * temp_pixels;
+        float *dst = output->data + c * roi_pixels;
+        
+        // Passe horizontale: colonnes de la fenêtre, lignes row0..row1
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < rows; y++) {
+            const float *src_row = src + (size_t)(row0 + y) * img->width;
+            for (int x = 0; x < roi->width; x++) {
+                float sum = 0.0f;
+                for (int k = 0; k < kernel_size; k++) {
+                    int src_x = clamp(roi->x + x + k - half_size, 0, img->width - 1);
+                    sum += src_row[src_x] * kernel_1d[k];
+                }
+                tmp[y * roi->width + x] = sum;
+            }
+        }
+        
+        // Passe verticale: uniquement les lignes de la fenêtre
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < roi->height; y++) {
+            for (int x = 0; x < roi->width; x++) {
+                float sum = 0.0f;
+                for (int k = 0; k < kernel_size; k++) {
+                    int src_y = clamp(roi->y + y + k - half_size, 0, img->height - 1);
+                    sum += tmp[(src_y - row0) * roi->width + x] * kernel_1d[k];
+                }
+                dst[y * roi->width + x] = sum;
+            }
+        }
+    }
+    
+    free_image_float(temp);
+    return output;
 }
+
 // Ce fichier contient la partie 3 de mkl_ops.c
 // MÉTHODE 3: Convolution par FFT
 
@@ -199,32 +766,46 @@ ImageFloat *convolve_separable(const ImageFloat *img, const float *kernel_1d,
 // MÉTHODE 3: Convolution par FFT (continuation de mkl_ops.c)
 // ============================================================================
 
-void *fft_2d_forward(const float *img, int width, int height) {
+// Crée et valide un plan FFT réelle 2D (hors-place, spectre complexe)
+// forward = 1: réel -> complexe, forward = 0: complexe -> réel
+static DFTI_DESCRIPTOR_HANDLE create_fft_descriptor(int width, int height, int forward) {
     DFTI_DESCRIPTOR_HANDLE handle = NULL;
     MKL_LONG dims[2] = {(MKL_LONG)height, (MKL_LONG)width};
     
+    // Strides de l'image réelle et du spectre complexe
+    // Largeur spectrale: (width/2 + 1) pour FFT réelle
+    MKL_LONG real_strides[3] = {0, (MKL_LONG)width, 1};
+    MKL_LONG complex_strides[3] = {0, (MKL_LONG)(width/2 + 1), 1};
+    
     // 1. Créer le descripteur FFT Réelle 2D
-    DftiCreateDescriptor(&handle, DFTI_SINGLE, DFTI_REAL, 2, dims);
+    if (DftiCreateDescriptor(&handle, DFTI_SINGLE, DFTI_REAL, 2, dims) != DFTI_NO_ERROR) {
+        return NULL;
+    }
     
     // 2. Configuration Out-of-place (résultat dans un buffer séparé)
     DftiSetValue(handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
     
-    // 3. Format de sortie: complexe complet
+    // 3. Format du spectre: complexe complet
     DftiSetValue(handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
     
-    // 4. Strides d'entrée (image réelle)
-    MKL_LONG i_strides[3] = {0, (MKL_LONG)width, 1};
-    DftiSetValue(handle, DFTI_INPUT_STRIDES, i_strides);
+    // 4. Strides d'entrée et de sortie selon le sens
+    DftiSetValue(handle, DFTI_INPUT_STRIDES, forward ? real_strides : complex_strides);
+    DftiSetValue(handle, DFTI_OUTPUT_STRIDES, forward ? complex_strides : real_strides);
     
-    // 5. Strides de sortie (spectre complexe)
-    // Largeur spectrale: (width/2 + 1) pour FFT réelle
-    MKL_LONG o_strides[3] = {0, (MKL_LONG)(width/2 + 1), 1};
-    DftiSetValue(handle, DFTI_OUTPUT_STRIDES, o_strides);
+    // 5. Commit (compilation du plan FFT pour optimisation)
+    if (DftiCommitDescriptor(handle) != DFTI_NO_ERROR) {
+        DftiFreeDescriptor(&handle);
+        return NULL;
+    }
     
-    // 6. Commit (compilation du plan FFT pour optimisation)
-    DftiCommitDescriptor(handle);
+    return handle;
+}
+
+void *fft_2d_forward(const float *img, int width, int height) {
+    DFTI_DESCRIPTOR_HANDLE handle = create_fft_descriptor(width, height, 1);
+    if (!handle) return NULL;
     
-    // 7. Allocation du résultat complexe
+    // Allocation du résultat complexe
     // Format: [real0, imag0, real1, imag1, ...]
     size_t complex_count = (size_t)height * (width/2 + 1);
     float *fft_result = (float *)mkl_malloc(complex_count * 2 * sizeof(float), 64);
@@ -234,33 +815,18 @@ void *fft_2d_forward(const float *img, int width, int height) {
         return NULL;
     }
     
-    // 8. Calcul de la FFT Forward
+    // Calcul de la FFT Forward
     DftiComputeForward(handle, (void *)img, fft_result);
     
-    // 9. Libérer le descripteur
+    // Libérer le descripteur
     DftiFreeDescriptor(&handle);
     
     return fft_result;
 }
 
 float *fft_2d_backward(void *fft_data, int width, int height) {
-    DFTI_DESCRIPTOR_HANDLE handle = NULL;
-    MKL_LONG dims[2] = {(MKL_LONG)height, (MKL_LONG)width};
-    
-    // Créer et configurer le descripteur
-    DftiCreateDescriptor(&handle, DFTI_SINGLE, DFTI_REAL, 2, dims);
-    DftiSetValue(handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-    DftiSetValue(handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-    
-    // Strides d'entrée (spectre complexe)
-    MKL_LONG i_strides[3] = {0, (MKL_LONG)(width/2 + 1), 1};
-    DftiSetValue(handle, DFTI_INPUT_STRIDES, i_strides);
-    
-    // Strides de sortie (image réelle)
-    MKL_LONG o_strides[3] = {0, (MKL_LONG)width, 1};
-    DftiSetValue(handle, DFTI_OUTPUT_STRIDES, o_strides);
-    
-    DftiCommitDescriptor(handle);
+    DFTI_DESCRIPTOR_HANDLE handle = create_fft_descriptor(width, height, 0);
+    if (!handle) return NULL;
     
     // Allocation pour le résultat réel
     size_t real_size = (size_t)height * width;
@@ -302,61 +868,134 @@ void fft_multiply(void *fft1, const void *fft2, int width, int height) {
     }
 }
 
-ImageFloat *convolve_fft(const ImageFloat *img, const Kernel *kernel) {
-    ImageFloat *output = create_image_float(img->width, img->height, img->channels);
-    if (!output) return NULL;
+// Prépare les plans FFT de l'espace de travail pour les dimensions données
+static int ws_prepare_fft(ConvWorkspace *ws, int width, int height) {
+    if (ws->fft_forward && ws->fft_width == width && ws->fft_height == height) {
+        return 1;
+    }
     
-    // Préparer le noyau zéro-paddé aux dimensions de l'image
-    float *kernel_padded = (float *)mkl_calloc(img->width * img->height, sizeof(float), 64);
-    if (!kernel_padded) {
-        free_image_float(output);
-        return NULL;
+    if (ws->fft_forward) DftiFreeDescriptor(&ws->fft_forward);
+    if (ws->fft_backward) DftiFreeDescriptor(&ws->fft_backward);
+    ws->kernel_size = 0;  // Le spectre en cache dépend des dimensions
+    
+    ws->fft_forward = create_fft_descriptor(width, height, 1);
+    ws->fft_backward = create_fft_descriptor(width, height, 0);
+    ws->fft_width = width;
+    ws->fft_height = height;
+    
+    return ws->fft_forward && ws->fft_backward;
+}
+
+// Calcule (ou réutilise) le spectre du noyau zéro-paddé aux dimensions de l'image
+static int ws_prepare_kernel_spectrum(ConvWorkspace *ws, const Kernel *kernel,
+                                      int width, int height) {
+    size_t kernel_count = (size_t)kernel->size * kernel->size;
+    size_t complex_count = (size_t)height * (width/2 + 1);
+    
+    // Spectre déjà calculé pour ce noyau et ces dimensions
+    if (ws->kernel_size == kernel->size &&
+        memcmp(ws->kernel_weights, kernel->weights, kernel_count * sizeof(float)) == 0) {
+        return 1;
     }
     
+    float *kernel_padded = ws_reserve(&ws->plane, &ws->plane_capacity, (size_t)width * height);
+    float *weights = ws_reserve(&ws->kernel_weights, &ws->kernel_weights_capacity, kernel_count);
+    float *spectrum = ws_reserve(&ws->kernel_spectrum, &ws->kernel_spectrum_capacity,
+                                 complex_count * 2);
+    if (!kernel_padded || !weights || !spectrum) return 0;
+    
+    memset(kernel_padded, 0, (size_t)width * height * sizeof(float));
+    
     // Copier le noyau au centre (décalé pour éviter les artefacts circulaires)
     int k_half = kernel->size / 2;
     for (int y = 0; y < kernel->size; y++) {
         for (int x = 0; x < kernel->size; x++) {
             // Placer le centre du noyau à l'origine (coin supérieur gauche)
-            int dst_y = (y - k_half + img->height) % img->height;
-            int dst_x = (x - k_half + img->width) % img->width;
-            kernel_padded[dst_y * img->width + dst_x] = 
-                kernel->weights[y * kernel->size + x];
+            int dst_y = (y - k_half + height) % height;
+            int dst_x = (x - k_half + width) % width;
+            kernel_padded[dst_y * width + dst_x] = kernel->weights[y * kernel->size + x];
         }
     }
     
-    // FFT du noyau (calculée une seule fois, réutilisée pour tous les canaux)
-    void *kernel_fft = fft_2d_forward(kernel_padded, img->width, img->height);
-    mkl_free(kernel_padded);
+    // FFT du noyau (calculée une seule fois, réutilisée pour tous les canaux et appels)
+    DftiComputeForward(ws->fft_forward, kernel_padded, spectrum);
     
-    if (!kernel_fft) {
-        free_image_float(output);
-        return NULL;
+    memcpy(weights, kernel->weights, kernel_count * sizeof(float));
+    ws->kernel_size = kernel->size;
+    
+    return 1;
+}
+
+int convolve_fft_into(const ImageFloat *img, const Kernel *kernel,
+                      ImageFloat *output, ConvWorkspace *ws) {
+    if (!prepare_output(img, output)) return 0;
+    
+    // Espace de travail temporaire si l'appelant n'en fournit pas
+    ConvWorkspace *own_ws = NULL;
+    if (!ws) {
+        ws = own_ws = create_conv_workspace();
+        if (!ws) return 0;
     }
     
-    // Pour chaque canal RGB
+    int ok = ws_prepare_fft(ws, img->width, img->height) &&
+             ws_prepare_kernel_spectrum(ws, kernel, img->width, img->height);
+    
     size_t pixels_per_channel = (size_t)img->width * img->height;
-    for (int c = 0; c < img->channels; c++) {
-        const float *src = img->data + c * pixels_per_channel;
-        float *dst = output->data + c * pixels_per_channel;
-        
-        // 1. FFT de l'image (canal courant)
-        void *img_fft = fft_2d_forward(src, img->width, img->height);
-        if (!img_fft) continue;
-        
-        // 2. Multiplication dans le domaine fréquentiel
-        fft_multiply(img_fft, kernel_fft, img->width, img->height);
+    size_t complex_count = (size_t)img->height * (img->width/2 + 1);
+    float *spectrum = ok ? ws_reserve(&ws->spectrum, &ws->spectrum_capacity, complex_count * 2)
+                         : NULL;
+    
+    if (spectrum) {
+        float scale = 1.0f / (float)(img->width * img->height);
         
-        // 3. IFFT pour revenir au domaine spatial
-        float *result = fft_2d_backward(img_fft, img->width, img->height);
-        if (result) {
-            memcpy(dst, result, pixels_per_channel * sizeof(float));
-            mkl_free(result);
+        // Pour chaque canal RGB
+        for (int c = 0; c < img->channels; c++) {
+            const float *src = img->data + c * pixels_per_channel;
+            float *dst = output->data + c * pixels_per_channel;
+            
+            // 1. FFT de l'image (canal courant)
+            DftiComputeForward(ws->fft_forward, (void *)src, spectrum);
+            
+            // 2. Multiplication dans le domaine fréquentiel
+            fft_multiply(spectrum, ws->kernel_spectrum, img->width, img->height);
+            
+            // 3. IFFT directement dans le plan de sortie, puis normalisation
+            DftiComputeBackward(ws->fft_backward, spectrum, dst);
+            cblas_sscal((MKL_INT)pixels_per_channel, scale, dst, 1);
         }
-        
-        mkl_free(img_fft);
     }
     
-    mkl_free(kernel_fft);
+    free_conv_workspace(own_ws);
+    return spectrum != NULL;
+}
+
+ImageFloat *convolve_fft(const ImageFloat *img, const Kernel *kernel) {
+    ImageFloat *output = create_image_float_uninit(img->width, img->height, img->channels);
+    if (!output) return NULL;
+    
+    if (!convolve_fft_into(img, kernel, output, NULL)) {
+        free_image_float(output);
+        return NULL;
+    }
+    
+    return output;
+}
+
+ImageFloat *convolve_fft_roi(const ImageFloat *img, const Kernel *kernel,
+                             const ImageROI *roi) {
+    // FFT sur la fenêtre agrandie du halo uniquement
+    ImageROI region = roi_expand(roi, kernel->size / 2, img->width, img->height);
+    ImageFloat *sub = crop_image(img, &region);
+    if (!sub) return NULL;
+    
+    ImageFloat *filtered = convolve_fft(sub, kernel);
+    free_image_float(sub);
+    if (!filtered) return NULL;
+    
+    // Recadrer la fenêtre dans le repère de la région
+    ImageROI local = {roi->x - region.x, roi->y - region.y, roi->width, roi->height};
+    ImageFloat *output = crop_image(filtered, &local);
+    free_image_float(filtered);
+    
     return output;
 }
@@ -9,12 +9,12 @@
  * Initialise MKL avec le nombre de threads spécifié
  * @param num_threads: nombre de threads (0 = automatique)
  */
-void mkl_init(int num_threads);
+DENOISE_API void mkl_init(int num_threads);
 
 /**
  * Affiche les informations de configuration MKL
  */
-void mkl_print_info(void);
+DENOISE_API void mkl_print_info(void);
 
 /**
  * MÉTHODE 1: Convolution spatiale directe (naïve)
@@ -25,7 +25,7 @@ void mkl_print_info(void);
  * @param kernel: noyau de convolution
  * @return: image filtrée
  */
-ImageFloat *convolve_spatial(const ImageFloat *img, const Kernel *kernel);
+DENOISE_API ImageFloat *convolve_spatial(const ImageFloat *img, const Kernel *kernel);
 
 /**
  * MÉTHODE 1bis: Convolution spatiale optimisée avec BLAS
@@ -36,7 +36,7 @@ ImageFloat *convolve_spatial(const ImageFloat *img, const Kernel *kernel);
  * @param kernel: noyau de convolution
  * @return: image filtrée
  */
-ImageFloat *convolve_spatial_blas(const ImageFloat *img, const Kernel *kernel);
+DENOISE_API ImageFloat *convolve_spatial_blas(const ImageFloat *img, const Kernel *kernel);
 
 /**
  * MÉTHODE 2: Convolution séparable (pour noyaux gaussiens)
@@ -49,7 +49,8 @@ ImageFloat *convolve_spatial_blas(const ImageFloat *img, const Kernel *kernel);
  * @param kernel_size: taille du noyau
  * @return: image filtrée
  */
-ImageFloat *convolve_separable(const ImageFloat *img, const float *kernel_1d, int kernel_size);
+DENOISE_API ImageFloat *convolve_separable(const ImageFloat *img, const float *kernel_1d,
+                                           int kernel_size);
 
 /**
  * MÉTHODE 3: Convolution par FFT (transformée de Fourier)
@@ -61,7 +62,149 @@ ImageFloat *convolve_separable(const ImageFloat *img, const float *kernel_1d, in
  * @param kernel: noyau de convolution
  * @return: image filtrée
  */
-ImageFloat *convolve_fft(const ImageFloat *img, const Kernel *kernel);
+DENOISE_API ImageFloat *convolve_fft(const ImageFloat *img, const Kernel *kernel);
+
+// ============================================================================
+// Variantes à sortie fournie par l'appelant (_into)
+// ============================================================================
+// Pour le traitement en flux de trames de même taille: la destination et,
+// éventuellement, l'espace de travail appartiennent à l'appelant et sont
+// réutilisés d'une trame à l'autre. Une fois l'espace de travail dimensionné
+// (premier appel), ces fonctions n'effectuent aucune allocation.
+// La destination doit avoir les dimensions de la source; si son tampon est
+// partagé (clone), elle en reçoit d'abord une copie privée.
+// Retour: 1 si succès, 0 sinon (dimensions incompatibles, mémoire insuffisante).
+
+/**
+ * Espace de travail réutilisable (plan intermédiaire, patch BLAS,
+ * plans FFT et spectre du noyau en cache)
+ * Ses tampons sont dimensionnés au premier appel qui les utilise
+ */
+typedef struct ConvWorkspace ConvWorkspace;
+
+/**
+ * Crée un espace de travail vide
+ */
+DENOISE_API ConvWorkspace *create_conv_workspace(void);
+
+/**
+ * Libère un espace de travail et tous ses tampons
+ */
+DENOISE_API void free_conv_workspace(ConvWorkspace *ws);
+
+/**
+ * Convolution spatiale directe dans une image existante
+ */
+DENOISE_API int convolve_spatial_into(const ImageFloat *img, const Kernel *kernel,
+                                      ImageFloat *output);
+
+/**
+ * Convolution spatiale BLAS dans une image existante
+ * @param ws: espace de travail (patch), ou NULL pour un tampon temporaire
+ */
+DENOISE_API int convolve_spatial_blas_into(const ImageFloat *img, const Kernel *kernel,
+                                           ImageFloat *output, ConvWorkspace *ws);
+
+/**
+ * Convolution séparable dans une image existante
+ * @param ws: espace de travail (plan intermédiaire), ou NULL pour un tampon temporaire
+ */
+DENOISE_API int convolve_separable_into(const ImageFloat *img, const float *kernel_1d,
+                                        int kernel_size, ImageFloat *output, ConvWorkspace *ws);
+
+/**
+ * Convolution séparable dans une image existante, avec calcul du min/max
+ * du résultat pendant la passe verticale (pour normalize_image_range)
+ * @param min_val, max_val: [sortie] plage des valeurs produites
+ */
+DENOISE_API int convolve_separable_into_range(const ImageFloat *img, const float *kernel_1d,
+                                              int kernel_size, ImageFloat *output,
+                                              ConvWorkspace *ws, float *min_val, float *max_val);
+
+/**
+ * Convolution séparable sur pixels entrelacés (RGB/RGBA), u8 -> u8
+ * Aucune conversion planaire: les lignes sont traitées à plat, les voisins
+ * horizontaux d'un échantillon étant à un multiple de channels (chaque canal
+ * occupe ses propres voies SIMD). Chaque thread traite une bande de lignes
+ * avec un anneau des 2 * (kernel_size / 2) + 1 dernières lignes horizontales.
+ * Résultat identique à convolve_separable_into suivi de planar_to_interleaved
+ * @param dst: destination de même taille, distincte de src
+ * @return: 1 si succès, 0 sinon
+ */
+DENOISE_API int convolve_separable_packed(const unsigned char *src, int width, int height,
+                                          int channels, const float *kernel_1d, int kernel_size,
+                                          unsigned char *dst);
+
+/**
+ * Convolution séparable sur images demi-précision (binary16)
+ * Les lignes sont converties en float32 à la lecture et arrondies en binary16
+ * à l'écriture, plan intermédiaire compris: deux fois moins d'octets lus et
+ * écrits que convolve_separable_into pour un calcul identique en float32
+ * @param output: image demi-précision de mêmes dimensions (distincte de img)
+ * @return: 1 si succès, 0 sinon
+ */
+DENOISE_API int convolve_separable_half_into(const ImageHalf *img, const float *kernel_1d,
+                                             int kernel_size, ImageHalf *output, ConvWorkspace *ws);
+
+/**
+ * Convolution séparable lue directement dans un tampon u8 entrelacé (stb_image)
+ * La passe horizontale élargit les octets à la volée: aucune image flottante
+ * intermédiaire n'est créée pour l'entrée
+ * @param data: pixels entrelacés (RGBRGB...), width x height x channels
+ * @param output: image planaire de mêmes dimensions
+ * @param min_val, max_val: [sortie, optionnelles] plage des valeurs produites
+ * @return: 1 si succès, 0 sinon
+ */
+DENOISE_API int convolve_separable_u8_into(const unsigned char *data, int width, int height,
+                                           int channels, const float *kernel_1d, int kernel_size,
+                                           ImageFloat *output, ConvWorkspace *ws, float *min_val,
+                                           float *max_val);
+
+/**
+ * Convolution FFT dans une image existante
+ * Avec un espace de travail, les plans DFTI et le spectre du noyau sont
+ * conservés entre les appels (recalculés si le noyau ou la taille change)
+ * @param ws: espace de travail, ou NULL pour un espace temporaire
+ */
+DENOISE_API int convolve_fft_into(const ImageFloat *img, const Kernel *kernel,
+                                  ImageFloat *output, ConvWorkspace *ws);
+
+// ============================================================================
+// Convolution restreinte à une région d'intérêt (ROI)
+// ============================================================================
+// Ces variantes ne calculent que les pixels de la fenêtre demandée: le coût
+// est proportionnel à la surface de la fenêtre (plus le halo du noyau), et non
+// à celle de l'image. Les bords de l'image sont gérés comme dans les versions
+// pleine image, le résultat est donc identique au recadrage du résultat complet
+// (à l'exception de la FFT, circulaire, dont les bords diffèrent déjà).
+// L'image retournée a les dimensions de la fenêtre.
+
+/**
+ * Convolution spatiale directe sur une fenêtre
+ * @param roi: fenêtre à calculer (doit être contenue dans l'image)
+ */
+DENOISE_API ImageFloat *convolve_spatial_roi(const ImageFloat *img, const Kernel *kernel,
+                                             const ImageROI *roi);
+
+/**
+ * Convolution spatiale BLAS sur une fenêtre
+ */
+DENOISE_API ImageFloat *convolve_spatial_blas_roi(const ImageFloat *img, const Kernel *kernel,
+                                                  const ImageROI *roi);
+
+/**
+ * Convolution séparable sur une fenêtre
+ * La passe horizontale ne traite que les lignes de la fenêtre et son halo vertical
+ */
+DENOISE_API ImageFloat *convolve_separable_roi(const ImageFloat *img, const float *kernel_1d,
+                                               int kernel_size, const ImageROI *roi);
+
+/**
+ * Convolution FFT sur une fenêtre
+ * La FFT est calculée sur la fenêtre agrandie du halo du noyau uniquement
+ */
+DENOISE_API ImageFloat *convolve_fft_roi(const ImageFloat *img, const Kernel *kernel,
+                                         const ImageROI *roi);
 
 // ============================================================================
 // Fonctions auxiliaires pour la convolution séparable
@@ -71,8 +214,14 @@ ImageFloat *convolve_fft(const ImageFloat *img, const Kernel *kernel);
  * Convolution 1D (horizontale ou verticale)
  * @param horizontal: 1 pour horizontal, 0 pour vertical
  */
-ImageFloat *convolve_separable_1d(const ImageFloat *img, const float *kernel_1d, 
-                                   int kernel_size, int horizontal);
+DENOISE_API ImageFloat *convolve_separable_1d(const ImageFloat *img, const float *kernel_1d, 
+                                               int kernel_size, int horizontal);
+
+/**
+ * Convolution 1D dans une image existante (sans tampon intermédiaire)
+ */
+DENOISE_API int convolve_separable_1d_into(const ImageFloat *img, const float *kernel_1d,
+                                           int kernel_size, int horizontal, ImageFloat *output);
 
 // ============================================================================
 // Fonctions auxiliaires pour la convolution FFT
@@ -83,19 +232,19 @@ ImageFloat *convolve_separable_1d(const ImageFloat *img, const float *kernel_1d,
  * Utilise MKL DFTI
  * @return: buffer complexe (à libérer avec mkl_free)
  */
-void *fft_2d_forward(const float *img, int width, int height);
+DENOISE_API void *fft_2d_forward(const float *img, int width, int height);
 
 /**
  * FFT 2D backward (Complexe -> Réel)
  * Utilise MKL DFTI + normalisation
  * @return: buffer réel (à libérer avec mkl_free)
  */
-float *fft_2d_backward(void *fft_data, int width, int height);
+DENOISE_API float *fft_2d_backward(void *fft_data, int width, int height);
 
 /**
  * Multiplication complexe point-à-point dans le domaine fréquentiel
  * (a+bi) * (c+di) = (ac-bd) + (ad+bc)i
  */
-void fft_multiply(void *fft1, const void *fft2, int width, int height);
+DENOISE_API void fft_multiply(void *fft1, const void *fft2, int width, int height);
 
 #endif // MKL_OPS_H
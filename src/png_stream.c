@@ -0,0 +1,541 @@
+#include "png_stream.h"
+#include <omp.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+// Taille des blocs lus dans les chunks IDAT / des chunks IDAT écrits
+#define PNG_IO_CHUNK 65536
+
+// Encodeur parallèle: octets filtrés par bloc compressé indépendamment, et
+// fenêtre deflate reprise du bloc précédent comme dictionnaire
+#define PNG_PARALLEL_BLOCK (128 * 1024)
+#define DEFLATE_WINDOW 32768
+
+static const unsigned char png_signature[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+
+// Filtres de ligne PNG (spécification, section 9)
+enum { FILTER_NONE, FILTER_SUB, FILTER_UP, FILTER_AVERAGE, FILTER_PAETH, FILTER_COUNT };
+
+static inline unsigned char paeth(unsigned char a, unsigned char b, unsigned char c) {
+    int p = (int)a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+static uint32_t read_be32(const unsigned char *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void write_be32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+// Applique les cinq filtres à une ligne et renvoie la version dont la somme
+// des valeurs absolues (octets vus comme signés) est la plus petite
+// (heuristique recommandée par la spécification)
+// @param prev: ligne précédente non filtrée (zéros pour la première ligne)
+// @param filtered: FILTER_COUNT lignes de n + 1 octets, l'octet 0 de
+//                  filtered[f] valant f
+static const unsigned char *select_filter(const unsigned char *row, const unsigned char *prev,
+                                          size_t n, int bpp,
+                                          unsigned char *const *filtered) {
+    unsigned char *none = filtered[FILTER_NONE] + 1;
+    unsigned char *sub = filtered[FILTER_SUB] + 1;
+    unsigned char *up = filtered[FILTER_UP] + 1;
+    unsigned char *avg = filtered[FILTER_AVERAGE] + 1;
+    unsigned char *pae = filtered[FILTER_PAETH] + 1;
+    
+    memcpy(none, row, n);
+    for (size_t i = 0; i < n; i++) {
+        unsigned char a = i >= (size_t)bpp ? row[i - bpp] : 0;
+        unsigned char c = i >= (size_t)bpp ? prev[i - bpp] : 0;
+        sub[i] = (unsigned char)(row[i] - a);
+        up[i] = (unsigned char)(row[i] - prev[i]);
+        avg[i] = (unsigned char)(row[i] - ((a + prev[i]) >> 1));
+        pae[i] = (unsigned char)(row[i] - paeth(a, prev[i], c));
+    }
+    
+    int best = FILTER_NONE;
+    unsigned long best_sum = (unsigned long)-1;
+    for (int f = 0; f < FILTER_COUNT; f++) {
+        const signed char *v = (const signed char *)(filtered[f] + 1);
+        unsigned long sum = 0;
+        for (size_t i = 0; i < n; i++) sum += (unsigned long)abs(v[i]);
+        if (sum < best_sum) {
+            best_sum = sum;
+            best = f;
+        }
+    }
+    return filtered[best];
+}
+
+// Stratégies zlib conçues pour des lignes filtrées: Z_RLE au niveau rapide
+// (correspondances à distance 1 seulement: plusieurs fois plus rapide, et sur
+// une photo débruitée plus compact que le niveau 6), Z_FILTERED au-delà
+static int deflate_strategy(int level) {
+    return level == 1 ? Z_RLE : Z_FILTERED;
+}
+
+// Écrit un chunk dont le CRC (type compris) est déjà calculé
+static int put_chunk(FILE *file, const char *type, const unsigned char *data, uint32_t length,
+                     uLong crc) {
+    unsigned char header[8], trailer[4];
+    write_be32(header, length);
+    memcpy(header + 4, type, 4);
+    write_be32(trailer, (uint32_t)crc);
+    return fwrite(header, 1, 8, file) == 8 &&
+           (length == 0 || fwrite(data, 1, length, file) == length) &&
+           fwrite(trailer, 1, 4, file) == 4;
+}
+
+static uLong chunk_crc(const char *type, const unsigned char *data, uint32_t length) {
+    uLong crc = crc32(0L, (const Bytef *)type, 4);
+    return length > 0 ? crc32(crc, data, length) : crc;
+}
+
+// Signature et IHDR (8 bits par canal, non entrelacé)
+static int put_header(FILE *file, int width, int height, int channels) {
+    static const unsigned char color_types[5] = {0, 0, 4, 2, 6};
+    unsigned char ihdr[13] = {0};
+    write_be32(ihdr, (uint32_t)width);
+    write_be32(ihdr + 4, (uint32_t)height);
+    ihdr[8] = 8;                          // Bits par canal
+    ihdr[9] = color_types[channels];
+    return fwrite(png_signature, 1, 8, file) == 8 &&
+           put_chunk(file, "IHDR", ihdr, sizeof(ihdr), chunk_crc("IHDR", ihdr, sizeof(ihdr)));
+}
+
+// ============================================================================
+// Lecture
+// ============================================================================
+
+struct PngReader {
+    FILE *file;
+    z_stream zs;
+    int width, height, channels;
+    size_t stride;              // Octets par ligne (sans l'octet de filtre)
+    unsigned char *cur, *prev;  // Ligne en cours (octet de filtre compris) et précédente
+    uint32_t idat_left;         // Octets restant dans le chunk IDAT courant
+    int idat_done;              // Plus de chunk IDAT à lire
+    unsigned char in[PNG_IO_CHUNK];
+};
+
+// Lit l'en-tête du chunk suivant; les chunks non IDAT sont sautés jusqu'à
+// IEND. Retourne 1 si un chunk IDAT commence, 0 sinon.
+static int next_idat(PngReader *reader) {
+    unsigned char header[8];
+    for (;;) {
+        if (fread(header, 1, 8, reader->file) != 8) return 0;
+        uint32_t length = read_be32(header);
+        if (memcmp(header + 4, "IDAT", 4) == 0) {
+            reader->idat_left = length;
+            return 1;
+        }
+        if (memcmp(header + 4, "IEND", 4) == 0) return 0;
+        // Chunk auxiliaire: données + CRC ignorées
+        if (fseek(reader->file, (long)length + 4, SEEK_CUR) != 0) return 0;
+    }
+}
+
+// Remplit le tampon d'entrée de zlib avec la suite des données IDAT
+static void refill(PngReader *reader) {
+    while (!reader->idat_done && reader->idat_left == 0) {
+        unsigned char crc[4];
+        if (fread(crc, 1, 4, reader->file) != 4 || !next_idat(reader)) reader->idat_done = 1;
+    }
+    if (reader->idat_done) return;
+    
+    size_t want = reader->idat_left < sizeof(reader->in) ? reader->idat_left : sizeof(reader->in);
+    size_t got = fread(reader->in, 1, want, reader->file);
+    if (got == 0) {
+        reader->idat_done = 1;
+        return;
+    }
+    reader->idat_left -= (uint32_t)got;
+    reader->zs.next_in = reader->in;
+    reader->zs.avail_in = (uInt)got;
+}
+
+PngReader *png_reader_open(const char *filename, int *width, int *height, int *channels) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Erreur: impossible d'ouvrir '%s'\n", filename);
+        return NULL;
+    }
+    
+    // Signature + chunk IHDR (longueur, type, 13 octets de données, CRC)
+    unsigned char header[8 + 8 + 13 + 4];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, png_signature, 8) != 0 || memcmp(header + 12, "IHDR", 4) != 0) {
+        fprintf(stderr, "Erreur: '%s' n'est pas un fichier PNG\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    
+    const unsigned char *ihdr = header + 16;
+    uint32_t w = read_be32(ihdr), h = read_be32(ihdr + 4);
+    int depth = ihdr[8], color_type = ihdr[9], interlace = ihdr[12];
+    int c = color_type == 0 ? 1 : color_type == 4 ? 2 : color_type == 2 ? 3 :
+            color_type == 6 ? 4 : 0;
+    if (depth != 8 || c == 0 || interlace != 0 || w == 0 || h == 0 ||
+        w > 0x7FFFFFFF / 4 || h > 0x7FFFFFFF) {
+        fprintf(stderr, "Erreur: PNG non pris en charge en lecture par lignes "
+                        "(8 bits, sans palette, non entrelacé)\n");
+        fclose(file);
+        return NULL;
+    }
+    
+    PngReader *reader = (PngReader *)calloc(1, sizeof(PngReader));
+    size_t stride = (size_t)w * c;
+    unsigned char *rows = reader ? (unsigned char *)calloc(2, stride + 1) : NULL;
+    if (!rows || inflateInit(&reader->zs) != Z_OK) {
+        free(rows);
+        free(reader);
+        fclose(file);
+        return NULL;
+    }
+    
+    reader->file = file;
+    reader->width = (int)w;
+    reader->height = (int)h;
+    reader->channels = c;
+    reader->stride = stride;
+    reader->cur = rows;
+    reader->prev = rows + stride + 1;
+    reader->idat_done = !next_idat(reader);
+    
+    *width = reader->width;
+    *height = reader->height;
+    *channels = c;
+    return reader;
+}
+
+int png_reader_read_row(PngReader *reader, unsigned char *row) {
+    z_stream *zs = &reader->zs;
+    zs->next_out = reader->cur;
+    zs->avail_out = (uInt)(reader->stride + 1);
+    
+    while (zs->avail_out > 0) {
+        if (zs->avail_in == 0) {
+            refill(reader);
+            if (zs->avail_in == 0) return 0;
+        }
+        int ret = inflate(zs, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END && zs->avail_out > 0) return 0;
+        if (ret != Z_OK && ret != Z_STREAM_END) return 0;
+    }
+    
+    // Reconstruction: a = gauche, b = dessus, c = dessus-gauche
+    int bpp = reader->channels;
+    size_t n = reader->stride;
+    unsigned char *x = reader->cur + 1;
+    const unsigned char *b = reader->prev + 1;
+    switch (reader->cur[0]) {
+    case FILTER_NONE:
+        break;
+    case FILTER_SUB:
+        for (size_t i = bpp; i < n; i++) x[i] += x[i - bpp];
+        break;
+    case FILTER_UP:
+        for (size_t i = 0; i < n; i++) x[i] += b[i];
+        break;
+    case FILTER_AVERAGE:
+        for (size_t i = 0; i < (size_t)bpp; i++) x[i] += b[i] >> 1;
+        for (size_t i = bpp; i < n; i++) x[i] += (unsigned char)((x[i - bpp] + b[i]) >> 1);
+        break;
+    case FILTER_PAETH:
+        for (size_t i = 0; i < (size_t)bpp; i++) x[i] += b[i];
+        for (size_t i = bpp; i < n; i++) x[i] += paeth(x[i - bpp], b[i], b[i - bpp]);
+        break;
+    default:
+        return 0;
+    }
+    
+    memcpy(row, x, n);
+    
+    unsigned char *tmp = reader->prev;
+    reader->prev = reader->cur;
+    reader->cur = tmp;
+    return 1;
+}
+
+void png_reader_close(PngReader *reader) {
+    if (!reader) return;
+    inflateEnd(&reader->zs);
+    fclose(reader->file);
+    free(reader->cur < reader->prev ? reader->cur : reader->prev);
+    free(reader);
+}
+
+// ============================================================================
+// Écriture
+// ============================================================================
+
+struct PngWriter {
+    FILE *file;
+    z_stream zs;
+    int height, channels;
+    size_t stride;
+    unsigned char *prev;                     // Ligne précédente (non filtrée)
+    unsigned char *filtered[FILTER_COUNT];   // Ligne filtrée par chaque filtre
+    int rows_written;
+    int error;
+    unsigned char out[PNG_IO_CHUNK];
+};
+
+static void write_chunk(PngWriter *writer, const char *type, const unsigned char *data,
+                        uint32_t length) {
+    if (!put_chunk(writer->file, type, data, length, chunk_crc(type, data, length))) {
+        writer->error = 1;
+    }
+}
+
+// Compresse les données en attente; chaque tampon de sortie plein devient un chunk IDAT
+static void deflate_pending(PngWriter *writer, int flush) {
+    z_stream *zs = &writer->zs;
+    int ret;
+    do {
+        ret = deflate(zs, flush);
+        if (ret == Z_STREAM_ERROR) {
+            writer->error = 1;
+            return;
+        }
+        size_t produced = sizeof(writer->out) - zs->avail_out;
+        if (zs->avail_out == 0 || (flush == Z_FINISH && produced > 0)) {
+            write_chunk(writer, "IDAT", writer->out, (uint32_t)produced);
+            zs->next_out = writer->out;
+            zs->avail_out = sizeof(writer->out);
+        }
+    } while (zs->avail_in > 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+}
+
+PngWriter *png_writer_open(const char *filename, int width, int height, int channels,
+                           int level) {
+    if (width < 1 || height < 1 || channels < 1 || channels > 4) return NULL;
+    
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        fprintf(stderr, "Erreur: impossible de créer '%s'\n", filename);
+        return NULL;
+    }
+    
+    PngWriter *writer = (PngWriter *)calloc(1, sizeof(PngWriter));
+    size_t stride = (size_t)width * channels;
+    unsigned char *rows = writer ? (unsigned char *)calloc(FILTER_COUNT + 1, stride + 1) : NULL;
+    if (!rows ||
+        deflateInit2(&writer->zs, level, Z_DEFLATED, 15, 8, deflate_strategy(level)) != Z_OK) {
+        free(rows);
+        free(writer);
+        fclose(file);
+        return NULL;
+    }
+    
+    writer->file = file;
+    writer->height = height;
+    writer->channels = channels;
+    writer->stride = stride;
+    writer->prev = rows;
+    for (int f = 0; f < FILTER_COUNT; f++) {
+        writer->filtered[f] = rows + (size_t)(f + 1) * (stride + 1);
+        writer->filtered[f][0] = (unsigned char)f;
+    }
+    writer->zs.next_out = writer->out;
+    writer->zs.avail_out = sizeof(writer->out);
+    
+    if (!put_header(file, width, height, channels)) writer->error = 1;
+    
+    return writer;
+}
+
+int png_writer_write_row(PngWriter *writer, const unsigned char *row) {
+    if (writer->error || writer->rows_written >= writer->height) return 0;
+    
+    size_t n = writer->stride;
+    const unsigned char *best = select_filter(row, writer->prev, n, writer->channels,
+                                              writer->filtered);
+    
+    writer->zs.next_in = (Bytef *)best;
+    writer->zs.avail_in = (uInt)(n + 1);
+    deflate_pending(writer, Z_NO_FLUSH);
+    
+    memcpy(writer->prev, row, n);
+    writer->rows_written++;
+    return !writer->error;
+}
+
+int png_writer_close(PngWriter *writer) {
+    if (!writer) return 0;
+    
+    int ok = !writer->error && writer->rows_written == writer->height;
+    if (ok) {
+        deflate_pending(writer, Z_FINISH);
+        write_chunk(writer, "IEND", NULL, 0);
+        ok = !writer->error;
+    }
+    
+    deflateEnd(&writer->zs);
+    if (fclose(writer->file) != 0) ok = 0;
+    free(writer->prev);
+    free(writer);
+    return ok;
+}
+
+// ============================================================================
+// Encodage parallèle d'une image entière
+// ============================================================================
+
+// Octet FLG de l'en-tête zlib (fenêtre de 32 Ko): niveau indicatif + FCHECK
+static unsigned char zlib_flags(int level) {
+    if (level < 0) level = 6;             // Z_DEFAULT_COMPRESSION
+    if (level <= 1) return 0x01;
+    if (level <= 5) return 0x5E;
+    if (level == 6) return 0x9C;
+    return 0xDA;
+}
+
+// Un bloc de lignes: flux deflate brut, avec 2 octets réservés devant (en-tête
+// zlib du premier bloc) et 4 derrière (adler32 du dernier)
+typedef struct {
+    unsigned char *buffer;
+    unsigned char *start;   // Données du chunk IDAT (buffer ou buffer + 2)
+    size_t length;          // Octets compressés, puis taille du chunk IDAT
+    uLong adler;            // Adler-32 des octets filtrés du bloc
+    uLong crc;              // CRC du chunk IDAT
+    size_t raw_bytes;
+    int ok;
+} PngBlock;
+
+int png_write_image(const char *filename, const unsigned char *data, int width, int height,
+                    int channels, int level) {
+    if (width < 1 || height < 1 || channels < 1 || channels > 4) return 0;
+    
+    size_t n = (size_t)width * channels;
+    size_t line = n + 1;
+    // Découpage fixe: le fichier ne dépend pas du nombre de threads
+    int rows_per_block = (int)(PNG_PARALLEL_BLOCK / line);
+    if (rows_per_block < 1) rows_per_block = 1;
+    int num_blocks = (height + rows_per_block - 1) / rows_per_block;
+    
+    unsigned char *filtered = (unsigned char *)malloc(line * height);
+    PngBlock *blocks = (PngBlock *)calloc((size_t)num_blocks, sizeof(PngBlock));
+    if (!filtered || !blocks) {
+        free(filtered);
+        free(blocks);
+        return 0;
+    }
+    
+    #pragma omp parallel
+    {
+        // Filtrage: chaque ligne ne dépend que de la précédente non filtrée
+        unsigned char *rows = level != 0 ? (unsigned char *)calloc(FILTER_COUNT + 1, line) : NULL;
+        unsigned char *scratch[FILTER_COUNT];
+        for (int f = 0; rows && f < FILTER_COUNT; f++) {
+            scratch[f] = rows + (size_t)(f + 1) * line;
+            scratch[f][0] = (unsigned char)f;
+        }
+        
+        #pragma omp for schedule(static)
+        for (int y = 0; y < height; y++) {
+            const unsigned char *row = data + (size_t)y * n;
+            unsigned char *dst = filtered + (size_t)y * line;
+            if (rows) {
+                // rows[0..line) reste à zéro: ligne précédant la première
+                const unsigned char *prev = y > 0 ? row - n : rows;
+                memcpy(dst, select_filter(row, prev, n, channels, scratch), line);
+            } else {
+                // Niveau 0 (stockage): filtrer ne réduirait pas la taille
+                dst[0] = FILTER_NONE;
+                memcpy(dst + 1, row, n);
+            }
+        }
+        free(rows);
+        
+        // Compression: un flux deflate brut par bloc, amorcé par la fin du bloc
+        // précédent et terminé par Z_SYNC_FLUSH (aligné sur un octet), Z_FINISH
+        // pour le dernier; les blocs se concatènent en un seul flux valide
+        #pragma omp for schedule(dynamic, 1)
+        for (int b = 0; b < num_blocks; b++) {
+            PngBlock *block = &blocks[b];
+            size_t start = (size_t)b * rows_per_block * line;
+            int block_rows = height - b * rows_per_block < rows_per_block
+                           ? height - b * rows_per_block : rows_per_block;
+            block->raw_bytes = (size_t)block_rows * line;
+            block->adler = adler32(adler32(0L, Z_NULL, 0), filtered + start,
+                                   (uInt)block->raw_bytes);
+            
+            z_stream zs;
+            memset(&zs, 0, sizeof(zs));
+            if (deflateInit2(&zs, level, Z_DEFLATED, -15, 8, deflate_strategy(level)) != Z_OK) {
+                continue;
+            }
+            if (b > 0) {
+                size_t dict = start < DEFLATE_WINDOW ? start : DEFLATE_WINDOW;
+                deflateSetDictionary(&zs, filtered + start - dict, (uInt)dict);
+            }
+            
+            // Marge pour le marqueur de Z_SYNC_FLUSH, l'en-tête et l'adler32
+            size_t capacity = deflateBound(&zs, block->raw_bytes) + 16;
+            block->buffer = (unsigned char *)malloc(capacity + 6);
+            if (block->buffer) {
+                zs.next_in = filtered + start;
+                zs.avail_in = (uInt)block->raw_bytes;
+                zs.next_out = block->buffer + 2;
+                zs.avail_out = (uInt)capacity;
+                int last = b == num_blocks - 1;
+                int ret = deflate(&zs, last ? Z_FINISH : Z_SYNC_FLUSH);
+                block->ok = zs.avail_in == 0 && (last ? ret == Z_STREAM_END : ret == Z_OK);
+                block->length = capacity - zs.avail_out;
+            }
+            deflateEnd(&zs);
+        }
+    }
+    
+    int ok = 1;
+    for (int b = 0; b < num_blocks; b++) ok = ok && blocks[b].ok;
+    
+    // Un chunk IDAT par bloc: en-tête zlib devant le premier, adler32 combiné
+    // (adler32_combine, sans relire les données) derrière le dernier
+    uLong adler = adler32(0L, NULL, 0);
+    for (int b = 0; ok && b < num_blocks; b++) {
+        PngBlock *block = &blocks[b];
+        adler = adler32_combine(adler, block->adler, (z_off_t)block->raw_bytes);
+        block->start = block->buffer + 2;
+        if (b == 0) {
+            block->start -= 2;
+            block->start[0] = 0x78;
+            block->start[1] = zlib_flags(level);
+            block->length += 2;
+        }
+        if (b == num_blocks - 1) {
+            write_be32(block->start + block->length, (uint32_t)adler);
+            block->length += 4;
+        }
+    }
+    if (ok) {
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int b = 0; b < num_blocks; b++) {
+            blocks[b].crc = chunk_crc("IDAT", blocks[b].start, (uint32_t)blocks[b].length);
+        }
+    }
+    
+    FILE *file = ok ? fopen(filename, "wb") : NULL;
+    if (ok && !file) fprintf(stderr, "Erreur: impossible de créer '%s'\n", filename);
+    ok = file && put_header(file, width, height, channels);
+    for (int b = 0; ok && b < num_blocks; b++) {
+        ok = put_chunk(file, "IDAT", blocks[b].start, (uint32_t)blocks[b].length, blocks[b].crc);
+    }
+    if (ok) ok = put_chunk(file, "IEND", NULL, 0, chunk_crc("IEND", NULL, 0));
+    if (file && fclose(file) != 0) ok = 0;
+    
+    for (int b = 0; b < num_blocks; b++) free(blocks[b].buffer);
+    free(blocks);
+    free(filtered);
+    return ok;
+}
@@ -0,0 +1,77 @@
+#ifndef PNG_STREAM_H
+#define PNG_STREAM_H
+
+/**
+ * Lecture et écriture de PNG ligne par ligne (zlib)
+ * 
+ * Contrairement à stb_image / stb_image_write, qui décodent et encodent
+ * l'image entière en mémoire, ces fonctions ne gardent que la ligne
+ * courante et la précédente (filtres PNG): la mémoire utilisée ne dépend
+ * que de la largeur de l'image.
+ * 
+ * Formats pris en charge: 8 bits par canal, non entrelacé (Adam7 exclu),
+ * niveaux de gris, gris + alpha, RGB, RGBA (pas de palette).
+ */
+
+typedef struct PngReader PngReader;
+typedef struct PngWriter PngWriter;
+
+/**
+ * Ouvre un PNG et lit son en-tête
+ * @param width, height, channels: [sortie] dimensions de l'image
+ * @return: lecteur, ou NULL (fichier illisible ou format non pris en charge)
+ */
+PngReader *png_reader_open(const char *filename, int *width, int *height, int *channels);
+
+/**
+ * Décode la ligne suivante
+ * @param row: [sortie] width x channels octets entrelacés
+ * @return: 1 si succès, 0 sinon (données corrompues, fin de fichier)
+ */
+int png_reader_read_row(PngReader *reader, unsigned char *row);
+
+/**
+ * Ferme le fichier et libère le lecteur
+ */
+void png_reader_close(PngReader *reader);
+
+/**
+ * Crée un PNG et écrit son en-tête
+ * @param level: niveau de compression zlib (0-9, -1 = défaut; stratégie
+ *               comme png_write_image)
+ * @return: écrivain, ou NULL en cas d'erreur
+ */
+PngWriter *png_writer_open(const char *filename, int width, int height, int channels,
+                           int level);
+
+/**
+ * Filtre, compresse et écrit la ligne suivante
+ * Le filtre de chaque ligne est choisi par la somme minimale des
+ * différences absolues (heuristique recommandée par la spécification)
+ * @param row: width x channels octets entrelacés
+ * @return: 1 si succès, 0 sinon
+ */
+int png_writer_write_row(PngWriter *writer, const unsigned char *row);
+
+/**
+ * Termine le flux compressé, écrit IEND et ferme le fichier
+ * @return: 1 si toutes les lignes ont été écrites sans erreur, 0 sinon
+ */
+int png_writer_close(PngWriter *writer);
+
+/**
+ * Encode une image entière en PNG, filtrage et compression en parallèle
+ * Les lignes filtrées sont découpées en blocs de 128 Ko compressés chacun
+ * par un thread (flux deflate brut amorcé par les 32 derniers Ko du bloc
+ * précédent, terminé par Z_SYNC_FLUSH), puis concaténées en un seul flux
+ * zlib valide dont l'adler32 est combiné (adler32_combine). Le découpage ne
+ * dépend pas du nombre de threads: le fichier est le même quel que soit -t.
+ * @param data: width x height x channels octets entrelacés
+ * @param level: 0 (stockage, sans filtre), 1 (rapide, Z_RLE) à 9 (Z_FILTERED),
+ *               -1 = défaut zlib
+ * @return: 1 si succès, 0 sinon
+ */
+int png_write_image(const char *filename, const unsigned char *data, int width, int height,
+                    int channels, int level);
+
+#endif // PNG_STREAM_H
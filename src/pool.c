@@ -0,0 +1,289 @@
+// mmap/madvise (MAP_ANONYMOUS, MADV_HUGEPAGE) ne sont pas exposés en C11 strict
+#define _GNU_SOURCE
+
+#include "pool.h"
+#if __has_include(<mkl.h>)
+#  include <mkl.h>
+#elif __has_include(<mkl/mkl.h>)
+#  include <mkl/mkl.h>
+#else
+#  error "MKL header not found"
+#endif
+#include <pthread.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Alignement des tampons (et taille de l'en-tête placé devant chaque tampon)
+#define POOL_ALIGN 64
+
+// Nombre de classes: 4 petites classes + 4 classes par puissance de deux
+#define POOL_NUM_CLASSES 232
+
+// Taille d'une grande page (THP / hugetlbfs) sur x86-64
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+// Origine de la mémoire d'un bloc
+enum {
+    BLOCK_MKL,        // mkl_malloc (pages de 4 Ko)
+    BLOCK_THP,        // mmap aligné sur 2 Mo + madvise(MADV_HUGEPAGE)
+    BLOCK_HUGETLB     // mmap(MAP_HUGETLB), pages réservées dans hugetlbfs
+};
+
+/**
+ * En-tête d'un bloc, placé juste avant le tampon retourné à l'appelant
+ * Occupe POOL_ALIGN octets pour préserver l'alignement du tampon
+ */
+typedef struct PoolBlock {
+    struct PoolBlock *next;   // Bloc suivant dans la liste libre
+    size_t size;              // Taille de la classe (octets utiles)
+    size_t map_bytes;         // Taille du mapping (blocs mmap uniquement)
+    int size_class;           // Indice de la classe
+    int kind;                 // Origine de la mémoire (BLOCK_*)
+} PoolBlock;
+
+_Static_assert(sizeof(PoolBlock) <= POOL_ALIGN, "PoolBlock doit tenir dans l'en-tête");
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static PoolBlock *free_lists[POOL_NUM_CLASSES];
+static size_t cache_limit = (size_t)1 << 30;
+static size_t huge_threshold = (size_t)8 << 20;
+static PoolStats stats;
+
+// Mode THP du noyau, lu une fois dans /sys (0 si "never" ou absent)
+static pthread_once_t thp_once = PTHREAD_ONCE_INIT;
+static int thp_available;
+
+static void detect_thp(void) {
+    char mode[128] = "";
+    FILE *f = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (f) {
+        if (!fgets(mode, sizeof(mode), f)) mode[0] = '\0';
+        fclose(f);
+    }
+    thp_available = mode[0] != '\0' && strstr(mode, "[never]") == NULL;
+}
+
+// Mapping anonyme de len octets aligné sur 2 Mo
+// (sur-allocation de 2 Mo puis découpe de la tête et de la queue)
+static void *map_aligned(size_t len) {
+    void *raw = mmap(NULL, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+    
+    uintptr_t start = ((uintptr_t)raw + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+    size_t head = start - (uintptr_t)raw;
+    if (head) munmap(raw, head);
+    munmap((char *)start + len, HUGE_PAGE_SIZE - head);
+    
+    return (void *)start;
+}
+
+// Grand tampon sur pages de 2 Mo: THP si le noyau l'autorise,
+// sinon hugetlbfs explicite; NULL si aucune des deux n'est disponible
+static PoolBlock *map_huge_block(size_t total, int *kind, size_t *map_bytes) {
+    size_t len = (total + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    
+    pthread_once(&thp_once, detect_thp);
+    if (thp_available) {
+        void *p = map_aligned(len);
+        if (p && madvise(p, len, MADV_HUGEPAGE) == 0) {
+            *kind = BLOCK_THP;
+            *map_bytes = len;
+            return (PoolBlock *)p;
+        }
+        if (p) munmap(p, len);
+    }
+    
+#ifdef MAP_HUGETLB
+    // Nécessite des pages réservées (/proc/sys/vm/nr_hugepages)
+    void *p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+        *kind = BLOCK_HUGETLB;
+        *map_bytes = len;
+        return (PoolBlock *)p;
+    }
+#endif
+    
+    return NULL;
+}
+
+// Allocation système d'un bloc (en-tête compris)
+static PoolBlock *block_create(size_t rounded, int cls, size_t threshold) {
+    PoolBlock *block = NULL;
+    int kind = BLOCK_MKL;
+    size_t map_bytes = 0;
+    
+    if (rounded >= threshold) {
+        block = map_huge_block(rounded + POOL_ALIGN, &kind, &map_bytes);
+    }
+    if (!block) {
+        kind = BLOCK_MKL;
+        block = (PoolBlock *)mkl_malloc(rounded + POOL_ALIGN, POOL_ALIGN);
+        if (!block) return NULL;
+    }
+    
+    block->size = rounded;
+    block->size_class = cls;
+    block->kind = kind;
+    block->map_bytes = map_bytes;
+    return block;
+}
+
+// Rend un bloc au système
+static void block_destroy(PoolBlock *block) {
+    if (block->kind == BLOCK_MKL) {
+        mkl_free(block);
+    } else {
+        munmap(block, block->map_bytes);
+    }
+}
+
+// Calcule la classe d'une taille et la taille arrondie correspondante
+static int size_class(size_t bytes, size_t *rounded) {
+    if (bytes == 0) bytes = 1;
+    
+    // Petites tailles: multiples de 64 octets
+    if (bytes <= 4 * POOL_ALIGN) {
+        *rounded = (bytes + POOL_ALIGN - 1) & ~(size_t)(POOL_ALIGN - 1);
+        return (int)(*rounded / POOL_ALIGN) - 1;
+    }
+    
+    // 2^lg < bytes <= 2^(lg+1), découpé en 4 pas de 2^(lg-2)
+    int lg = 63 - __builtin_clzll((unsigned long long)(bytes - 1));
+    size_t step = (size_t)1 << (lg - 2);
+    *rounded = (bytes + step - 1) & ~(step - 1);
+    return 4 + (lg - 8) * 4 + (int)(*rounded / step) - 5;
+}
+
+static inline void *block_data(PoolBlock *block) {
+    return (char *)block + POOL_ALIGN;
+}
+
+static inline PoolBlock *data_block(void *ptr) {
+    return (PoolBlock *)((char *)ptr - POOL_ALIGN);
+}
+
+void *pool_alloc(size_t bytes) {
+    size_t rounded;
+    int cls = size_class(bytes, &rounded);
+    if (cls < 0 || cls >= POOL_NUM_CLASSES) return NULL;
+    
+    pthread_mutex_lock(&pool_lock);
+    PoolBlock *block = free_lists[cls];
+    if (block) {
+        free_lists[cls] = block->next;
+        stats.hits++;
+        stats.bytes_cached -= block->size;
+    } else {
+        stats.misses++;
+    }
+    stats.bytes_outstanding += rounded;
+    if (stats.bytes_outstanding > stats.peak_outstanding) {
+        stats.peak_outstanding = stats.bytes_outstanding;
+    }
+    size_t threshold = huge_threshold;
+    pthread_mutex_unlock(&pool_lock);
+    
+    if (!block) {
+        // Aucun tampon recyclable: allocation système hors verrou
+        block = block_create(rounded, cls, threshold);
+        pthread_mutex_lock(&pool_lock);
+        if (!block) {
+            stats.bytes_outstanding -= rounded;
+        } else if (block->kind != BLOCK_MKL) {
+            stats.huge_allocations++;
+        }
+        pthread_mutex_unlock(&pool_lock);
+        if (!block) return NULL;
+    }
+    
+    block->next = NULL;
+    return block_data(block);
+}
+
+void *pool_alloc_zeroed(size_t bytes) {
+    void *ptr = pool_alloc(bytes);
+    if (ptr) memset(ptr, 0, bytes);
+    return ptr;
+}
+
+void pool_free(void *ptr) {
+    if (!ptr) return;
+    
+    PoolBlock *block = data_block(ptr);
+    int keep;
+    
+    pthread_mutex_lock(&pool_lock);
+    stats.releases++;
+    stats.bytes_outstanding -= block->size;
+    keep = stats.bytes_cached + block->size <= cache_limit;
+    if (keep) {
+        block->next = free_lists[block->size_class];
+        free_lists[block->size_class] = block;
+        stats.bytes_cached += block->size;
+    }
+    pthread_mutex_unlock(&pool_lock);
+    
+    if (!keep) block_destroy(block);
+}
+
+void pool_set_cache_limit(size_t bytes) {
+    pthread_mutex_lock(&pool_lock);
+    cache_limit = bytes;
+    int over = stats.bytes_cached > bytes;
+    pthread_mutex_unlock(&pool_lock);
+    
+    if (over) pool_trim();
+}
+
+void pool_set_huge_threshold(size_t bytes) {
+    pthread_mutex_lock(&pool_lock);
+    huge_threshold = bytes;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+void pool_trim(void) {
+    PoolBlock *lists[POOL_NUM_CLASSES];
+    
+    // Détacher les listes sous verrou, libérer hors verrou
+    pthread_mutex_lock(&pool_lock);
+    memcpy(lists, free_lists, sizeof(lists));
+    memset(free_lists, 0, sizeof(free_lists));
+    stats.bytes_cached = 0;
+    pthread_mutex_unlock(&pool_lock);
+    
+    for (int i = 0; i < POOL_NUM_CLASSES; i++) {
+        PoolBlock *block = lists[i];
+        while (block) {
+            PoolBlock *next = block->next;
+            block_destroy(block);
+            block = next;
+        }
+    }
+}
+
+void pool_get_stats(PoolStats *out) {
+    pthread_mutex_lock(&pool_lock);
+    *out = stats;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+void pool_print_stats(void) {
+    PoolStats s;
+    pool_get_stats(&s);
+    
+    size_t requests = s.hits + s.misses;
+    double hit_rate = requests ? 100.0 * (double)s.hits / (double)requests : 0.0;
+    
+    printf("=== Pool mémoire ===\n");
+    printf("  Allocations      : %zu (%zu recyclées, %zu système)\n", requests, s.hits, s.misses);
+    printf("  Taux de recyclage: %.1f%%\n", hit_rate);
+    printf("  En usage         : %.2f Mo (pic: %.2f Mo)\n",
+           s.bytes_outstanding / 1048576.0, s.peak_outstanding / 1048576.0);
+    printf("  En cache         : %.2f Mo\n", s.bytes_cached / 1048576.0);
+    printf("  Pages de 2 Mo    : %zu tampons\n", s.huge_allocations);
+    printf("\n");
+}
@@ -0,0 +1,85 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+/**
+ * Pool de tampons alignés pour les plans d'images
+ * 
+ * Les tampons libérés ne sont pas rendus au système mais conservés dans des
+ * listes par classe de taille, puis recyclés à l'allocation suivante de même
+ * classe. Cela évite les appels à mkl_malloc et les défauts de page répétés
+ * lorsque des images de même taille sont créées et détruites en boucle
+ * (passes intermédiaires, tampons FFT, traitement par lots).
+ * 
+ * Classes de taille: multiples de 64 octets jusqu'à 256 octets, puis 4 classes
+ * par puissance de deux (perte maximale de 25%). Tous les tampons sont alignés
+ * sur 64 octets (AVX-512). Les fonctions sont thread-safe.
+ * 
+ * Les grands tampons (au-delà d'un seuil, 8 Mo par défaut) sont alloués par
+ * mmap aligné sur 2 Mo avec madvise(MADV_HUGEPAGE), pour que les plans soient
+ * couverts par des pages de 2 Mo (THP) et réduire les défauts de TLB lors des
+ * parcours verticaux et des FFT. Si THP est désactivé, le pool tente
+ * mmap(MAP_HUGETLB) (pages réservées dans hugetlbfs), puis mkl_malloc.
+ */
+
+/**
+ * Statistiques du pool
+ */
+typedef struct {
+    size_t hits;              // Allocations servies par un tampon recyclé
+    size_t misses;            // Allocations ayant nécessité mkl_malloc
+    size_t releases;          // Tampons rendus au pool
+    size_t bytes_outstanding; // Octets actuellement utilisés par l'appelant
+    size_t peak_outstanding;  // Maximum atteint par bytes_outstanding
+    size_t bytes_cached;      // Octets conservés pour réutilisation
+    size_t huge_allocations;  // Allocations système servies par des pages de 2 Mo
+} PoolStats;
+
+/**
+ * Alloue un tampon aligné sur 64 octets, sans initialisation
+ * Le contenu est indéterminé (éventuellement celui d'une image précédente)
+ * @param bytes: taille demandée en octets
+ * @return: tampon à libérer avec pool_free, ou NULL en cas d'échec
+ */
+void *pool_alloc(size_t bytes);
+
+/**
+ * Alloue un tampon aligné sur 64 octets, initialisé à zéro
+ */
+void *pool_alloc_zeroed(size_t bytes);
+
+/**
+ * Rend un tampon au pool (NULL accepté)
+ */
+void pool_free(void *ptr);
+
+/**
+ * Fixe la quantité maximale d'octets conservés pour réutilisation
+ * Au-delà, les tampons libérés sont rendus au système (défaut: 1 Go)
+ */
+void pool_set_cache_limit(size_t bytes);
+
+/**
+ * Fixe la taille à partir de laquelle un tampon est alloué sur pages de 2 Mo
+ * SIZE_MAX désactive les grandes pages (défaut: 8 Mo)
+ * Ne concerne que les allocations système suivantes (voir pool_trim)
+ */
+void pool_set_huge_threshold(size_t bytes);
+
+/**
+ * Rend au système tous les tampons conservés
+ */
+void pool_trim(void);
+
+/**
+ * Copie les statistiques courantes du pool
+ */
+void pool_get_stats(PoolStats *stats);
+
+/**
+ * Affiche les statistiques du pool (taux de réutilisation, octets en usage)
+ */
+void pool_print_stats(void);
+
+#endif // POOL_H
@@ -141,6 +141,49 @@ run_test "Convolution spatiale avec BLAS" \
     "../image_denoise --test -m spatial_blas -k 5 -o test12" \
     "test12_noisy.png test12_spatial_blas.png"
 
+# Test 13: Région d'intérêt
+echo "────────────────────────────────────────────────────────────────"
+echo "Test $((TESTS_TOTAL + 1)): Région d'intérêt (--roi) vs image entière recadrée"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_roi"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+ROI_OK=true
+# Chaque méthode écrit sa fenêtre dans data/ (préfixe -o)
+for m in spatial spatial_blas separable fft; do
+    ../image_denoise --test --roi 100,100,128,64 -m $m -k 7 -q -o roi > /dev/null 2>&1 || true
+    if [ ! -f "data/roi_$m.png" ] || [ ! -f "data/roi_noisy.png" ]; then
+        ROI_OK=false
+        echo -e "${RED}✗ Fenêtre $m non écrite${NC}"
+    fi
+done
+# Moteurs *_roi vs recadrage du résultat pleine image: fenêtre intérieure,
+# puis fenêtres collées aux bords (halo borné à l'image)
+if [ -f "../image_bench" ]; then
+    for r in 100,100,128,64 0,0,64,48 256,192,64,48; do
+        if ! ../image_bench roi -W 320 -H 240 -k 7 -r 1 -R $r > roi.log 2>&1; then
+            ROI_OK=false
+            echo -e "${RED}✗ Fenêtre $r différente de l'image entière recadrée${NC}"
+            grep "Erreur" roi.log || true
+        fi
+    done
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), comparaison au recadrage ignorée${NC}"
+fi
+
+if [ "$ROI_OK" = true ]; then
+    echo -e "${GREEN}✓ Fenêtres identiques au recadrage de l'image entière (4 méthodes)${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
 # ============================================================================
 # TESTS DE VALIDATION MATHÉMATIQUE
 # ============================================================================
@@ -150,7 +193,7 @@ echo "TESTS DE VALIDATION MATHÉMATIQUE"
 echo "════════════════════════════════════════════════════════════════"
 echo ""
 
-# Test 13: Vérifier que toutes les méthodes donnent des résultats similaires
+# Test 14: Vérifier que toutes les méthodes donnent des résultats similaires
 echo "Test $((TESTS_TOTAL + 1)): Cohérence entre les méthodes"
 echo "────────────────────────────────────────────────────────────────"
 TESTS_TOTAL=$((TESTS_TOTAL + 1))
@@ -175,6 +218,818 @@ fi
 cd ..
 echo ""
 
+# Test: aucune allocation en régime permanent avec les variantes _into
+echo "Test $((TESTS_TOTAL + 1)): Mode flux sans allocation (variantes _into)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_stream"
+mkdir -p "$TEST_DIR"
+cd "$TEST_DIR"
+
+# Compteur d'allocations du pool, relevé après la première trame
+STREAM_OUTPUT=$(../image_denoise --test -k 7 -m all --frames 5 -o stream 2>&1)
+STREAM_LINES=$(echo "$STREAM_OUTPUT" | grep -c "allocations en régime permanent" || true)
+STREAM_ALLOCS=$(echo "$STREAM_OUTPUT" | grep -c " 0 allocations en régime permanent" || true)
+
+if [ "$STREAM_LINES" -eq 4 ] && [ "$STREAM_ALLOCS" -eq 4 ]; then
+    echo -e "${GREEN}✓ Aucune allocation après la première trame (4 méthodes)${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ Allocations détectées en régime permanent${NC}"
+    echo "$STREAM_OUTPUT" | grep "régime permanent"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: clones en copie sur écriture, plans recyclés par le pool
+echo "Test $((TESTS_TOTAL + 1)): Copie sur écriture (clones, pool)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_cow"
+mkdir -p "$TEST_DIR"
+cd "$TEST_DIR"
+
+# Écriture par un clone (bruit, normalisation) invisible dans l'autre, aucune
+# copie pour le seul propriétaire, image sans tampon (remplie à la main)
+# clonée par copie, plan libéré recyclé par le pool
+if [ -f "../image_bench" ]; then
+    if ../image_bench cow -W 333 -H 257 -r 1 > cow.log 2>&1; then
+        echo -e "${GREEN}✓ Clones indépendants, seul propriétaire modifié sans copie${NC}"
+        TESTS_PASSED=$((TESTS_PASSED + 1))
+    else
+        echo -e "${RED}✗ Copie sur écriture incorrecte${NC}"
+        grep "Erreur" cow.log || true
+        TESTS_FAILED=$((TESTS_FAILED + 1))
+    fi
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), test ignoré${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: min/max vectorisé et min/max calculé pendant la convolution
+echo "Test $((TESTS_TOTAL + 1)): Min/max (image_minmax, passe séparable fusionnée)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_minmax"
+mkdir -p "$TEST_DIR"
+cd "$TEST_DIR"
+
+# image_minmax et la plage de convolve_separable_into_range identiques à une
+# boucle scalaire (dimensions impaires: restes des boucles AVX2, 1 et 4 threads)
+if [ -f "../image_bench" ]; then
+    MINMAX_OK=true
+    for t in 1 4; do
+        if ! OMP_NUM_THREADS=$t ../image_bench minmax -W 333 -H 257 -k 7 -r 1 > minmax.log 2>&1; then
+            MINMAX_OK=false
+            echo -e "${RED}✗ Min/max différent de la référence ($t threads)${NC}"
+            grep "Erreur" minmax.log || true
+        fi
+    done
+    if [ "$MINMAX_OK" = true ]; then
+        echo -e "${GREEN}✓ Min/max identiques à la boucle scalaire${NC}"
+        TESTS_PASSED=$((TESTS_PASSED + 1))
+    else
+        TESTS_FAILED=$((TESTS_FAILED + 1))
+    fi
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), test ignoré${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: quantification fusionnée (normalisation + arrondi + entrelacement)
+echo "Test $((TESTS_TOTAL + 1)): Quantification fusionnée vs normalisation + entrelacement"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_quantize"
+mkdir -p "$TEST_DIR"
+cd "$TEST_DIR"
+
+# Octets identiques pour des valeurs voisines des seuils d'arrondi, 1 à 4
+# canaux (dimensions impaires: restes des boucles AVX2 et des tuiles, 1 et 4
+# threads)
+if [ -f "../image_bench" ]; then
+    QUANT_OK=true
+    for t in 1 4; do
+        for c in 1 2 3 4; do
+            if ! OMP_NUM_THREADS=$t ../image_bench quantize -W 333 -H 257 -c $c -r 1 > quantize.log 2>&1; then
+                QUANT_OK=false
+                echo -e "${RED}✗ Octets différents ($c canaux, $t threads)${NC}"
+                grep "Erreur" quantize.log || true
+            fi
+        done
+    done
+    if [ "$QUANT_OK" = true ]; then
+        echo -e "${GREEN}✓ Octets identiques (1 à 4 canaux)${NC}"
+        TESTS_PASSED=$((TESTS_PASSED + 1))
+    else
+        TESTS_FAILED=$((TESTS_FAILED + 1))
+    fi
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), test ignoré${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: bruit reproductible, indépendant du nombre de threads
+echo "Test $((TESTS_TOTAL + 1)): Bruit reproductible (graine fixe, 1 vs 8 threads)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_seed"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+../image_denoise --test -m separable -k 3 --seed 1234 -t 1 -o seed_t1 > /dev/null 2>&1
+../image_denoise --test -m separable -k 3 --seed 1234 -t 8 -o seed_t8 > /dev/null 2>&1
+
+if [ -f "data/seed_t1_noisy.png" ] && cmp -s "data/seed_t1_noisy.png" "data/seed_t8_noisy.png"; then
+    echo -e "${GREEN}✓ Images bruitées identiques${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ Le bruit dépend du nombre de threads${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: lecture u8 directe (sans image flottante) identique au chemin flottant
+echo "Test $((TESTS_TOTAL + 1)): Passe horizontale lue en u8 (-n 0 -m separable)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_u8"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+../image_denoise --test -m separable -k 3 -o source > /dev/null 2>&1
+# Sans --roi: lecture u8 directe; fenêtre couvrant l'image: chemin flottant
+../image_denoise -i data/source_noisy.png -n 0 -m separable -k 7 -o direct > /dev/null 2>&1
+../image_denoise -i data/source_noisy.png -n 0 -m separable -k 7 --roi 0,0,512,512 -o float > /dev/null 2>&1
+
+if [ -f "data/direct_separable.png" ] && cmp -s "data/direct_separable.png" "data/float_separable.png"; then
+    echo -e "${GREEN}✓ Résultats identiques${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ La lecture u8 directe diffère du chemin flottant${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: moteur en virgule fixe à au plus 1 LSB du calcul flottant
+echo "Test $((TESTS_TOTAL + 1)): Convolution en virgule fixe (Q14, u8) vs flottant"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_fixed"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+FIXED_OK=true
+for k in 3 7 15; do
+    FIXED_OUTPUT=$(../image_denoise --test -m separable_int -k $k -s 3.0 -o fixed_$k 2>&1)
+    FIXED_ERROR=$(echo "$FIXED_OUTPUT" | sed -n 's/.*Écart max vs flottant: \([0-9]*\) LSB.*/\1/p')
+    if [ -z "$FIXED_ERROR" ] || [ "$FIXED_ERROR" -gt 1 ] || [ ! -f "data/fixed_${k}_separable_int.png" ]; then
+        FIXED_OK=false
+        echo -e "${RED}✗ Noyau ${k}x${k}: écart ${FIXED_ERROR:-inconnu} LSB${NC}"
+    fi
+done
+
+if [ "$FIXED_OK" = true ]; then
+    echo -e "${GREEN}✓ Écart ≤ 1 LSB (noyaux 3, 7 et 15)${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: chemin entrelacé identique au chemin planaire
+echo "Test $((TESTS_TOTAL + 1)): Séparable sur pixels entrelacés vs planaire"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_packed"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+PACKED_OUTPUT=$(../image_denoise --test -m separable_packed -k 7 -o packed 2>&1)
+if echo "$PACKED_OUTPUT" | grep -q "Écart max vs planaire: 0 LSB" && [ -f "data/packed_separable_packed.png" ]; then
+    echo -e "${GREEN}✓ Résultats identiques (0 LSB)${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ Le chemin entrelacé diffère du chemin planaire${NC}"
+    echo "$PACKED_OUTPUT" | grep "Écart"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: stockage demi-précision, perte de précision mesurée par le PSNR
+echo "Test $((TESTS_TOTAL + 1)): Séparable sur plans demi-précision (FP16) vs float32"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_f16"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+F16_OUTPUT=$(../image_denoise --test -m separable_f16 -k 7 -o f16 2>&1)
+F16_PSNR=$(echo "$F16_OUTPUT" | sed -n 's/.*PSNR vs float32: \([0-9.]*\) dB.*/\1/p')
+
+# 11 bits de mantisse pour des valeurs dans [0, 255]: PSNR attendu > 70 dB
+if [ -n "$F16_PSNR" ] && awk "BEGIN { exit !($F16_PSNR >= 60) }" && [ -f "data/f16_separable_f16.png" ]; then
+    echo -e "${GREEN}✓ PSNR vs float32: ${F16_PSNR} dB${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ PSNR insuffisant: ${F16_PSNR:-inconnu} dB (minimum 60 dB)${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: désentrelacement SIMD identique à la boucle scalaire (1, 3, 4 canaux)
+echo "Test $((TESTS_TOTAL + 1)): Désentrelacement u8 -> float (SIMD vs scalaire)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+if [ -f "./image_bench" ]; then
+    DEINTERLEAVE_OK=true
+    for c in 1 3 4; do
+        # Largeur impaire: couvre la fin de ligne scalaire
+        if ! ./image_bench deinterleave -W 257 -H 33 -c $c -r 1 > /dev/null 2>&1; then
+            DEINTERLEAVE_OK=false
+            echo -e "${RED}✗ Résultats différents pour $c canal(aux)${NC}"
+        fi
+    done
+    if [ "$DEINTERLEAVE_OK" = true ]; then
+        echo -e "${GREEN}✓ Conversions identiques (1, 3 et 4 canaux)${NC}"
+        TESTS_PASSED=$((TESTS_PASSED + 1))
+    else
+        TESTS_FAILED=$((TESTS_FAILED + 1))
+    fi
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), test ignoré${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+fi
+echo ""
+
+# Test: luminance pleine résolution + chrominance à mi-résolution, proche du
+# filtrage RGB complet
+echo "Test $((TESTS_TOTAL + 1)): Débruitage luma/chroma (YCbCr 4:2:0) vs séparable RGB"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_luma_chroma"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+LC_OUTPUT=$(../image_denoise --test -m luma_chroma -k 7 -o lc 2>&1)
+LC_PSNR=$(echo "$LC_OUTPUT" | sed -n 's/.*PSNR vs séparable RGB: \([0-9.]*\) dB.*/\1/p')
+
+if [ -n "$LC_PSNR" ] && awk "BEGIN { exit !($LC_PSNR >= 40) }" && [ -f "data/lc_luma_chroma.png" ]; then
+    echo -e "${GREEN}✓ PSNR vs séparable RGB: ${LC_PSNR} dB${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ PSNR insuffisant: ${LC_PSNR:-inconnu} dB (minimum 40 dB)${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: canal alpha recopié tel quel, seuls les canaux de couleur débruités
+echo "Test $((TESTS_TOTAL + 1)): Canal alpha préservé (RGBA)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+if [ -f "./image_bench" ]; then
+    TEST_DIR="test_alpha"
+    mkdir -p "$TEST_DIR/data"
+    cd "$TEST_DIR"
+    
+    ALPHA_OK=true
+    # Détection SIMD et aller-retour exact (2 et 4 canaux, largeur impaire)
+    for c in 2 4; do
+        if ! ../image_bench alpha -W 257 -H 33 -c $c -r 1 > /dev/null 2>&1; then
+            ALPHA_OK=false
+            echo -e "${RED}✗ Détection ou aller-retour erroné pour $c canaux${NC}"
+        fi
+    done
+    
+    ../image_bench alpha -W 257 -H 65 -c 4 -o data/rgba.png > /dev/null 2>&1
+    ../image_denoise -i data/rgba.png -m all -k 5 -o alpha > /dev/null 2>&1
+    for f in noisy spatial separable fft; do
+        if ! ../image_bench alpha -W 257 -H 65 -c 4 -i "data/alpha_$f.png" > /dev/null 2>&1; then
+            ALPHA_OK=false
+            echo -e "${RED}✗ Alpha modifié ou absent: alpha_$f.png${NC}"
+        fi
+    done
+    
+    if [ "$ALPHA_OK" = true ]; then
+        echo -e "${GREEN}✓ Alpha identique à l'entrée pour toutes les méthodes${NC}"
+        TESTS_PASSED=$((TESTS_PASSED + 1))
+    else
+        TESTS_FAILED=$((TESTS_FAILED + 1))
+    fi
+    
+    cd ..
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), test ignoré${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+fi
+echo ""
+
+# Test: débruitage par bandes (PNG ligne à ligne) identique à l'image entière
+echo "Test $((TESTS_TOTAL + 1)): Débruitage par bandes (--strip) vs image entière"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+if [ -f "./image_bench" ]; then
+    TEST_DIR="test_strip"
+    mkdir -p "$TEST_DIR/data"
+    cd "$TEST_DIR"
+    
+    STRIP_OK=true
+    # Entrée écrite par stb_image_write, bandes plus petites que le halo
+    ../image_denoise --test -m separable -k 3 -o source > /dev/null 2>&1
+    if ! ../image_bench strip -i data/source_noisy.png -S 2 -k 7 > /dev/null 2>&1; then
+        STRIP_OK=false
+        echo -e "${RED}✗ Résultat différent de l'image entière (source_noisy.png)${NC}"
+    fi
+    # Images écrites par bandes, tous les nombres de canaux (alpha recopié)
+    for c in 1 2 3 4; do
+        if ! ../image_bench strip -W 333 -H 257 -c $c -S 16 -k 9 > /dev/null 2>&1; then
+            STRIP_OK=false
+            echo -e "${RED}✗ Résultat différent de l'image entière ($c canaux)${NC}"
+        fi
+    done
+    ../image_denoise -i data/source_noisy.png --strip 32 -o strip > /dev/null 2>&1
+    if [ ! -f "data/strip_separable.png" ]; then
+        STRIP_OK=false
+        echo -e "${RED}✗ Fichier manquant: strip_separable.png${NC}"
+    fi
+    
+    if [ "$STRIP_OK" = true ]; then
+        echo -e "${GREEN}✓ Résultats identiques (0 LSB), 1 à 4 canaux${NC}"
+        TESTS_PASSED=$((TESTS_PASSED + 1))
+    else
+        TESTS_FAILED=$((TESTS_FAILED + 1))
+    fi
+    
+    cd ..
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), test ignoré${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+fi
+echo ""
+
+# Test: encodeur PNG parallèle (flux zlib valide, pixels relus identiques)
+echo "Test $((TESTS_TOTAL + 1)): Encodeur PNG parallèle"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+if [ -f "./image_bench" ]; then
+    TEST_DIR="test_png"
+    mkdir -p "$TEST_DIR/data"
+    cd "$TEST_DIR"
+    
+    PNG_OK=true
+    # Plusieurs blocs de 128 Ko par image, 1 à 4 canaux, plusieurs threads
+    for c in 1 2 3 4; do
+        if ! OMP_NUM_THREADS=4 ../image_bench png -W 1001 -H 377 -c $c -r 0 > /dev/null 2>&1; then
+            PNG_OK=false
+            echo -e "${RED}✗ PNG invalide ou pixels différents ($c canaux)${NC}"
+        fi
+    done
+    # Le fichier ne dépend pas du nombre de threads, quel que soit le niveau
+    for level in 0 1 9; do
+        ../image_denoise --test -m separable -t 1 --png-level $level -o l${level}_t1 > /dev/null 2>&1
+        ../image_denoise --test -m separable -t 4 --png-level $level -o l${level}_t4 > /dev/null 2>&1
+        if ! cmp -s "data/l${level}_t1_separable.png" "data/l${level}_t4_separable.png"; then
+            PNG_OK=false
+            echo -e "${RED}✗ Fichiers différents selon -t (niveau $level)${NC}"
+        fi
+    done
+    
+    if [ "$PNG_OK" = true ]; then
+        echo -e "${GREEN}✓ PNG valides et identiques quel que soit le nombre de threads${NC}"
+        TESTS_PASSED=$((TESTS_PASSED + 1))
+    else
+        TESTS_FAILED=$((TESTS_FAILED + 1))
+    fi
+    
+    cd ..
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), test ignoré${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+fi
+echo ""
+
+# Test: entrées/sorties flottantes projetées (PFM, planaire sans copie)
+echo "Test $((TESTS_TOTAL + 1)): Entrées/sorties flottantes (.pfm, .planar)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_floatio"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+FLOAT_OK=true
+# Aller-retour exact des flottants (gris et RGB, dimensions impaires)
+if [ -f "../image_bench" ]; then
+    for c in 1 3; do
+        if ! ../image_bench floatio -W 333 -H 257 -c $c -r 1 > /dev/null 2>&1; then
+            FLOAT_OK=false
+            echo -e "${RED}✗ Aller-retour inexact ou planaire copié ($c canaux)${NC}"
+        fi
+    done
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), aller-retour non vérifié${NC}"
+fi
+# Même image bruitée en PFM et en planaire: mêmes résultats, planaire sans copie
+../image_denoise --test -m separable --format pfm -o src > /dev/null 2>&1
+../image_denoise --test -m separable --format planar -o src > /dev/null 2>&1
+../image_denoise -i data/src_noisy.pfm -n 0 -m separable --format planar -o pfm > /dev/null 2>&1
+MAPPED=$(../image_denoise -i data/src_noisy.planar -n 0 -m separable --format planar -o planar 2>&1 \
+         | grep -c "sans copie")
+if [ "$MAPPED" != "1" ]; then
+    FLOAT_OK=false
+    echo -e "${RED}✗ Entrée planaire alignée non projetée sans copie${NC}"
+fi
+if ! cmp -s data/pfm_separable.planar data/planar_separable.planar; then
+    FLOAT_OK=false
+    echo -e "${RED}✗ Résultats différents depuis .pfm et .planar${NC}"
+fi
+# En-têtes forgés dont la taille calculée déborde à une valeur minuscule
+# (2^30 x 2^30 x 4 canaux x 4 octets = 2^64), fichiers de quelques octets
+printf 'FPLANAR1\000\000\000\100\000\000\000\100\004\000\000\000\100\000\000\000' > forge.planar
+head -c 112 /dev/zero >> forge.planar
+printf 'PF\n842443544 1824726041\n-1.0\n' > forge.pfm
+head -c 64 /dev/zero >> forge.pfm
+for f in forge.planar forge.pfm; do
+    RC=0
+    ../image_denoise -i $f -n 0 -m separable -o forge > forge.log 2>&1 || RC=$?
+    if [ $RC -ne 1 ] || ! grep -q "Erreur" forge.log; then
+        FLOAT_OK=false
+        echo -e "${RED}✗ En-tête forgé accepté ou plantage ($f, code $RC)${NC}"
+    fi
+done
+
+if [ "$FLOAT_OK" = true ]; then
+    echo -e "${GREEN}✓ Flottants conservés exactement, entrée planaire sans copie${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: formats de sortie (PPM/PGM, QOI, JPEG), extension de -o et mode -q
+echo "Test $((TESTS_TOTAL + 1)): Formats de sortie (ppm, qoi, jpg)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_encode"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+ENCODE_OK=true
+# Relecture exacte des formats sans perte (gris et RGB, dimensions impaires)
+if [ -f "../image_bench" ]; then
+    for c in 1 3; do
+        if ! ../image_bench encode -W 333 -H 257 -c $c -r 0 > /dev/null 2>&1; then
+            ENCODE_OK=false
+            echo -e "${RED}✗ Pixels relus différents ($c canaux)${NC}"
+        fi
+    done
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), relecture non vérifiée${NC}"
+fi
+# Format déduit de l'extension de -o, ou donné par --format; -q: aucun message
+# par fichier sauvegardé
+SAVED=$(../image_denoise --test -m separable -q -o res.ppm 2>&1 | grep -c "sauvegardée" || true)
+../image_denoise --test -m separable --format qoi -o res > /dev/null 2>&1
+../image_denoise --test -m separable -o res.jpg > /dev/null 2>&1
+if [ "$SAVED" != "0" ]; then
+    ENCODE_OK=false
+    echo -e "${RED}✗ Messages de sauvegarde malgré -q${NC}"
+fi
+if [ "$(head -c 2 data/res_separable.ppm 2>/dev/null)" != "P6" ] ||
+   [ "$(head -c 4 data/res_separable.qoi 2>/dev/null)" != "qoif" ] ||
+   [ ! -s data/res_separable.jpg ]; then
+    ENCODE_OK=false
+    echo -e "${RED}✗ Fichiers .ppm, .qoi ou .jpg absents ou invalides${NC}"
+fi
+
+if [ "$ENCODE_OK" = true ]; then
+    echo -e "${GREEN}✓ Formats PPM, QOI et JPEG écrits, relectures exactes${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: mode lots (répertoire et liste), résultats identiques à un appel par image
+echo "Test $((TESTS_TOTAL + 1)): Traitement par lots (--batch)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_batch"
+mkdir -p "$TEST_DIR/data" "$TEST_DIR/lot"
+cd "$TEST_DIR"
+
+BATCH_OK=true
+# Lot: RGB (png), gris (pgm), flottant (pfm) et, si image_bench est présent, RGBA
+../image_denoise --test -m separable -q -o rgb > /dev/null 2>&1
+../image_denoise --test -m separable -q --format pgm -o gris > /dev/null 2>&1
+../image_denoise --test -m separable -q --format pfm -o flottant > /dev/null 2>&1
+cp data/rgb_noisy.png lot/rgb.png
+cp data/gris_noisy.ppm lot/gris.ppm
+cp data/flottant_noisy.pfm lot/flottant.pfm
+if [ -f "../image_bench" ]; then
+    ../image_bench alpha -W 301 -H 203 -c 4 -r 0 -o lot/rgba.png > /dev/null 2>&1
+fi
+ls lot/* > liste.txt
+
+for m in separable spatial_blas; do
+    ../image_denoise --batch lot -m $m -t 4 --workers 2 -o rep > /dev/null 2>&1
+    ../image_denoise --batch liste.txt -m $m -t 4 --workers 4 -o liste > /dev/null 2>&1
+    for f in lot/*; do
+        name=$(basename "${f%.*}")
+        ../image_denoise -i "$f" -m $m -q -o seul > /dev/null 2>&1
+        if ! cmp -s "data/seul_$m.png" "data/rep_${name}_$m.png" ||
+           ! cmp -s "data/seul_$m.png" "data/liste_${name}_$m.png"; then
+            BATCH_OK=false
+            echo -e "${RED}✗ $name ($m): résultat du lot différent de l'appel seul${NC}"
+        fi
+    done
+done
+# Même nom sans extension (x.png et x.ppm, a/x.png et b/x.png): lot refusé
+mkdir -p double/a double/b
+cp lot/rgb.png double/a/x.png
+cp lot/rgb.png double/b/x.png
+cp lot/gris.ppm double/a/x.ppm
+printf 'double/a/x.png\ndouble/b/x.png\n' > double.txt
+for src in double/a double.txt; do
+    RC=0
+    ../image_denoise --batch $src -t 2 -o double > double.log 2>&1 || RC=$?
+    if [ $RC -eq 0 ] || ! grep -q "même résultat" double.log; then
+        BATCH_OK=false
+        echo -e "${RED}✗ Noms de résultat en double acceptés ($src)${NC}"
+    fi
+done
+if ! ../image_denoise --batch lot -t 2 -o rep 2>&1 | grep -q "Latence par image"; then
+    BATCH_OK=false
+    echo -e "${RED}✗ Latences du lot non affichées${NC}"
+fi
+
+if [ "$BATCH_OK" = true ]; then
+    echo -e "${GREEN}✓ Résultats du lot identiques aux appels par image${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+# Test: pipeline lecture / calcul / écriture, mêmes résultats que le lot séquentiel
+echo "Test $((TESTS_TOTAL + 1)): Pipeline asynchrone (--pipeline)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_pipeline"
+mkdir -p "$TEST_DIR/data" "$TEST_DIR/lot"
+cd "$TEST_DIR"
+
+PIPE_OK=true
+../image_denoise --test -m separable -q -o rgb > /dev/null 2>&1
+../image_denoise --test -m separable -q --format pgm -o gris > /dev/null 2>&1
+for i in 1 2 3 4 5; do
+    cp data/rgb_noisy.png lot/rgb$i.png
+    cp data/gris_noisy.ppm lot/gris$i.ppm
+done
+echo "lot/absente.png" > liste.txt
+ls lot/* >> liste.txt
+
+../image_denoise --batch lot -t 2 --workers 1 -o seq > /dev/null 2>&1
+# Files d'une image (sans avance) à plusieurs images d'avance
+for depth in 1 3; do
+    OUT=$(../image_denoise --batch lot -t 2 --pipeline $depth -o pipe$depth 2>&1)
+    if ! echo "$OUT" | grep -q "Attente sortie"; then
+        PIPE_OK=false
+        echo -e "${RED}✗ Attentes par étape non affichées (profondeur $depth)${NC}"
+    fi
+    for f in lot/*; do
+        name=$(basename "${f%.*}")
+        if ! cmp -s "data/seq_${name}_separable.png" "data/pipe${depth}_${name}_separable.png"; then
+            PIPE_OK=false
+            echo -e "${RED}✗ $name: résultat différent du lot séquentiel (profondeur $depth)${NC}"
+        fi
+    done
+done
+# Une image illisible est comptée en échec sans bloquer le pipeline
+if ../image_denoise --batch liste.txt -t 2 --pipeline 2 -o err 2>&1 | grep -q "échecs: 1)"; then
+    :
+else
+    PIPE_OK=false
+    echo -e "${RED}✗ Image illisible mal comptée${NC}"
+fi
+
+if [ "$PIPE_OK" = true ]; then
+    echo -e "${GREEN}✓ Résultats identiques au lot séquentiel, attentes affichées${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+echo "Test $((TESTS_TOTAL + 1)): Service persistant (--serve / --client)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_serve"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+SERVE_OK=true
+../image_denoise --test -m separable -q -o src > /dev/null 2>&1
+cp data/src_noisy.png entree.png
+rm -f service.sock
+../image_denoise --serve service.sock -t 2 --workers 2 > service.log 2>&1 &
+SERVE_PID=$!
+for i in $(seq 50); do
+    [ -S service.sock ] && break
+    sleep 0.1
+done
+# Socket réservée à l'utilisateur du service
+if [ "$(stat -c %a service.sock 2>/dev/null)" != "600" ]; then
+    SERVE_OK=false
+    echo -e "${RED}✗ Socket accessible aux autres utilisateurs ($(stat -c %a service.sock 2>/dev/null))${NC}"
+fi
+
+# Clients simultanés (noyaux et graines différents) vs appels directs
+../image_denoise --client service.sock -i entree.png -m separable -k 9 -s 2.5 -o c1 > c1.log 2>&1 &
+CLIENT1_PID=$!
+../image_denoise --client service.sock -i entree.png -m spatial -k 5 -n 10 -o c2 > c2.log 2>&1 &
+CLIENT2_PID=$!
+../image_denoise --client service.sock -i entree.png -m separable -k 9 -s 2.5 --seed 7 -o c3 > c3.log 2>&1 &
+CLIENT3_PID=$!
+wait $CLIENT1_PID $CLIENT2_PID $CLIENT3_PID || true
+../image_denoise -i entree.png -m separable -k 9 -s 2.5 -q -o d1 > /dev/null 2>&1
+../image_denoise -i entree.png -m spatial -k 5 -n 10 -q -o d2 > /dev/null 2>&1
+../image_denoise -i entree.png -m separable -k 9 -s 2.5 --seed 7 -q -o d3 > /dev/null 2>&1
+for n in 1 2 3; do
+    if ! grep -q "^OK ms=" c$n.log; then
+        SERVE_OK=false
+        echo -e "${RED}✗ Client $n: $(cat c$n.log)${NC}"
+    fi
+done
+if ! cmp -s data/c1_separable.png data/d1_separable.png ||
+   ! cmp -s data/c2_spatial.png data/d2_spatial.png ||
+   ! cmp -s data/c3_separable.png data/d3_separable.png; then
+    SERVE_OK=false
+    echo -e "${RED}✗ Résultats du service différents des appels directs${NC}"
+fi
+# Entrée grise en PNM: .pgm comme un appel direct (extension choisie par le service)
+printf 'P5\n64 48\n255\n' > gris.pgm
+head -c 3072 /dev/urandom >> gris.pgm
+../image_denoise --client service.sock -i gris.pgm -m separable --format pnm -o g1 > g1.log 2>&1 || true
+../image_denoise -i gris.pgm -m separable --format pnm -q -o g2 > /dev/null 2>&1
+if ! cmp -s data/g1_separable.pgm data/g2_separable.pgm || ! grep -q "out=.*g1_separable.pgm" g1.log; then
+    SERVE_OK=false
+    echo -e "${RED}✗ Sortie grise du service mal nommée: $(cat g1.log)${NC}"
+fi
+# Erreur renvoyée au client, service toujours disponible
+if ../image_denoise --client service.sock -i absente.png > /dev/null 2>&1; then
+    SERVE_OK=false
+    echo -e "${RED}✗ Image absente acceptée${NC}"
+fi
+# Ligne plus longue que la limite du service: refusée, pas tronquée
+if [ -f ../image_bench ] &&
+   ! ../image_bench service -S service.sock -r 3 -L 10000 2>&1 | grep -q "ERR requête trop longue"; then
+    SERVE_OK=false
+    echo -e "${RED}✗ Requête trop longue acceptée${NC}"
+fi
+if ! ../image_denoise --client service.sock 2>&1 | grep -q "jobs=4 failed=0"; then
+    SERVE_OK=false
+    echo -e "${RED}✗ Statistiques du service incorrectes${NC}"
+fi
+../image_denoise --client service.sock --stop > /dev/null 2>&1 || true
+wait $SERVE_PID || SERVE_OK=false
+if [ -e service.sock ] || ! grep -q "Service arrêté: 4 requêtes" service.log; then
+    SERVE_OK=false
+    echo -e "${RED}✗ Arrêt du service incorrect${NC}"
+fi
+
+if [ "$SERVE_OK" = true ]; then
+    echo -e "${GREEN}✓ Résultats identiques aux appels directs, clients simultanés${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
+echo "Test $((TESTS_TOTAL + 1)): Service par mémoire partagée (--shm)"
+echo "────────────────────────────────────────────────────────────────"
+TESTS_TOTAL=$((TESTS_TOTAL + 1))
+
+TEST_DIR="test_shm"
+mkdir -p "$TEST_DIR/data"
+cd "$TEST_DIR"
+
+SHM_OK=true
+../image_denoise --test -m separable -q -o src > /dev/null 2>&1
+cp data/src_noisy.png entree.png
+../image_denoise -i entree.png -m separable -n 0 -q --format planar -o flottant > /dev/null 2>&1
+rm -f service.sock
+../image_denoise --serve service.sock -t 2 > service.log 2>&1 &
+SERVE_PID=$!
+for i in $(seq 50); do
+    [ -S service.sock ] && break
+    sleep 0.1
+done
+
+# Segments u8 (PNG, QOI) et float32 (planaire -> PFM) vs appels directs
+../image_denoise --client service.sock --shm -i entree.png -m separable -k 9 -s 2.5 -q -o s1 > /dev/null 2>&1 || SHM_OK=false
+../image_denoise --client service.sock --shm -i entree.png -m spatial -k 5 --format qoi -q -o s2 > /dev/null 2>&1 || SHM_OK=false
+../image_denoise --client service.sock --shm -i data/flottant_separable.planar -m separable -n 0 --format pfm -q -o s3 > /dev/null 2>&1 || SHM_OK=false
+../image_denoise -i entree.png -m separable -k 9 -s 2.5 -q -o d1 > /dev/null 2>&1
+../image_denoise -i entree.png -m spatial -k 5 --format qoi -q -o d2 > /dev/null 2>&1
+../image_denoise -i data/flottant_separable.planar -m separable -n 0 --format pfm -q -o d3 > /dev/null 2>&1
+printf 'P5\n64 48\n255\n' > gris.pgm
+head -c 3072 /dev/urandom >> gris.pgm
+../image_denoise --client service.sock --shm -i gris.pgm -m separable --format pnm -q -o s4 > /dev/null 2>&1 || SHM_OK=false
+../image_denoise -i gris.pgm -m separable --format pnm -q -o d4 > /dev/null 2>&1
+# RGBA: alpha porté par le segment, rétabli en PNG et QOI, ignoré en PPM
+if [ -f "../image_bench" ]; then
+    ../image_bench alpha -W 301 -H 203 -c 4 -r 0 -o rgba.png > /dev/null 2>&1
+    for f in png qoi pnm; do
+        ../image_denoise --client service.sock --shm -i rgba.png -m separable --format $f -q -o s_$f > /dev/null 2>&1 || SHM_OK=false
+        ../image_denoise -i rgba.png -m separable --format $f -q -o d_$f > /dev/null 2>&1
+    done
+    if ! cmp -s data/s_png_separable.png data/d_png_separable.png ||
+       ! cmp -s data/s_qoi_separable.qoi data/d_qoi_separable.qoi ||
+       ! cmp -s data/s_pnm_separable.ppm data/d_pnm_separable.ppm ||
+       ! ../image_bench alpha -W 301 -H 203 -c 4 -i data/s_png_separable.png > /dev/null 2>&1; then
+        SHM_OK=false
+        echo -e "${RED}✗ Alpha perdu ou résultat RGBA différent de l'appel direct${NC}"
+    fi
+else
+    echo -e "${YELLOW}⚠ image_bench absent (make bench), cas RGBA ignoré${NC}"
+fi
+if ! cmp -s data/s1_separable.png data/d1_separable.png ||
+   ! cmp -s data/s2_spatial.qoi data/d2_spatial.qoi ||
+   ! cmp -s data/s3_separable.pfm data/d3_separable.pfm ||
+   ! cmp -s data/s4_separable.pgm data/d4_separable.pgm; then
+    SHM_OK=false
+    echo -e "${RED}✗ Résultats par mémoire partagée différents des appels directs${NC}"
+fi
+# Segments supprimés par le client après lecture du résultat
+if ls /dev/shm 2>/dev/null | grep -q "image_denoise-"; then
+    SHM_OK=false
+    echo -e "${RED}✗ Segments partagés non supprimés${NC}"
+fi
+../image_denoise --client service.sock --stop > /dev/null 2>&1 || true
+wait $SERVE_PID || SHM_OK=false
+
+if [ "$SHM_OK" = true ]; then
+    echo -e "${GREEN}✓ Résultats identiques aux appels directs (u8 et float32)${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+cd ..
+echo ""
+
 # ============================================================================
 # TESTS DE PERFORMANCE
 # ============================================================================
@@ -0,0 +1,757 @@
+// sockets Unix, sigaction, pipe, strtok_r, clock_gettime ne sont pas exposés en C11 strict
+#define _GNU_SOURCE
+
+#include "server.h"
+#include "batch.h"
+#include "filters.h"
+#include "mkl_ops.h"
+#include "io.h"
+#include "float_io.h"
+#include "shm_image.h"
+#include <errno.h>
+#include <limits.h>
+#include <omp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SERVER_LINE_MAX 8192
+#define SERVER_MAX_CONNECTIONS 256
+#define KERNEL_CACHE_SIZE 4
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+// Noyaux d'un couple (taille, sigma), créés à la première requête qui les utilise
+typedef struct {
+    int kernel_size;
+    float sigma;
+    Kernel *kernel_2d;
+    float *kernel_1d;
+} CachedKernel;
+
+// Emplacement de calcul: une requête à la fois, état gardé entre requêtes
+typedef struct {
+    ConvWorkspace *ws;
+    CachedKernel kernels[KERNEL_CACHE_SIZE];
+    int next_victim;            // Remplacement circulaire quand le cache est plein
+    ImageFloat *input;          // Segments u8: plans convertis en flottant
+    ImageFloat *output;         // Segments u8: résultat avant quantification
+    int busy;
+} ServerSlot;
+
+typedef struct {
+    ServerSlot *slots;
+    int num_slots;
+    int threads_per_job;
+    int listen_fd;
+    pthread_mutex_t lock;
+    pthread_cond_t slot_free;   // Un emplacement s'est libéré
+    pthread_cond_t idle;        // Une connexion s'est fermée
+    int connections[SERVER_MAX_CONNECTIONS];    // Descripteurs ouverts (-1: libre)
+    int active;                 // Connexions ouvertes
+    int stopping;
+    long jobs, failed;
+    double total_ms, max_ms;
+} Server;
+
+typedef struct {
+    Server *server;
+    int fd;
+    int index;                  // Rang dans server->connections
+} Connection;
+
+// SIGINT / SIGTERM: un octet dans ce tube réveille la boucle d'accept, quel
+// que soit le thread (connexion, OpenMP, MKL) qui reçoit le signal
+static int stop_pipe[2] = {-1, -1};
+
+static void on_stop_signal(int sig) {
+    (void)sig;
+    ssize_t n = write(stop_pipe[1], "", 1);
+    (void)n;
+}
+
+// Noyaux de l'emplacement pour (taille, sigma), créés au premier usage
+static CachedKernel *slot_kernels(ServerSlot *slot, int kernel_size, float sigma) {
+    for (int i = 0; i < KERNEL_CACHE_SIZE; i++) {
+        CachedKernel *entry = &slot->kernels[i];
+        if (entry->kernel_1d && entry->kernel_size == kernel_size && entry->sigma == sigma) {
+            return entry;
+        }
+    }
+    
+    CachedKernel *entry = &slot->kernels[slot->next_victim];
+    slot->next_victim = (slot->next_victim + 1) % KERNEL_CACHE_SIZE;
+    if (entry->kernel_2d) free_kernel(entry->kernel_2d);
+    if (entry->kernel_1d) mkl_free(entry->kernel_1d);
+    entry->kernel_size = kernel_size;
+    entry->sigma = sigma;
+    entry->kernel_2d = create_gaussian_kernel(kernel_size, sigma);
+    entry->kernel_1d = create_gaussian_kernel_1d(kernel_size, sigma);
+    if (!entry->kernel_2d || !entry->kernel_1d) {
+        if (entry->kernel_2d) free_kernel(entry->kernel_2d);
+        if (entry->kernel_1d) mkl_free(entry->kernel_1d);
+        entry->kernel_2d = NULL;
+        entry->kernel_1d = NULL;
+        return NULL;
+    }
+    return entry;
+}
+
+static ServerSlot *acquire_slot(Server *server) {
+    pthread_mutex_lock(&server->lock);
+    ServerSlot *slot = NULL;
+    while (!slot) {
+        for (int i = 0; i < server->num_slots && !slot; i++) {
+            if (!server->slots[i].busy) slot = &server->slots[i];
+        }
+        if (!slot) pthread_cond_wait(&server->slot_free, &server->lock);
+    }
+    slot->busy = 1;
+    pthread_mutex_unlock(&server->lock);
+    return slot;
+}
+
+static void release_slot(Server *server, ServerSlot *slot, int ok, double service_ms) {
+    pthread_mutex_lock(&server->lock);
+    slot->busy = 0;
+    server->jobs++;
+    if (!ok) server->failed++;
+    server->total_ms += service_ms;
+    if (service_ms > server->max_ms) server->max_ms = service_ms;
+    pthread_cond_signal(&server->slot_free);
+    pthread_mutex_unlock(&server->lock);
+}
+
+// Champs clé=valeur d'une requête DENOISE / DENOISE_SHM, déjà découpés par
+// strtok_r; options validées, in= et out= obligatoires
+static int parse_job(char *fields, BatchOptions *options, const char **input,
+                     const char **output, char *reply, size_t reply_size) {
+    char *save = NULL;
+    *input = *output = NULL;
+    for (char *field = strtok_r(fields, " ", &save); field; field = strtok_r(NULL, " ", &save)) {
+        char *value = strchr(field, '=');
+        if (!value) {
+            snprintf(reply, reply_size, "ERR champ invalide '%s'", field);
+            return 0;
+        }
+        *value++ = '\0';
+        if (strcmp(field, "in") == 0) *input = value;
+        else if (strcmp(field, "out") == 0) *output = value;
+        else if (strcmp(field, "method") == 0) options->method = value;
+        else if (strcmp(field, "k") == 0) options->kernel_size = atoi(value);
+        else if (strcmp(field, "sigma") == 0) options->sigma = (float)atof(value);
+        else if (strcmp(field, "noise") == 0) options->noise_sigma = (float)atof(value);
+        else if (strcmp(field, "seed") == 0) options->noise_seed = (unsigned int)strtoul(value, NULL, 10);
+        else if (strcmp(field, "format") == 0) {
+            options->format = image_format_from_name(value);
+            if (options->format == IMAGE_FORMAT_UNKNOWN) {
+                snprintf(reply, reply_size, "ERR format inconnu '%s'", value);
+                return 0;
+            }
+        } else {
+            snprintf(reply, reply_size, "ERR champ inconnu '%s'", field);
+            return 0;
+        }
+    }
+    if (!*input || !*output) {
+        snprintf(reply, reply_size, "ERR in= et out= sont obligatoires");
+        return 0;
+    }
+    if (!batch_method_supported(options->method)) {
+        snprintf(reply, reply_size, "ERR méthode inconnue '%s' (spatial|spatial_blas|separable|fft)",
+                 options->method);
+        return 0;
+    }
+    if (options->kernel_size < 1 || options->sigma <= 0.0f) {
+        snprintf(reply, reply_size, "ERR noyau invalide (k=%d, sigma=%g)", options->kernel_size,
+                 options->sigma);
+        return 0;
+    }
+    return 1;
+}
+
+// DENOISE in=<fichier> out=<fichier> [clé=valeur...]; avec format=, out est
+// un nom sans extension, complété d'après les canaux de l'image
+static void handle_denoise(Server *server, char *fields, double start, char *reply,
+                           size_t reply_size) {
+    const char *input, *output;
+    BatchOptions options = {"separable", 7, 2.0f, 0.0f, 42, IMAGE_FORMAT_UNKNOWN, NULL,
+                            1, server->threads_per_job, 0};
+    if (!parse_job(fields, &options, &input, &output, reply, reply_size)) return;
+    if (options.format == IMAGE_FORMAT_UNKNOWN &&
+        image_format_from_filename(output) == IMAGE_FORMAT_UNKNOWN) {
+        snprintf(reply, reply_size, "ERR extension de sortie inconnue '%s'", output);
+        return;
+    }
+    
+    ServerSlot *slot = acquire_slot(server);
+    double wait = now_ms() - start;
+    CachedKernel *kernels = slot_kernels(slot, options.kernel_size, options.sigma);
+    double stage_ms[3] = {0.0, 0.0, 0.0};
+    int width = 0, height = 0, channels = 0;
+    int ok = kernels && denoise_file(input, output, &options, kernels->kernel_2d,
+                                     kernels->kernel_1d, slot->ws, stage_ms, &width, &height,
+                                     &channels);
+    double service = now_ms() - start;
+    release_slot(server, slot, ok, service);
+    
+    if (ok) {
+        int len = snprintf(reply, reply_size, "OK ms=%.2f wait=%.2f load=%.2f filter=%.2f "
+                           "save=%.2f size=%dx%d", service, wait, stage_ms[0], stage_ms[1],
+                           stage_ms[2], width, height);
+        // Nom complété par le service: renvoyé à l'appelant
+        if (options.format != IMAGE_FORMAT_UNKNOWN && len > 0 && (size_t)len < reply_size) {
+            snprintf(reply + len, reply_size - (size_t)len, " out=%s.%s", output,
+                     image_format_extension(options.format, channels));
+        }
+    } else {
+        snprintf(reply, reply_size, "ERR échec du traitement de '%s'", input);
+    }
+}
+
+// Image de travail d'un emplacement, réallouée seulement si les dimensions changent
+static ImageFloat *slot_image(ImageFloat **img, int width, int height, int channels) {
+    if (!*img || (*img)->width != width || (*img)->height != height ||
+        (*img)->channels != channels) {
+        free_image_float(*img);
+        *img = create_image_float_uninit(width, height, channels);
+    }
+    return *img;
+}
+
+// Calcul d'une requête DENOISE_SHM: entrée float32 enveloppée sans copie
+// (projection privée: bruit et normalisation ne touchent pas le segment de
+// l'appelant), entrée u8 convertie dans l'image de travail; résultat
+// float32 écrit directement dans le segment de sortie, ou quantifié en u8.
+// L'alpha d'une entrée u8 (dernier plan à 2 ou 4 canaux) n'est pas débruité:
+// il est recopié tel quel si le segment de sortie u8 a un plan de plus que
+// les couleurs, comme save_image_as le rétablit, et ignoré sinon
+static int denoise_segments(ServerSlot *slot, const CachedKernel *kernels,
+                            const BatchOptions *options, const char *input_name,
+                            const char *output_name, double stage_ms[3], int *width,
+                            int *height, char *reply, size_t reply_size) {
+    double t0 = now_ms();
+    ShmImage *in = shm_image_open(input_name, 0);
+    ShmImage *out = in ? shm_image_open(output_name, 1) : NULL;
+    if (!in || !out) {
+        snprintf(reply, reply_size, "ERR segment invalide '%s'", in ? output_name : input_name);
+        shm_image_close(in);
+        return 0;
+    }
+    int has_alpha = in->sample == SHM_SAMPLE_U8 && (in->channels == 2 || in->channels == 4);
+    int colors = has_alpha ? in->channels - 1 : in->channels;
+    int keep_alpha = has_alpha && out->sample == SHM_SAMPLE_U8 && out->channels == in->channels;
+    if (out->width != in->width || out->height != in->height ||
+        (out->channels != colors && !keep_alpha)) {
+        snprintf(reply, reply_size, "ERR dimensions du segment de sortie différentes (%dx%dx%d)",
+                 out->width, out->height, out->channels);
+        shm_image_close(in);
+        shm_image_close(out);
+        return 0;
+    }
+    *width = in->width;
+    *height = in->height;
+    
+    ImageFloat *noisy;
+    if (in->sample == SHM_SAMPLE_F32) {
+        noisy = shm_image_float_view(in);
+    } else {
+        noisy = slot_image(&slot->input, in->width, in->height, colors);
+        if (noisy && !shm_image_read_u8(in, noisy)) noisy = NULL;
+    }
+    ImageFloat *result = out->sample == SHM_SAMPLE_F32
+                         ? shm_image_float_view(out)
+                         : slot_image(&slot->output, out->width, out->height, colors);
+    double t1 = now_ms();
+    
+    float lo = 0.0f, hi = 0.0f;
+    int ok = noisy && result && kernels &&
+             denoise_image(noisy, result, options, kernels->kernel_2d, kernels->kernel_1d,
+                           slot->ws, &lo, &hi);
+    double t2 = now_ms();
+    
+    if (ok && out->sample == SHM_SAMPLE_U8) ok = shm_image_write_u8(out, result, lo, hi);
+    if (ok && keep_alpha) {
+        size_t plane = (size_t)in->width * in->height;
+        memcpy((unsigned char *)out->data + colors * plane,
+               (const unsigned char *)in->data + colors * plane, plane);
+    }
+    double t3 = now_ms();
+    
+    // Les vues sur les segments sont libérées avant leur projection
+    if (in->sample == SHM_SAMPLE_F32) free_image_float(noisy);
+    if (out->sample == SHM_SAMPLE_F32) free_image_float(result);
+    shm_image_close(in);
+    shm_image_close(out);
+    stage_ms[0] = t1 - t0;
+    stage_ms[1] = t2 - t1;
+    stage_ms[2] = t3 - t2;
+    if (!ok) snprintf(reply, reply_size, "ERR échec du traitement de '%s'", input_name);
+    return ok;
+}
+
+// DENOISE_SHM in=<segment> out=<segment> [clé=valeur...]
+static void handle_denoise_shm(Server *server, char *fields, double start, char *reply,
+                               size_t reply_size) {
+    const char *input, *output;
+    BatchOptions options = {"separable", 7, 2.0f, 0.0f, 42, IMAGE_FORMAT_UNKNOWN, NULL,
+                            1, server->threads_per_job, 0};
+    if (!parse_job(fields, &options, &input, &output, reply, reply_size)) return;
+    
+    ServerSlot *slot = acquire_slot(server);
+    double wait = now_ms() - start;
+    CachedKernel *kernels = slot_kernels(slot, options.kernel_size, options.sigma);
+    double stage_ms[3] = {0.0, 0.0, 0.0};
+    int width = 0, height = 0;
+    int ok = denoise_segments(slot, kernels, &options, input, output, stage_ms, &width, &height,
+                              reply, reply_size);
+    double service = now_ms() - start;
+    release_slot(server, slot, ok, service);
+    
+    if (ok) {
+        snprintf(reply, reply_size, "OK ms=%.2f wait=%.2f load=%.2f filter=%.2f save=%.2f size=%dx%d",
+                 service, wait, stage_ms[0], stage_ms[1], stage_ms[2], width, height);
+    }
+}
+
+// Arrêt: plus de nouvelle connexion, lecture fermée sur les connexions
+// ouvertes (les requêtes en cours se terminent et reçoivent leur réponse)
+static void request_stop(Server *server) {
+    pthread_mutex_lock(&server->lock);
+    if (!server->stopping) {
+        server->stopping = 1;
+        shutdown(server->listen_fd, SHUT_RDWR);
+        for (int i = 0; i < SERVER_MAX_CONNECTIONS; i++) {
+            if (server->connections[i] >= 0) shutdown(server->connections[i], SHUT_RD);
+        }
+    }
+    pthread_mutex_unlock(&server->lock);
+}
+
+static int send_line(int fd, const char *line) {
+    size_t len = strlen(line);
+    char buffer[SERVER_LINE_MAX + 2];
+    if (len > SERVER_LINE_MAX) len = SERVER_LINE_MAX;
+    memcpy(buffer, line, len);
+    buffer[len++] = '\n';
+    for (size_t sent = 0; sent < len;) {
+        ssize_t n = send(fd, buffer + sent, len - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        sent += (size_t)n;
+    }
+    return 1;
+}
+
+static void *serve_connection(void *arg) {
+    Connection *conn = (Connection *)arg;
+    Server *server = conn->server;
+    // Chaque requête de cette connexion utilise threads_per_job threads
+    omp_set_num_threads(server->threads_per_job);
+    mkl_set_num_threads_local(server->threads_per_job);
+    
+    FILE *in = fdopen(dup(conn->fd), "r");
+    char line[SERVER_LINE_MAX + 1];     // Requête d'au plus SERVER_LINE_MAX - 1 octets et '\n'
+    char reply[SERVER_LINE_MAX];
+    int quit = 0;
+    while (in && !quit && fgets(line, sizeof(line), in)) {
+        double start = now_ms();
+        // Ligne plus longue que le tampon: le reste est lu et ignoré jusqu'à
+        // la fin de ligne, la requête refusée en entier (jamais tronquée)
+        if (!strchr(line, '\n') && strlen(line) == sizeof(line) - 1) {
+            int ch;
+            while ((ch = fgetc(in)) != EOF && ch != '\n') {
+            }
+            if (!send_line(conn->fd, "ERR requête trop longue")) break;
+            continue;
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        char *save = NULL;
+        char *command = strtok_r(line, " ", &save);
+        if (!command) continue;
+        
+        if (strcmp(command, "DENOISE") == 0) {
+            handle_denoise(server, save, start, reply, sizeof(reply));
+        } else if (strcmp(command, "DENOISE_SHM") == 0) {
+            handle_denoise_shm(server, save, start, reply, sizeof(reply));
+        } else if (strcmp(command, "STATS") == 0) {
+            pthread_mutex_lock(&server->lock);
+            snprintf(reply, sizeof(reply), "OK jobs=%ld failed=%ld mean_ms=%.2f max_ms=%.2f",
+                     server->jobs, server->failed,
+                     server->jobs ? server->total_ms / server->jobs : 0.0, server->max_ms);
+            pthread_mutex_unlock(&server->lock);
+        } else if (strcmp(command, "PING") == 0) {
+            snprintf(reply, sizeof(reply), "OK");
+        } else if (strcmp(command, "QUIT") == 0) {
+            snprintf(reply, sizeof(reply), "OK");
+            quit = 1;
+        } else {
+            snprintf(reply, sizeof(reply), "ERR commande inconnue '%s'", command);
+        }
+        if (!send_line(conn->fd, reply)) break;
+    }
+    if (in) fclose(in);
+    if (quit) request_stop(server);
+    
+    pthread_mutex_lock(&server->lock);
+    server->connections[conn->index] = -1;
+    server->active--;
+    close(conn->fd);
+    pthread_cond_broadcast(&server->idle);
+    pthread_mutex_unlock(&server->lock);
+    mkl_set_num_threads_local(0);
+    free(conn);
+    return NULL;
+}
+
+// Socket d'écoute; une socket orpheline (aucun service ne répond) est
+// remplacée, un service actif n'est pas délogé. Les requêtes lisent et
+// écrivent des fichiers avec les droits du service: la socket est réservée
+// à son propriétaire (0600) avant listen, aucun autre utilisateur ne peut
+// s'y connecter, même dans un répertoire partagé comme /tmp
+static int open_listen_socket(const char *socket_path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Erreur: chemin de socket trop long '%s'\n", socket_path);
+        return -1;
+    }
+    strcpy(addr.sun_path, socket_path);
+    
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        close(probe);
+        fprintf(stderr, "Erreur: un service répond déjà sur '%s'\n", socket_path);
+        return -1;
+    }
+    if (probe >= 0) close(probe);
+    unlink(socket_path);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        chmod(socket_path, S_IRUSR | S_IWUSR) != 0 || listen(fd, SOMAXCONN) != 0) {
+        fprintf(stderr, "Erreur: impossible d'écouter sur '%s' (%s)\n", socket_path,
+                strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int run_server(const char *socket_path, int slots, int threads_per_job) {
+    Server server;
+    memset(&server, 0, sizeof(server));
+    server.num_slots = slots < 1 ? 1 : slots;
+    server.threads_per_job = threads_per_job < 1 ? 1 : threads_per_job;
+    server.slots = (ServerSlot *)calloc((size_t)server.num_slots, sizeof(ServerSlot));
+    for (int i = 0; i < SERVER_MAX_CONNECTIONS; i++) server.connections[i] = -1;
+    int ok = server.slots != NULL;
+    for (int i = 0; ok && i < server.num_slots; i++) {
+        server.slots[i].ws = create_conv_workspace();
+        ok = server.slots[i].ws != NULL;
+    }
+    server.listen_fd = ok ? open_listen_socket(socket_path) : -1;
+    if (server.listen_fd < 0) {
+        for (int i = 0; server.slots && i < server.num_slots; i++) {
+            free_conv_workspace(server.slots[i].ws);
+        }
+        free(server.slots);
+        return 0;
+    }
+    pthread_mutex_init(&server.lock, NULL);
+    pthread_cond_init(&server.slot_free, NULL);
+    pthread_cond_init(&server.idle, NULL);
+    
+    // Threads de calcul imbriqués dans les threads de connexion: MKL fixé
+    // par thread, sans ajustement dynamique
+    set_io_quiet(1);
+    mkl_set_dynamic(0);
+    
+    if (pipe(stop_pipe) != 0) stop_pipe[0] = stop_pipe[1] = -1;
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_stop_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    
+    printf("Service à l'écoute sur %s: %d emplacements x %d threads\n", socket_path,
+           server.num_slots, server.threads_per_job);
+    fflush(stdout);
+    
+    for (;;) {
+        struct pollfd events[2] = {{server.listen_fd, POLLIN, 0}, {stop_pipe[0], POLLIN, 0}};
+        if (poll(events, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (events[1].revents) break;   // Signal d'arrêt
+        int fd = accept(server.listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            break;      // Socket fermée par QUIT (request_stop)
+        }
+        
+        pthread_mutex_lock(&server.lock);
+        int index = -1;
+        for (int i = 0; i < SERVER_MAX_CONNECTIONS && index < 0 && !server.stopping; i++) {
+            if (server.connections[i] < 0) index = i;
+        }
+        Connection *conn = index >= 0 ? (Connection *)malloc(sizeof(Connection)) : NULL;
+        if (conn) {
+            server.connections[index] = fd;
+            server.active++;
+        }
+        pthread_mutex_unlock(&server.lock);
+        if (!conn) {
+            send_line(fd, "ERR service saturé");
+            close(fd);
+            continue;
+        }
+        conn->server = &server;
+        conn->fd = fd;
+        conn->index = index;
+        
+        pthread_t thread;
+        int created = pthread_create(&thread, NULL, serve_connection, conn) == 0;
+        if (created) {
+            pthread_detach(thread);
+        } else {
+            pthread_mutex_lock(&server.lock);
+            server.connections[index] = -1;
+            server.active--;
+            pthread_mutex_unlock(&server.lock);
+            send_line(fd, "ERR service saturé");
+            close(fd);
+            free(conn);
+        }
+    }
+    
+    // Fin des connexions ouvertes, requêtes en cours comprises
+    request_stop(&server);
+    pthread_mutex_lock(&server.lock);
+    while (server.active > 0) pthread_cond_wait(&server.idle, &server.lock);
+    pthread_mutex_unlock(&server.lock);
+    close(server.listen_fd);
+    unlink(socket_path);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    if (stop_pipe[0] >= 0) {
+        close(stop_pipe[0]);
+        close(stop_pipe[1]);
+        stop_pipe[0] = stop_pipe[1] = -1;
+    }
+    
+    printf("Service arrêté: %ld requêtes (%ld échecs), latence moyenne %.2f ms, max %.2f ms\n",
+           server.jobs, server.failed, server.jobs ? server.total_ms / server.jobs : 0.0,
+           server.max_ms);
+    
+    for (int i = 0; i < server.num_slots; i++) {
+        for (int k = 0; k < KERNEL_CACHE_SIZE; k++) {
+            if (server.slots[i].kernels[k].kernel_2d) free_kernel(server.slots[i].kernels[k].kernel_2d);
+            if (server.slots[i].kernels[k].kernel_1d) mkl_free(server.slots[i].kernels[k].kernel_1d);
+        }
+        free_image_float(server.slots[i].input);
+        free_image_float(server.slots[i].output);
+        free_conv_workspace(server.slots[i].ws);
+    }
+    free(server.slots);
+    pthread_mutex_destroy(&server.lock);
+    pthread_cond_destroy(&server.slot_free);
+    pthread_cond_destroy(&server.idle);
+    return 1;
+}
+
+int server_request(const char *socket_path, const char *request, char *reply,
+                   size_t reply_size) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) return 0;
+    strcpy(addr.sun_path, socket_path);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return 0;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || !send_line(fd, request)) {
+        close(fd);
+        return 0;
+    }
+    
+    // Réponse: une ligne terminée par '\n'
+    size_t len = 0;
+    int complete = 0;
+    while (!complete && len + 1 < reply_size) {
+        ssize_t n = recv(fd, reply + len, reply_size - 1 - len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        len += (size_t)n;
+        complete = memchr(reply, '\n', len) != NULL;
+    }
+    close(fd);
+    reply[len] = '\0';
+    reply[strcspn(reply, "\n")] = '\0';
+    return complete;
+}
+
+int server_denoise(const char *socket_path, const char *input_file, const char *output_file,
+                   const BatchOptions *options, char *reply, size_t reply_size) {
+    char input[PATH_MAX], output[PATH_MAX], cwd[PATH_MAX];
+    if (!realpath(input_file, input)) {
+        snprintf(reply, reply_size, "ERR fichier introuvable '%s'", input_file);
+        return 0;
+    }
+    // La sortie n'existe pas encore: relative au répertoire courant
+    if (output_file[0] == '/') {
+        snprintf(output, sizeof(output), "%s", output_file);
+    } else if (!getcwd(cwd, sizeof(cwd)) ||
+               snprintf(output, sizeof(output), "%s/%s", cwd, output_file) >= (int)sizeof(output)) {
+        snprintf(reply, reply_size, "ERR chemin de sortie inaccessible '%s'", output_file);
+        return 0;
+    }
+    
+    // Format transmis par son nom (ppm: toute la famille PNM), l'extension
+    // étant choisie par le service d'après l'image lue
+    char request[SERVER_LINE_MAX], format[32] = "";
+    if (options->format != IMAGE_FORMAT_UNKNOWN) {
+        snprintf(format, sizeof(format), " format=%s", image_format_extension(options->format, 3));
+    }
+    if (snprintf(request, sizeof(request), "DENOISE in=%s out=%s method=%s k=%d sigma=%.9g "
+                 "noise=%.9g seed=%u%s", input, output, options->method, options->kernel_size,
+                 options->sigma, options->noise_sigma, options->noise_seed,
+                 format) >= (int)sizeof(request)) {
+        snprintf(reply, reply_size, "ERR requête trop longue");
+        return 0;
+    }
+    if (!server_request(socket_path, request, reply, reply_size)) {
+        snprintf(reply, reply_size, "ERR service injoignable sur '%s'", socket_path);
+        return 0;
+    }
+    return strncmp(reply, "OK", 2) == 0;
+}
+
+// Segment d'entrée rempli depuis un fichier: plans u8 pour les images 8 bits
+// (alpha éventuel dans le dernier plan, comme load_image_color le met de
+// côté), float32 pour .pfm et .planar
+static ShmImage *fill_input_segment(const char *name, const char *input_file) {
+    if (is_float_image_file(input_file)) {
+        ImageFloat *img = load_image_float(input_file, NULL);
+        if (!img) return NULL;
+        ShmImage *seg = shm_image_create(name, img->width, img->height, img->channels,
+                                         SHM_SAMPLE_F32);
+        if (seg) {
+            memcpy(seg->data, img->data,
+                   (size_t)img->width * img->height * img->channels * sizeof(float));
+        }
+        free_image_float(img);
+        return seg;
+    }
+    
+    int w, h, c;
+    unsigned char *pixels = load_image_u8(input_file, &w, &h, &c);
+    if (!pixels) return NULL;
+    ShmImage *seg = shm_image_create(name, w, h, c, SHM_SAMPLE_U8);
+    if (seg) {
+        unsigned char *planes = (unsigned char *)seg->data;
+        size_t plane = (size_t)w * h;
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < plane; i++) {
+            for (int ch = 0; ch < c; ch++) planes[ch * plane + i] = pixels[i * c + ch];
+        }
+    }
+    free_image_u8(pixels);
+    return seg;
+}
+
+// Segment de sortie écrit dans le fichier: u8 tel quel, float32 sans normalisation
+static int save_output_segment(ShmImage *seg, const char *output_file) {
+    if (seg->sample == SHM_SAMPLE_F32) {
+        ImageFloat *img = shm_image_float_view(seg);
+        int ok = img && save_image_as(output_file, img, 0.0f, 255.0f, NULL);
+        free_image_float(img);
+        return ok;
+    }
+    
+    size_t plane = (size_t)seg->width * seg->height;
+    int c = seg->channels;
+    unsigned char *pixels = (unsigned char *)malloc(plane * c);
+    if (!pixels) return 0;
+    const unsigned char *planes = (const unsigned char *)seg->data;
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < plane; i++) {
+        for (int ch = 0; ch < c; ch++) pixels[i * c + ch] = planes[ch * plane + i];
+    }
+    int ok = save_image_u8_as(output_file, pixels, seg->width, seg->height, c);
+    free(pixels);
+    return ok;
+}
+
+int server_denoise_shm(const char *socket_path, const char *input_file,
+                       const char *output_file, const BatchOptions *options, char *reply,
+                       size_t reply_size) {
+    ImageFormat format = options->format != IMAGE_FORMAT_UNKNOWN
+                         ? options->format : image_format_from_filename(output_file);
+    if (format == IMAGE_FORMAT_UNKNOWN) {
+        snprintf(reply, reply_size, "ERR extension de sortie inconnue '%s'", output_file);
+        return 0;
+    }
+    char input_name[64], output_name[64];
+    snprintf(input_name, sizeof(input_name), "/image_denoise-%ld-in", (long)getpid());
+    snprintf(output_name, sizeof(output_name), "/image_denoise-%ld-out", (long)getpid());
+    
+    ShmImage *in = fill_input_segment(input_name, input_file);
+    ShmSample sample = format == IMAGE_FORMAT_PFM || format == IMAGE_FORMAT_PLANAR
+                       ? SHM_SAMPLE_F32 : SHM_SAMPLE_U8;
+    // Alpha rendu par le service dans un plan de plus, pour les seuls formats
+    // qui le conservent (PNG, QOI), comme save_image_as
+    int out_channels = in ? in->channels : 0;
+    if (in && in->sample == SHM_SAMPLE_U8 && (out_channels == 2 || out_channels == 4) &&
+        format != IMAGE_FORMAT_PNG && format != IMAGE_FORMAT_QOI) {
+        out_channels--;
+    }
+    ShmImage *out = in ? shm_image_create(output_name, in->width, in->height, out_channels,
+                                          sample) : NULL;
+    int ok = 0;
+    if (!in || !out) {
+        snprintf(reply, reply_size, "ERR impossible de préparer les segments de '%s'", input_file);
+    } else {
+        char request[SERVER_LINE_MAX];
+        snprintf(request, sizeof(request), "DENOISE_SHM in=%s out=%s method=%s k=%d sigma=%.9g "
+                 "noise=%.9g seed=%u", input_name, output_name, options->method,
+                 options->kernel_size, options->sigma, options->noise_sigma, options->noise_seed);
+        if (!server_request(socket_path, request, reply, reply_size)) {
+            snprintf(reply, reply_size, "ERR service injoignable sur '%s'", socket_path);
+        } else if (strncmp(reply, "OK", 2) == 0) {
+            // Même nom qu'un appel direct: extension selon les canaux lus
+            char filename[PATH_MAX];
+            snprintf(filename, sizeof(filename), "%s", output_file);
+            if (options->format != IMAGE_FORMAT_UNKNOWN) {
+                snprintf(filename, sizeof(filename), "%s.%s", output_file,
+                         image_format_extension(format, out->channels));
+            }
+            ok = save_output_segment(out, filename);
+        }
+    }
+    
+    if (in) {
+        shm_image_close(in);
+        shm_image_unlink(input_name);
+    }
+    if (out) {
+        shm_image_close(out);
+        shm_image_unlink(output_name);
+    }
+    return ok;
+}
@@ -0,0 +1,93 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stddef.h>
+#include "batch.h"
+
+/**
+ * Service de débruitage persistant sur socket Unix
+ * 
+ * Un processus longue durée garde MKL initialisé (threads déjà créés), et,
+ * pour chaque emplacement de calcul, les noyaux et l'espace de travail
+ * (plans FFT DFTI, spectre du noyau) d'une requête à l'autre.
+ * 
+ * Protocole texte, une requête par ligne, une réponse par ligne; une
+ * connexion peut enchaîner plusieurs requêtes:
+ *   DENOISE in=<chemin> out=<chemin> [method=separable] [k=7] [sigma=2.0]
+ *           [noise=0] [seed=42] [format=png|ppm|pfm|planar|qoi|jpg]
+ *     -> OK ms=<service> wait=<attente> load=<ms> filter=<ms> save=<ms> size=<w>x<h>
+ *        [out=<fichier écrit>]
+ *     -> ERR <message>
+ *     Sans format=, le format vient de l'extension de out; avec format=,
+ *     out est un nom sans extension que le service complète selon l'image
+ *     lue (ppm/pgm: .pgm pour une image grise) et renvoie dans out=
+ *   DENOISE_SHM in=<segment> out=<segment> [mêmes options]
+ *     -> même réponse; images en mémoire partagée (shm_image.h), sans
+ *        fichier ni encodage: out est créé par l'appelant aux dimensions de
+ *        in, en u8 (résultat quantifié [min, max] -> [0, 255]) ou en float32
+ *        (valeurs du filtre, comme .pfm/.planar). Un segment in u8 à 2 ou 4
+ *        canaux porte l'alpha dans son dernier plan: non débruité, recopié
+ *        si out (u8) a autant de canaux que in, ignoré si out n'a que les
+ *        couleurs
+ *   STATS  -> OK jobs=<n> failed=<n> mean_ms=<ms> max_ms=<ms>
+ *   PING   -> OK
+ *   QUIT   -> OK (arrêt du service après les requêtes en cours)
+ * Une ligne de plus de 8191 octets est lue jusqu'au bout puis refusée
+ * (ERR requête trop longue); la connexion reste utilisable.
+ * Les chemins sont ceux du service (absolus de préférence) et ne contiennent
+ * pas d'espace. Les
+ * latences sont mesurées dans le service, de la lecture de la requête à
+ * l'envoi de la réponse (wait: attente d'un emplacement de calcul libre).
+ * 
+ * Concurrence: un thread par connexion pour le protocole, mais au plus
+ * slots requêtes calculées simultanément, chacune avec threads_per_job
+ * threads OpenMP/MKL: slots x threads_per_job ne dépasse pas le nombre de
+ * cœurs demandé, quel que soit le nombre de clients (les autres attendent
+ * un emplacement libre).
+ */
+
+/**
+ * Lance le service et bloque jusqu'à QUIT, SIGINT ou SIGTERM
+ * @param socket_path: chemin de la socket (remplacée si elle est orpheline),
+ *                     accessible au seul utilisateur du service (0600)
+ * @param slots: requêtes calculées simultanément
+ * @param threads_per_job: threads OpenMP/MKL de chaque requête
+ * @return: 1 si le service s'est arrêté normalement, 0 en cas d'erreur
+ */
+int run_server(const char *socket_path, int slots, int threads_per_job);
+
+/**
+ * Envoie une requête (une ligne, sans '\n') et attend la réponse
+ * @param reply: [sortie] réponse, sans '\n'
+ * @return: 1 si une réponse a été reçue, 0 sinon (service injoignable)
+ */
+int server_request(const char *socket_path, const char *request, char *reply,
+                   size_t reply_size);
+
+/**
+ * Envoie une requête DENOISE construite à partir des options de la ligne de
+ * commande; les chemins relatifs sont rendus absolus (répertoire courant du
+ * client), le service pouvant tourner ailleurs
+ * @param output_file: fichier de sortie; si options->format est connu, nom
+ *                     sans extension, complété par le service (out= de la
+ *                     réponse)
+ * @param options: méthode, noyau, bruit, graine et format (autres champs ignorés)
+ * @return: 1 si le service a répondu OK, 0 sinon (réponse ERR dans reply)
+ */
+int server_denoise(const char *socket_path, const char *input_file, const char *output_file,
+                   const BatchOptions *options, char *reply, size_t reply_size);
+
+/**
+ * Comme server_denoise, par segments partagés (DENOISE_SHM): l'image est
+ * placée dans un segment d'entrée, le résultat lu dans un segment de sortie
+ * (float32 en .pfm/.planar, u8 sinon) puis écrit dans output_file, complété
+ * comme pour server_denoise si options->format est connu; segments
+ * supprimés au retour. L'alpha de l'entrée est conservé en PNG et QOI,
+ * comme par un appel direct
+ * @return: 1 si le service a répondu OK et le résultat a été écrit, 0 sinon
+ */
+int server_denoise_shm(const char *socket_path, const char *input_file,
+                       const char *output_file, const BatchOptions *options, char *reply,
+                       size_t reply_size);
+
+#endif // SERVER_H
@@ -0,0 +1,180 @@
+// shm_open, mmap, ftruncate ne sont pas exposés en C11 strict
+#define _GNU_SOURCE
+
+#include "shm_image.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Même disposition que le format planaire de float_io.c: en-tête d'une
+// ligne de cache, plans alignés derrière
+#define SHM_HEADER_SIZE 64
+static const char SHM_MAGIC[8] = {'D', 'S', 'H', 'M', 'I', 'M', 'G', '1'};
+
+static ShmImage *shm_image_wrap(void *base, size_t bytes) {
+    ShmImage *seg = (ShmImage *)malloc(sizeof(ShmImage));
+    if (!seg) return NULL;
+    
+    uint32_t fields[5];
+    memcpy(fields, (unsigned char *)base + sizeof(SHM_MAGIC), sizeof(fields));
+    seg->base = base;
+    seg->bytes = bytes;
+    seg->width = (int)fields[0];
+    seg->height = (int)fields[1];
+    seg->channels = (int)fields[2];
+    seg->sample = (ShmSample)fields[3];
+    seg->data = (unsigned char *)base + fields[4];
+    return seg;
+}
+
+ShmImage *shm_image_create(const char *name, int width, int height, int channels,
+                           ShmSample sample) {
+    if (width < 1 || height < 1 || channels < 1 || channels > 4 ||
+        (sample != SHM_SAMPLE_U8 && sample != SHM_SAMPLE_F32)) {
+        fprintf(stderr, "Erreur: géométrie de segment invalide (%dx%dx%d)\n", width, height,
+                channels);
+        return NULL;
+    }
+    size_t data_bytes = 0;
+    if (!image_plane_bytes((uint64_t)width, (uint64_t)height, (uint64_t)channels, (size_t)sample,
+                           &data_bytes) ||
+        data_bytes > SIZE_MAX - SHM_HEADER_SIZE) {
+        fprintf(stderr, "Erreur: segment trop grand (%dx%dx%d)\n", width, height, channels);
+        return NULL;
+    }
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        fprintf(stderr, "Erreur: impossible de créer le segment '%s'\n", name);
+        return NULL;
+    }
+    
+    size_t bytes = SHM_HEADER_SIZE + data_bytes;
+    void *base = MAP_FAILED;
+    if (ftruncate(fd, (off_t)bytes) == 0) {
+        base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Erreur: impossible de projeter le segment '%s'\n", name);
+        shm_unlink(name);
+        return NULL;
+    }
+    
+    uint32_t fields[5] = {(uint32_t)width, (uint32_t)height, (uint32_t)channels,
+                          (uint32_t)sample, SHM_HEADER_SIZE};
+    memset(base, 0, SHM_HEADER_SIZE);
+    memcpy(base, SHM_MAGIC, sizeof(SHM_MAGIC));
+    memcpy((unsigned char *)base + sizeof(SHM_MAGIC), fields, sizeof(fields));
+    
+    ShmImage *seg = shm_image_wrap(base, bytes);
+    if (!seg) {
+        munmap(base, bytes);
+        shm_unlink(name);
+    }
+    return seg;
+}
+
+ShmImage *shm_image_open(const char *name, int shared) {
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Erreur: segment introuvable '%s'\n", name);
+        return NULL;
+    }
+    
+    struct stat st;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= SHM_HEADER_SIZE) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+                    shared ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Erreur: impossible de projeter le segment '%s'\n", name);
+        return NULL;
+    }
+    
+    // En-tête écrit par un autre processus: tout est vérifié avant usage, la
+    // taille des plans bornée avant d'être calculée (comme float_io.c)
+    size_t bytes = (size_t)st.st_size;
+    uint32_t fields[5];
+    memcpy(fields, (unsigned char *)base + sizeof(SHM_MAGIC), sizeof(fields));
+    size_t data_bytes = 0;
+    if (memcmp(base, SHM_MAGIC, sizeof(SHM_MAGIC)) != 0 || fields[2] > 4 ||
+        (fields[3] != SHM_SAMPLE_U8 && fields[3] != SHM_SAMPLE_F32) ||
+        !image_plane_bytes(fields[0], fields[1], fields[2], fields[3], &data_bytes) ||
+        fields[4] < SHM_HEADER_SIZE || fields[4] % 64 != 0 || fields[4] > bytes ||
+        bytes - fields[4] < data_bytes) {
+        fprintf(stderr, "Erreur: en-tête invalide ou segment tronqué '%s'\n", name);
+        munmap(base, bytes);
+        return NULL;
+    }
+    
+    ShmImage *seg = shm_image_wrap(base, bytes);
+    if (!seg) munmap(base, bytes);
+    return seg;
+}
+
+// La projection appartient au segment: rien à rendre à la libération de l'image
+static void keep_mapping(void *base, size_t bytes) {
+    (void)base;
+    (void)bytes;
+}
+
+ImageFloat *shm_image_float_view(ShmImage *seg) {
+    if (!seg || seg->sample != SHM_SAMPLE_F32) return NULL;
+    return image_wrap_external((float *)seg->data, seg->width, seg->height, seg->channels,
+                               seg->base, seg->bytes, keep_mapping);
+}
+
+int shm_image_read_u8(const ShmImage *seg, ImageFloat *dst) {
+    if (!seg || !dst || seg->sample != SHM_SAMPLE_U8 || dst->width != seg->width ||
+        dst->height != seg->height || dst->channels > seg->channels) {
+        return 0;
+    }
+    if (!image_make_writable(dst)) return 0;
+    
+    // Un plan u8 est une image entrelacée à un canal: conversion SIMD par ligne
+    const unsigned char *src = (const unsigned char *)seg->data;
+    int w = seg->width;
+    int rows = seg->height * dst->channels;
+    #pragma omp parallel for schedule(static)
+    for (int r = 0; r < rows; r++) {
+        float *row = dst->data + (size_t)r * w;
+        deinterleave_row(src + (size_t)r * w, w, 1, &row);
+    }
+    return 1;
+}
+
+int shm_image_write_u8(ShmImage *seg, const ImageFloat *src, float min_val, float max_val) {
+    if (!seg || !src || seg->sample != SHM_SAMPLE_U8 || src->width != seg->width ||
+        src->height != seg->height || src->channels > seg->channels) {
+        return 0;
+    }
+    
+    float scale, offset;
+    normalize_coefficients(min_val, max_val, &scale, &offset);
+    size_t plane = (size_t)src->width * src->height;
+    unsigned char *dst = (unsigned char *)seg->data;
+    for (int ch = 0; ch < src->channels; ch++) {
+        // Plan vu comme une image à un canal: quantification sans entrelacement
+        ImageFloat view = {src->data + ch * plane, src->width, src->height, 1, NULL};
+        quantize_interleave_rows(&view, scale, offset, 0, src->height, dst + ch * plane,
+                                 (size_t)src->width);
+    }
+    return 1;
+}
+
+void shm_image_close(ShmImage *seg) {
+    if (!seg) return;
+    munmap(seg->base, seg->bytes);
+    free(seg);
+}
+
+int shm_image_unlink(const char *name) {
+    return shm_unlink(name) == 0;
+}
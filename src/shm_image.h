@@ -0,0 +1,91 @@
+#ifndef SHM_IMAGE_H
+#define SHM_IMAGE_H
+
+#include "image.h"
+
+/**
+ * Images en mémoire partagée POSIX (shm_open), pour les appelants situés
+ * sur la même machine que le service (server.h, requête DENOISE_SHM)
+ * 
+ * Un segment contient un en-tête de 64 octets puis les plans de l'image,
+ * dans l'ordre de ImageFloat (tous les pixels du canal 0, puis du canal 1...):
+ *   octets 0-7   "DSHMIMG1"
+ *   octets 8-27  largeur, hauteur, canaux, octets par échantillon (1: u8,
+ *                4: float32), début des données (uint32, boutisme de la machine)
+ *   octets 28-63 réservés (zéros)
+ * Les plans commencent sur une ligne de cache: un segment float32 est
+ * enveloppé tel quel par les moteurs (image_wrap_external), sans copie ni
+ * conversion; un segment u8 est converti en flottant à la lecture et
+ * quantifié directement dans les plans à l'écriture.
+ * Un segment u8 à 2 ou 4 canaux porte l'alpha dans son dernier plan, comme
+ * les images 8 bits (io.h, load_image_color): il n'est pas débruité.
+ */
+
+typedef enum {
+    SHM_SAMPLE_U8 = 1,          // Échantillons 0-255
+    SHM_SAMPLE_F32 = 4          // Valeurs du pipeline, sans normalisation
+} ShmSample;
+
+typedef struct {
+    void *base;                 // Projection du segment, en-tête compris
+    size_t bytes;
+    int width;
+    int height;
+    int channels;
+    ShmSample sample;
+    void *data;                 // Premier plan
+} ShmImage;
+
+/**
+ * Crée (ou remplace) un segment et sa projection partagée, en-tête écrit
+ * @param name: nom POSIX ("/nom", sans autre '/')
+ * @return: segment à remplir dans data, ou NULL en cas d'erreur
+ */
+ShmImage *shm_image_create(const char *name, int width, int height, int channels,
+                           ShmSample sample);
+
+/**
+ * Projette un segment existant et vérifie son en-tête
+ * @param shared: 1: écritures visibles des autres processus (segment de
+ *                sortie); 0: projection privée, les écritures restent dans
+ *                ce processus (copie sur écriture des seules pages modifiées)
+ * @return: segment, ou NULL en cas d'erreur
+ */
+ShmImage *shm_image_open(const char *name, int shared);
+
+/**
+ * Enveloppe les plans float32 d'un segment dans une image, sans copie
+ * L'image doit être libérée avant shm_image_close
+ * @return: image, ou NULL si le segment n'est pas en float32
+ */
+ImageFloat *shm_image_float_view(ShmImage *seg);
+
+/**
+ * Convertit les plans u8 d'un segment en flottants (0-255)
+ * @param dst: image de mêmes largeur et hauteur que le segment; ses
+ *             dst->channels premiers plans sont lus (couleurs sans l'alpha)
+ * @return: 1 si succès, 0 sinon
+ */
+int shm_image_read_u8(const ShmImage *seg, ImageFloat *dst);
+
+/**
+ * Quantifie une image dans les plans u8 d'un segment:
+ * [min_val, max_val] -> [0, 255], comme les sauvegardes 8 bits (io.h)
+ * @param src: image de mêmes largeur et hauteur que le segment, écrite
+ *             dans ses src->channels premiers plans (l'alpha est laissé)
+ * @return: 1 si succès, 0 sinon
+ */
+int shm_image_write_u8(ShmImage *seg, const ImageFloat *src, float min_val, float max_val);
+
+/**
+ * Supprime la projection (le segment reste nommé jusqu'à shm_image_unlink)
+ */
+void shm_image_close(ShmImage *seg);
+
+/**
+ * Supprime le nom du segment
+ * @return: 1 si succès, 0 sinon
+ */
+int shm_image_unlink(const char *name);
+
+#endif // SHM_IMAGE_H
@@ -0,0 +1,168 @@
+#include "strip.h"
+#include "png_stream.h"
+#include "image.h"
+#include "pool.h"
+#include <omp.h>
+#include <stdio.h>
+#include <string.h>
+
+static inline int clamp_index(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Passe horizontale d'une ligne, mêmes sommes et même ordre que
+// convolve_plane_1d (bords bornés à la ligne, puis intérieur coefficient
+// par coefficient)
+static void filter_row_horizontal(const float *src_row, int width, const float *kernel_1d,
+                                  int kernel_size, float *dst_row) {
+    int half_size = kernel_size / 2;
+    int inner_end = width - half_size;
+    
+    for (int x = 0; x < width; x++) {
+        if (x == half_size && half_size < inner_end) x = inner_end;
+        float sum = 0.0f;
+        for (int k = 0; k < kernel_size; k++) {
+            sum += src_row[clamp_index(x + k - half_size, 0, width - 1)] * kernel_1d[k];
+        }
+        dst_row[x] = sum;
+    }
+    
+    for (int x = half_size; x < inner_end; x++) dst_row[x] = 0.0f;
+    for (int k = 0; k < kernel_size; k++) {
+        const float *shifted = src_row + k - half_size;
+        float weight = kernel_1d[k];
+        #pragma omp simd
+        for (int x = half_size; x < inner_end; x++) {
+            dst_row[x] += shifted[x] * weight;
+        }
+    }
+}
+
+int denoise_png_strips(const char *input_file, const char *output_file,
+                       const float *kernel_1d, int kernel_size, int strip_rows, int level,
+                       StripStats *stats) {
+    int width, height, channels;
+    PngReader *reader = png_reader_open(input_file, &width, &height, &channels);
+    if (!reader) return 0;
+    
+    // Canal alpha éventuel: recopié, seuls les canaux de couleur sont filtrés
+    int has_alpha = channels == 2 || channels == 4;
+    int color = has_alpha ? channels - 1 : channels;
+    int half_size = kernel_size / 2;
+    if (strip_rows < 1) strip_rows = 1;
+    if (strip_rows > height) strip_rows = height;
+    
+    // Anneau: la bande en cours et son halo, lignes filtrées horizontalement
+    // (plan par canal, ring_rows lignes chacun); ligne y au rang y % ring_rows
+    int ring_rows = strip_rows + 2 * half_size;
+    // Lignes décodées par bande: strip_rows, plus le halo inférieur à la première
+    int max_new = strip_rows + half_size < height ? strip_rows + half_size : height;
+    size_t row_bytes = (size_t)width * channels;
+    int num_threads = omp_get_max_threads();
+    
+    float *ring = (float *)pool_alloc((size_t)ring_rows * width * color * sizeof(float));
+    ImageFloat *alpha_ring = has_alpha ? create_image_float_uninit(width, ring_rows, 1) : NULL;
+    unsigned char *raw = (unsigned char *)pool_alloc((size_t)max_new * row_bytes);
+    float *scratch = (float *)pool_alloc((size_t)num_threads * width * color * sizeof(float));
+    ImageFloat *strip = create_image_float_uninit(width, strip_rows, color);
+    ImageFloat *strip_alpha = has_alpha ? create_image_float_uninit(width, strip_rows, 1) : NULL;
+    unsigned char *out = (unsigned char *)pool_alloc((size_t)strip_rows * row_bytes);
+    PngWriter *writer = png_writer_open(output_file, width, height, channels, level);
+    
+    int ok = ring && raw && scratch && strip && out && writer &&
+             (!has_alpha || (alpha_ring && strip_alpha));
+    
+    if (stats) {
+        stats->width = width;
+        stats->height = height;
+        stats->channels = channels;
+        stats->work_bytes = ((size_t)ring_rows * width * (color + has_alpha) +
+                             (size_t)num_threads * width * color +
+                             (size_t)strip_rows * width * (color + has_alpha)) * sizeof(float) +
+                            ((size_t)max_new + strip_rows) * row_bytes;
+    }
+    
+    size_t ring_plane = (size_t)ring_rows * width;
+    size_t strip_plane = (size_t)strip_rows * width;
+    int decoded = 0;
+    
+    for (int s = 0; ok && s < height; s += strip_rows) {
+        int n = height - s < strip_rows ? height - s : strip_rows;
+        int target = s + n + half_size < height ? s + n + half_size : height;
+        int first = decoded, count = target - decoded;
+        
+        // Décodage (séquentiel) des lignes manquantes: bande + halo inférieur
+        for (int i = 0; ok && i < count; i++) {
+            ok = png_reader_read_row(reader, raw + (size_t)i * row_bytes);
+        }
+        if (!ok) {
+            fprintf(stderr, "Erreur: données PNG corrompues dans '%s'\n", input_file);
+            break;
+        }
+        decoded = target;
+        
+        // Désentrelacement puis passe horizontale, une ligne par itération
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < count; i++) {
+            size_t slot = (size_t)((first + i) % ring_rows);
+            float *rows = scratch + (size_t)omp_get_thread_num() * width * color;
+            float *dst[4];
+            for (int ch = 0; ch < color; ch++) dst[ch] = rows + (size_t)ch * width;
+            if (has_alpha) dst[color] = alpha_ring->data + slot * width;
+            deinterleave_row(raw + (size_t)i * row_bytes, width, channels, dst);
+            
+            for (int ch = 0; ch < color; ch++) {
+                filter_row_horizontal(dst[ch], width, kernel_1d, kernel_size,
+                                      ring + ch * ring_plane + slot * width);
+            }
+        }
+        
+        // Passe verticale: lignes voisines bornées à l'image, lues dans l'anneau
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            int y = s + i;
+            for (int ch = 0; ch < color; ch++) {
+                float *dst_row = strip->data + ch * strip_plane + (size_t)i * width;
+                for (int x = 0; x < width; x++) dst_row[x] = 0.0f;
+                for (int k = 0; k < kernel_size; k++) {
+                    int src_y = clamp_index(y + k - half_size, 0, height - 1);
+                    const float *src_row = ring + ch * ring_plane +
+                                           (size_t)(src_y % ring_rows) * width;
+                    float weight = kernel_1d[k];
+                    #pragma omp simd
+                    for (int x = 0; x < width; x++) {
+                        dst_row[x] += src_row[x] * weight;
+                    }
+                }
+            }
+            if (has_alpha) {
+                memcpy(strip_alpha->data + (size_t)i * width,
+                       alpha_ring->data + (size_t)(y % ring_rows) * width,
+                       (size_t)width * sizeof(float));
+            }
+        }
+        
+        // Arrondi + entrelacement de la bande, puis encodage ligne à ligne
+        if (has_alpha) {
+            quantize_interleave_rows_alpha(strip, 1.0f, 0.0f, strip_alpha, 0, n, out, row_bytes);
+        } else {
+            quantize_interleave_rows(strip, 1.0f, 0.0f, 0, n, out, row_bytes);
+        }
+        for (int i = 0; ok && i < n; i++) {
+            ok = png_writer_write_row(writer, out + (size_t)i * row_bytes);
+        }
+    }
+    
+    png_reader_close(reader);
+    if (writer && !png_writer_close(writer)) ok = 0;
+    if (!ok) fprintf(stderr, "Erreur: échec du débruitage par bandes de '%s'\n", input_file);
+    
+    pool_free(ring);
+    pool_free(raw);
+    pool_free(scratch);
+    pool_free(out);
+    free_image_float(alpha_ring);
+    free_image_float(strip);
+    free_image_float(strip_alpha);
+    return ok;
+}
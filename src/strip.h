@@ -0,0 +1,42 @@
+#ifndef STRIP_H
+#define STRIP_H
+
+#include <stddef.h>
+
+/**
+ * Débruitage en flux par bandes de lignes
+ * 
+ * Les lignes passent du décodeur PNG ligne à ligne (png_stream) à la
+ * convolution séparable puis à l'encodeur PNG ligne à ligne, sans que
+ * l'image entière ne soit jamais en mémoire:
+ * - chaque ligne décodée est filtrée horizontalement et rangée dans un
+ *   anneau de strip_rows + 2 * (kernel_size / 2) lignes (bande + halo);
+ * - la passe verticale produit strip_rows lignes de sortie à la fois,
+ *   quantifiées et entrelacées puis encodées.
+ * La mémoire est en O(largeur x strip_rows), quelle que soit la hauteur.
+ * 
+ * Les calculs sont ceux de convolve_separable (mêmes sommes, dans le même
+ * ordre, bords répliqués): le résultat est identique à la convolution de
+ * l'image entière arrondie à l'entier le plus proche, sans normalisation
+ * min/max (une convolution gaussienne reste dans [0, 255]).
+ * Le canal alpha éventuel (2 ou 4 canaux) est recopié sans être filtré.
+ */
+
+typedef struct {
+    int width, height, channels;
+    size_t work_bytes;      // Tampons de travail (anneau, bandes, lignes)
+} StripStats;
+
+/**
+ * Débruite un PNG en flux vers un autre PNG
+ * @param input_file, output_file: PNG 8 bits non entrelacés (voir png_stream.h)
+ * @param strip_rows: lignes produites par bande (parallélisme entre threads)
+ * @param level: niveau de compression zlib de la sortie (-1 = défaut)
+ * @param stats: [sortie] dimensions et mémoire de travail (peut être NULL)
+ * @return: 1 si succès, 0 sinon
+ */
+int denoise_png_strips(const char *input_file, const char *output_file,
+                       const float *kernel_1d, int kernel_size, int strip_rows, int level,
+                       StripStats *stats);
+
+#endif // STRIP_H